@@ -15,5 +15,14 @@ HEADERS += \
     $$PWD/io/fstreamqueue.h \
     $$PWD/io/rawistreamreader.h \
     $$PWD/io/rawostreamwriter.h \
+    $$PWD/io/blockistreamreader.h \
+    $$PWD/io/blockostreamwriter.h \
+    $$PWD/io/blockcodecs.h \
+    $$PWD/io/compressedfstreamqueue.h \
     $$PWD/externalsort.h \
-    $$PWD/stdsorter.h
+    $$PWD/stdsorter.h \
+    $$PWD/losertree.h \
+    $$PWD/sortstatistics.h \
+    $$PWD/topkthreshold.h \
+    $$PWD/duplicatereducers.h \
+    $$PWD/presortedness.h
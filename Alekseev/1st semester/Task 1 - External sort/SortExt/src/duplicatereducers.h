@@ -0,0 +1,31 @@
+#ifndef DUPLICATEREDUCERS_H
+#define DUPLICATEREDUCERS_H
+
+// Reducers for ExternalSorter::sortUnique. A reducer is called as reduce(accumulated, next)
+// for every element equal (by Comparator) to the accumulated one and folds next into it.
+// accumulated always came first, so the reducer should be associative, but not necessarily commutative.
+
+// equal elements are not collapsed
+struct NoReducer
+{
+    template<typename DataT> void operator()(DataT &, const DataT &) const {}
+};
+
+// keeps the first of equal elements, like sort -u
+struct KeepFirst
+{
+    template<typename DataT> void operator()(DataT &, const DataT &) const {}
+};
+
+// sums counters of equal elements kept in the Count member,
+// every input element should come with its own multiplicity (1 for a single record)
+template<typename DataT, typename CountT, CountT DataT::*Count>
+struct CountDuplicates
+{
+    void operator()(DataT &accumulated, const DataT &next) const
+    {
+        accumulated.*Count += next.*Count;
+    }
+};
+
+#endif // DUPLICATEREDUCERS_H
@@ -1,37 +1,121 @@
 #ifndef EXTERNALSORT_H
 #define EXTERNALSORT_H
 
-#include <queue>
+#include <limits>
 #include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include <functional>
 
 #include "io/istreamreader.h"
 #include "io/ostreamwriter.h"
 #include "io/fstreamqueue.h"
+#include "io/compressedfstreamqueue.h"
 #include "io/optimalstreamio.h"
 #include "stdsorter.h"
+#include "losertree.h"
+#include "sortstatistics.h"
+#include "topkthreshold.h"
+#include "duplicatereducers.h"
+#include "presortedness.h"
 
 template<typename DataT,      // type of the data to be sorted
          class Comparator   = std::less<DataT>,       // should have a bool operator()(DataT&) method
          class LocalSorter  = StdSorter<Comparator>,  // should have an operator()(Iterator begin, Iterator end) method
          class TempQueue    = FStreamQueue<DataT,
                                            typename OptimalStreamIO<DataT>::ReaderType,
-                                           typename OptimalStreamIO<DataT>::WriterType>
+                                           typename OptimalStreamIO<DataT>::WriterType>,
                                                       // should have push(DataT) and bool pop(Data&) methods.
                                                       // may be one-go, i.e. it's guaranteed that push
                                                       // operation will not be called after pop operation
+                                                      // may have finishPushing() method, which is called
+                                                      // when the next bucket is started, and
+                                                      // memorySize() method, which tells how much
+                                                      // memory a bucket keeps while it is merged
+         class Statistics   = NoSortStatistics        // NoSortStatistics records nothing and costs nothing,
+                                                      // SortStatistics collects counters and times of phases
          >
 class ExternalSorter
 {
 public:
+    enum RunFormation
+    {
+        SortedChunks,         // every bucket is one buffer sorted by LocalSorter
+        ReplacementSelection  // buckets are formed by a heap over the buffer, about twice longer
+                              // than the buffer on random data, one bucket on sorted data
+    };
+
+    explicit ExternalSorter(RunFormation runFormation = SortedChunks):
+        runFormation(runFormation)
+    {}
+
+    // statistics of all sorts done so far
+    Statistics &getStatistics()
+    {
+        return statistics;
+    }
+
     template<class InputReader,   // should have a bool operator()(DataT&) method
              class OutputWriter>  // should have an operator()(DataT) method
     bool sort(InputReader &inputReader, OutputWriter &outputWriter, std::size_t bufferSize)
     {
         std::vector< std::unique_ptr<TempQueue> > buckets;
-        return prepareBuckets(inputReader, buckets, bufferSize) && mergeBuckets(outputWriter, buckets);
+        bool prepared = runFormation == ReplacementSelection
+                ? prepareReplacementSelectionBuckets(inputReader, buckets, bufferSize)
+                : prepareBuckets(inputReader, buckets, bufferSize);
+        return prepared && mergeBuckets(outputWriter, buckets);
+    }
+
+    // writes only the k smallest elements in order.
+    // If k <= bufferSize they are selected by a bounded heap and nothing is spilled, otherwise
+    // only the first k elements of every sorted buffer go to buckets, elements greater than
+    // a running threshold (see TopKThreshold) are dropped while reading and the merge stops after k outputs
+    template<class InputReader,
+             class OutputWriter>
+    bool sortTop(InputReader &inputReader, OutputWriter &outputWriter, std::size_t bufferSize, std::size_t k)
+    {
+        if (!bufferSize)
+            return false;
+        if (k <= bufferSize)
+            return selectTop(inputReader, outputWriter, k);
+        std::vector< std::unique_ptr<TempQueue> > buckets;
+        return preparePrunedBuckets(inputReader, buckets, bufferSize, k) && mergeBuckets(outputWriter, buckets, k);
+    }
+
+    // sorts only elements from [low, high), others are dropped while reading
+    template<class InputReader,
+             class OutputWriter>
+    bool sortRange(InputReader &inputReader, OutputWriter &outputWriter, std::size_t bufferSize,
+                   const DataT &low, const DataT &high)
+    {
+        RangeReader<InputReader> rangeReader(inputReader, low, high);
+        return sort(rangeReader, outputWriter, bufferSize);
+    }
+
+    // collapses elements equal by Comparator into one with reduce(accumulated, next):
+    // KeepFirst keeps the first one, CountDuplicates sums their counters.
+    // Every sorted buffer is collapsed before it is spilled and the freed space is filled with new
+    // elements while collapsing frees at least 1 / refillFraction of it, so one bucket may take
+    // many buffers of input. The merge collapses equal elements of different buckets.
+    // Within a bucket accumulated is the first element in input order if LocalSorter is stable
+    template<class InputReader,
+             class OutputWriter,
+             class Reducer = KeepFirst>
+    bool sortUnique(InputReader &inputReader, OutputWriter &outputWriter, std::size_t bufferSize,
+                    Reducer reduce = Reducer())
+    {
+        std::vector< std::unique_ptr<TempQueue> > buckets;
+        return prepareReducedBuckets(inputReader, buckets, bufferSize, reduce)
+                && mergeBuckets(outputWriter, buckets, std::numeric_limits<std::size_t>::max(), reduce);
     }
 
+    // sortUnique keeps filling a buffer while collapsing frees at least this part of it
+    static const std::size_t refillFraction = 8;
+
+    // a buffer made of at most this number of ascending runs is merged instead of sorted
+    static const std::size_t naturalMergeRuns = 8;
+
     void sort(const char *inputFile, const char *outputFile, std::size_t bufferSize)
     {
         std::ifstream inputStream(inputFile);
@@ -49,86 +133,423 @@ public:
     }
 
 private:
-    bool dumpBuffer(TempQueue *dest, DataT *buffer, std::size_t n)
+    typedef typename Statistics::template Compare<Comparator>::Type MergeComparator;
+
+    template<class InputReader>
+    class RangeReader
     {
-        localSort(buffer, buffer + n);
+    public:
+        RangeReader(InputReader &read, const DataT &low, const DataT &high):
+            read(read), low(low), high(high)
+        {}
+        bool operator() (DataT &data)
+        {
+            while (read(data))
+                if (!compare(data, low) && compare(data, high))
+                    return true;
+            return false;
+        }
+
+    private:
+        InputReader &read;
+        DataT low, high;
+        Comparator compare;
+    };
+
+    // sorted, reversed or made of a few ascending runs buffer is put in order without LocalSorter
+    void sortBuffer(DataT *buffer, std::size_t n)
+    {
+        typename Statistics::Timer timer(statistics, Statistics::Sorting);
+        if (orderPresorted(buffer, buffer + n, compare, naturalMergeRuns) == BufferOrder::Unordered)
+            localSort(buffer, buffer + n);
         assert(std::is_sorted(buffer, buffer + n, compare));
+    }
+
+    // sorts the buffer and pushes its first limit elements to the bucket
+    bool dumpBuffer(TempQueue *dest, DataT *buffer, std::size_t n,
+                    std::size_t limit = std::numeric_limits<std::size_t>::max())
+    {
+        sortBuffer(buffer, n);
+        n = std::min(n, limit);
+        statistics.bucket(n);
+        return spillBuffer(dest, buffer, n);
+    }
+
+    bool spillBuffer(TempQueue *dest, const DataT *buffer, std::size_t n)
+    {
+        typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
         for (std::size_t i = 0; i < n; ++i)
+        {
             dest->push(buffer[i]);
+            statistics.written(Statistics::SpillWriting, buffer[i]);
+        }
+        return true;
+    }
+
+    // the last bucket is not pushed to any more: lets it free memory kept for pushing
+    // if it can (see CompressedFStreamQueue::finishPushing)
+    void startBucket(std::vector<std::unique_ptr<TempQueue>> &buckets)
+    {
+        if (!buckets.empty())
+            finishPushing(*buckets.back(), 0);
+        buckets.emplace_back(new TempQueue);
+    }
+
+    template<class Queue>
+    static auto finishPushing(Queue &queue, int) -> decltype(queue.finishPushing(), void())
+    {
+        queue.finishPushing();
+    }
+
+    template<class Queue>
+    static void finishPushing(Queue &, long)
+    {
+    }
+
+    template<class Queue>
+    static auto queueMemory(const Queue &queue, int) -> decltype(std::size_t(queue.memorySize()))
+    {
+        return queue.memorySize();
+    }
+
+    template<class Queue>
+    static std::size_t queueMemory(const Queue &, long)
+    {
+        return 0;
+    }
+
+    template<class InputReader>
+    bool readElement(InputReader &read, DataT &data)
+    {
+        typename Statistics::Timer timer(statistics, Statistics::Reading);
+        if (!read(data))
+            return false;
+        statistics.read(Statistics::Reading, data);
         return true;
     }
 
     template<class InputReader>
     bool prepareBuckets(InputReader &read, std::vector<std::unique_ptr<TempQueue>> &buckets, std::size_t bufferSize)
     {
-        std::unique_ptr<DataT> buffer(new DataT[bufferSize]);
+        std::unique_ptr<DataT[]> buffer(new DataT[bufferSize]);
+        if (!buffer.get())
+            return false;
+        statistics.buffer(bufferSize * sizeof(DataT));
+
+        // a sorted buffer which starts not less than the last bucket ends continues that bucket
+        std::size_t currentLoad = 0, bucketSize = 0;
+        DataT last = DataT();
+        bool more = true;
+        while (more)
+        {
+            more = readElement(read, buffer[currentLoad]);
+            if (more)
+                ++currentLoad;
+            if (currentLoad < bufferSize && (more || !currentLoad))
+                continue;
+
+            sortBuffer(buffer.get(), currentLoad);
+            if (buckets.empty() || compare(buffer[0], last))
+            {
+                if (!buckets.empty())
+                    statistics.bucket(bucketSize);
+                startBucket(buckets);
+                bucketSize = 0;
+            }
+            last = buffer[currentLoad - 1];
+            if (!spillBuffer(buckets.back().get(), buffer.get(), currentLoad))
+                return false;
+            bucketSize += currentLoad;
+            currentLoad = 0;
+        }
+        if (!buckets.empty())
+            statistics.bucket(bucketSize);
+
+        return true;
+    }
+
+    // bounded max-heap of the k smallest elements seen so far
+    template<class InputReader, class OutputWriter>
+    bool selectTop(InputReader &read, OutputWriter &write, std::size_t k)
+    {
+        std::vector<DataT> heap;
+        heap.reserve(k);
+        statistics.buffer(k * sizeof(DataT));
+        DataT next;
+        while (readElement(read, next))
+        {
+            typename Statistics::Timer timer(statistics, Statistics::Sorting);
+            if (heap.size() < k)
+            {
+                heap.push_back(next);
+                std::push_heap(heap.begin(), heap.end(), compare);
+            }
+            else if (k && compare(next, heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), compare);
+                heap.back() = next;
+                std::push_heap(heap.begin(), heap.end(), compare);
+            }
+        }
+        {
+            typename Statistics::Timer timer(statistics, Statistics::Sorting);
+            std::sort_heap(heap.begin(), heap.end(), compare);
+        }
+        for (const DataT &data : heap)
+            writeElement(write, data);
+        return true;
+    }
+
+    // like prepareBuckets, but keeps only the first k elements of every sorted buffer
+    // and doesn't store elements rejected by the threshold
+    template<class InputReader>
+    bool preparePrunedBuckets(InputReader &read, std::vector<std::unique_ptr<TempQueue>> &buckets,
+                              std::size_t bufferSize, std::size_t k)
+    {
+        std::unique_ptr<DataT[]> buffer(new DataT[bufferSize]);
         if (!buffer.get())
             return false;
+        statistics.buffer(bufferSize * sizeof(DataT));
+        TopKThreshold<DataT, Comparator> threshold(k);
 
         std::size_t currentLoad = 0;
-        while (read(buffer.get()[currentLoad]))
+        bool more = true;
+        while (more)
         {
-            ++currentLoad;
-            if (currentLoad == bufferSize)
+            more = readElement(read, buffer[currentLoad]);
+            if (more && !threshold.rejects(buffer[currentLoad]))
+                ++currentLoad;
+            if (currentLoad == bufferSize || (!more && currentLoad))
             {
-                buckets.emplace_back(new TempQueue);
-                if (!dumpBuffer(buckets.back().get(), buffer.get(), currentLoad))
+                startBucket(buckets);
+                if (!dumpBuffer(buckets.back().get(), buffer.get(), currentLoad, k))
                     return false;
+                threshold.addBucket(buffer.get(), std::min(currentLoad, k));
                 currentLoad = 0;
             }
         }
-        if (currentLoad)
+
+        return true;
+    }
+
+    // like prepareBuckets, but equal elements of the sorted buffer are collapsed and the freed
+    // space is filled with new elements, which are sorted separately and merged into the buffer.
+    // New elements are read into the upper half of the free space, so the merge goes backwards
+    // into the lower half and needs no memory besides the buffer
+    template<class InputReader, class Reducer>
+    bool prepareReducedBuckets(InputReader &read, std::vector<std::unique_ptr<TempQueue>> &buckets,
+                               std::size_t bufferSize, Reducer &reduce)
+    {
+        if (!bufferSize)
+            return false;
+        std::unique_ptr<DataT[]> buffer(new DataT[bufferSize]);
+        if (!buffer.get())
+            return false;
+        statistics.buffer(bufferSize * sizeof(DataT));
+        std::size_t minimalRefill = std::max<std::size_t>(2, bufferSize / refillFraction);
+
+        std::size_t sorted = 0;
+        bool more = true;
+        while (more)
         {
-            buckets.emplace_back(new TempQueue);
-            if (!dumpBuffer(buckets.back().get(), buffer.get(), currentLoad))
-                return false;
+            DataT *run = buffer.get() + (sorted ? bufferSize - (bufferSize - sorted) / 2 : 0);
+            std::size_t limit = buffer.get() + bufferSize - run, loaded = 0;
+            while (loaded < limit && (more = readElement(read, run[loaded])))
+                ++loaded;
+
+            {
+                typename Statistics::Timer timer(statistics, Statistics::Sorting);
+                localSort(run, run + loaded);
+                mergeBackward(buffer.get(), sorted, run, loaded);
+                sorted = reduceSorted(buffer.get(), sorted + loaded, reduce);
+            }
+            if (sorted && (!more || bufferSize - sorted < minimalRefill))
+            {
+                statistics.bucket(sorted);
+                startBucket(buckets);
+                if (!spillBuffer(buckets.back().get(), buffer.get(), sorted))
+                    return false;
+                sorted = 0;
+            }
         }
 
         return true;
     }
 
-    typedef std::pair<DataT, std::size_t> HeapNode;
-    struct HeapNodeCompare
+    // merges sorted run[0, r) into sorted data[0, n), the result takes data[0, n + r).
+    // The run should not start before data + n + r, equal elements of the run go after those of data
+    void mergeBackward(DataT *data, std::size_t n, DataT *run, std::size_t r)
     {
-        bool operator() (const HeapNode& a, const HeapNode& b)
+        if (run == data)
+            return;
+        while (r)
         {
-            return compare(b.first, a.first);
-//            if (compare(b.first, a.first))
-//                return true;
-//            if (compare(a.first, b.first))
-//                return false;
-//            return a.second < b.second;
+            if (n && compare(run[r - 1], data[n - 1]))
+            {
+                --n;
+                data[n + r] = std::move(data[n]);
+            }
+            else
+            {
+                --r;
+                data[n + r] = std::move(run[r]);
+            }
+        }
+    }
+
+    // collapses equal neighbours of the sorted array, returns the number of elements left
+    template<class Reducer>
+    std::size_t reduceSorted(DataT *data, std::size_t n, Reducer &reduce)
+    {
+        if (!n)
+            return 0;
+        std::size_t last = 0;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            if (compare(data[last], data[i]))
+            {
+                if (++last != i)
+                    data[last] = std::move(data[i]);
+            }
+            else
+                reduce(data[last], data[i]);
+        }
+        return last + 1;
+    }
+
+    // heap element: number of the bucket it goes to and the value itself
+    typedef std::pair<std::size_t, DataT> RunNode;
+    struct RunNodeCompare
+    {
+        bool operator() (const RunNode &a, const RunNode &b)
+        {
+            if (a.first != b.first)
+                return a.first > b.first;
+            return compare(b.second, a.second);
         }
         Comparator compare;
     };
 
-    template<class OutputWriter>
-    bool mergeBuckets(OutputWriter &write, std::vector<std::unique_ptr<TempQueue>> &buckets)
+    template<class InputReader>
+    bool prepareReplacementSelectionBuckets(InputReader &read, std::vector<std::unique_ptr<TempQueue>> &buckets,
+                                            std::size_t bufferSize)
+    {
+        std::vector<RunNode> heap;
+        heap.reserve(bufferSize);
+        statistics.buffer(bufferSize * sizeof(RunNode));
+        RunNode next(0, DataT());
+        while (heap.size() < bufferSize && readElement(read, next.second))
+            heap.push_back(next);
+
+        RunNodeCompare heapCompare;
+        {
+            typename Statistics::Timer timer(statistics, Statistics::Sorting);
+            std::make_heap(heap.begin(), heap.end(), heapCompare);
+        }
+        std::size_t bucketSize = 0;
+        while (!heap.empty())
+        {
+            {
+                typename Statistics::Timer timer(statistics, Statistics::Sorting);
+                std::pop_heap(heap.begin(), heap.end(), heapCompare);
+            }
+            RunNode &top = heap.back();
+            if (buckets.size() <= top.first)
+            {
+                if (!buckets.empty())
+                    statistics.bucket(bucketSize);
+                startBucket(buckets);
+                bucketSize = 0;
+            }
+            {
+                typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+                buckets.back()->push(top.second);
+                statistics.written(Statistics::SpillWriting, top.second);
+                ++bucketSize;
+            }
+
+            if (readElement(read, next.second))
+            {
+                typename Statistics::Timer timer(statistics, Statistics::Sorting);
+                next.first = compare(next.second, top.second) ? top.first + 1 : top.first;
+                std::swap(top, next);
+                std::push_heap(heap.begin(), heap.end(), heapCompare);
+            }
+            else
+                heap.pop_back();
+        }
+        if (!buckets.empty())
+            statistics.bucket(bucketSize);
+        return true;
+    }
+
+    // writes at most limit first elements of the merged buckets,
+    // equal elements are collapsed by reduce in bucket order unless it is NoReducer
+    template<class OutputWriter, class Reducer = NoReducer>
+    bool mergeBuckets(OutputWriter &write, std::vector<std::unique_ptr<TempQueue>> &buckets,
+                      std::size_t limit = std::numeric_limits<std::size_t>::max(), Reducer reduce = Reducer())
     {
-        std::priority_queue<HeapNode, std::vector<HeapNode>, HeapNodeCompare> heap;
+        const bool reducing = !std::is_same<Reducer, NoReducer>::value;
+        MergeComparator mergeCompare = statistics.template comparator<Comparator>();
+        DataT accumulated;
+        bool accumulating = false;
+
+        typename Statistics::Timer timer(statistics, Statistics::Merging);
+        // buckets are in input order, so a stable tree folds equal elements in input order
+        LoserTree<DataT, MergeComparator, !std::is_same<Reducer, NoReducer>::value>
+                tree(buckets.size(), statistics.template comparator<Comparator>());
+        // every bucket keeps its head in the tree and its read block in the queue
+        std::size_t mergeBytes = buckets.size() * sizeof(DataT);
         for (std::size_t i = 0; i < buckets.size(); ++i)
         {
-            DataT value;
-            buckets[i]->pop(value);
-            heap.emplace(value, i);
+            if (buckets[i]->pop(tree.head(i)))
+                tree.activate(i);
+            mergeBytes += queueMemory(*buckets[i], 0);
         }
+        statistics.buffer(mergeBytes);
+        tree.build();
 
-        while (!heap.empty())
+        for (std::size_t merged = 0; !tree.isEmpty() && merged < limit; ++merged)
         {
-            HeapNode node = heap.top();
-            heap.pop();
-            write(node.first);
+            std::size_t source = tree.winner();
+            statistics.read(Statistics::Merging, tree.top());
+            if (!reducing)
+                writeElement(write, tree.top());
+            else if (accumulating && !mergeCompare(accumulated, tree.top()))
+                reduce(accumulated, tree.top());
+            else
+            {
+                if (accumulating)
+                    writeElement(write, accumulated);
+                accumulated = tree.top();
+                accumulating = true;
+            }
 
-            if (buckets[node.second]->pop(node.first))
-                heap.push(node);
+            if (buckets[source]->pop(tree.top()))
+                tree.update();
             else
-                buckets[node.second].reset();
+            {
+                buckets[source].reset();
+                tree.exhaust();
+            }
         }
+        if (accumulating)
+            writeElement(write, accumulated);
         return true;
     }
 
+    template<class OutputWriter>
+    void writeElement(OutputWriter &write, const DataT &data)
+    {
+        typename Statistics::Timer timer(statistics, Statistics::OutputWriting);
+        write(data);
+        statistics.written(Statistics::OutputWriting, data);
+    }
+
+    RunFormation runFormation;
     LocalSorter localSort;
     Comparator compare;
+    Statistics statistics;
 };
 
 #endif // EXTERNALSORT_H
@@ -0,0 +1,171 @@
+#ifndef BLOCKCODECS_H
+#define BLOCKCODECS_H
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// Codecs for CompressedFStreamQueue. A codec should have
+//     static void encode(const DataT *data, std::size_t count, std::vector<char> &out)
+//     static bool decode(const char *in, std::size_t size, DataT *data, std::size_t count)
+// encode appends the encoded block to out, decode returns false on malformed input.
+
+namespace Varint
+{
+    inline void put(std::uint64_t value, std::vector<char> &out)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(char(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(char(value));
+    }
+
+    inline bool get(const char *&in, const char *end, std::uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; in != end && shift < 64; shift += 7)
+        {
+            unsigned char byte = *in++;
+            value |= std::uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+}
+
+// Integers: first value and differences between neighbours as zigzag varints.
+// Sorted runs of close values take 1-2 bytes per element, any order is still decoded correctly.
+template <typename IntT>
+struct DeltaVarintCodec
+{
+    static_assert(std::is_integral<IntT>::value, "DeltaVarintCodec works with integers only");
+
+    typedef typename std::make_unsigned<IntT>::type UnsignedT;
+    typedef typename std::make_signed<IntT>::type SignedT;
+
+    static void encode(const IntT *data, std::size_t count, std::vector<char> &out)
+    {
+        UnsignedT previous = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            UnsignedT delta = UnsignedT(UnsignedT(data[i]) - previous);
+            std::int64_t signedDelta = SignedT(delta);
+            Varint::put((std::uint64_t(signedDelta) << 1) ^ std::uint64_t(signedDelta >> 63), out);
+            previous = UnsignedT(data[i]);
+        }
+    }
+
+    static bool decode(const char *in, std::size_t size, IntT *data, std::size_t count)
+    {
+        const char *end = in + size;
+        UnsignedT previous = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::uint64_t zigzag;
+            if (!Varint::get(in, end, zigzag))
+                return false;
+            std::uint64_t delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+            previous = UnsignedT(previous + UnsignedT(delta));
+            data[i] = IntT(previous);
+        }
+        return in == end;
+    }
+};
+
+// Any trivially copyable type: LZ77 over the raw bytes of the block.
+// Sequence is (literal count, literals, match length, match offset if length > 0),
+// matches are found by a hash of 4 bytes and may overlap their own output.
+template <typename DataT>
+struct LZByteCodec
+{
+    static_assert(std::is_trivially_copyable<DataT>::value, "LZByteCodec works with trivially copyable types only");
+
+    static const std::size_t MinMatch = 4;
+    static const std::size_t MaxOffset = 1 << 16;
+    static const int HashBits = 12;
+
+    static void encode(const DataT *data, std::size_t count, std::vector<char> &out)
+    {
+        const unsigned char *in = reinterpret_cast<const unsigned char *>(data);
+        std::size_t size = count * sizeof(DataT);
+
+        std::vector<std::uint32_t> table(1 << HashBits, 0); // position + 1, 0 if empty
+        std::size_t anchor = 0, i = 0;
+        while (i + MinMatch <= size)
+        {
+            std::uint32_t &slot = table[hash(in + i)];
+            std::size_t candidate = slot;
+            slot = std::uint32_t(i + 1);
+            if (candidate && i + 1 - candidate <= MaxOffset && !std::memcmp(in + candidate - 1, in + i, MinMatch))
+            {
+                std::size_t from = candidate - 1, length = MinMatch;
+                while (i + length < size && in[from + length] == in[i + length])
+                    ++length;
+                putSequence(in + anchor, i - anchor, length, i - from, out);
+                i += length;
+                anchor = i;
+            }
+            else
+                ++i;
+        }
+        putSequence(in + anchor, size - anchor, 0, 0, out);
+    }
+
+    static bool decode(const char *in, std::size_t size, DataT *data, std::size_t count)
+    {
+        const char *end = in + size;
+        unsigned char *out = reinterpret_cast<unsigned char *>(data);
+        std::size_t capacity = count * sizeof(DataT), used = 0;
+        while (in != end)
+        {
+            std::uint64_t literals, length, offset = 0;
+            if (!Varint::get(in, end, literals) || literals > std::uint64_t(end - in) || literals > capacity - used)
+                return false;
+            if (literals)
+                std::memcpy(out + used, in, literals);
+            in += literals;
+            used += literals;
+
+            if (!Varint::get(in, end, length) || length > capacity - used)
+                return false;
+            if (length && (!Varint::get(in, end, offset) || !offset || offset > used))
+                return false;
+            for (std::size_t k = 0; k < length; ++k, ++used)
+                out[used] = out[used - offset];
+        }
+        return used == capacity;
+    }
+
+private:
+    static std::size_t hash(const unsigned char *p)
+    {
+        std::uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return (word * 2654435761u) >> (32 - HashBits);
+    }
+
+    static void putSequence(const unsigned char *literals, std::size_t literalCount,
+                            std::size_t length, std::size_t offset, std::vector<char> &out)
+    {
+        Varint::put(literalCount, out);
+        out.insert(out.end(), literals, literals + literalCount);
+        Varint::put(length, out);
+        if (length)
+            Varint::put(offset, out);
+    }
+};
+
+template <typename DataT> struct DefaultBlockCodec
+{
+    typedef typename std::conditional<
+                                      std::is_integral<DataT>::value && !std::is_same<DataT, bool>::value,
+                                      DeltaVarintCodec<DataT>,
+                                      LZByteCodec<DataT>
+                     >::type Type;
+};
+
+#endif // BLOCKCODECS_H
@@ -0,0 +1,83 @@
+#ifndef BLOCKISTREAMREADER_H
+#define BLOCKISTREAMREADER_H
+
+#include <istream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+// Reads raw values from the stream buffer by big blocks (one sgetn per block,
+// which goes straight to read(2) for file buffers) and hands them out from memory.
+// The block is allocated on the first read.
+// DataT should be trivially copyable.
+template <typename DataT>
+class BlockIStreamReader
+{
+public:
+    typedef DataT DataType;
+    typedef std::istream Stream;
+
+    static const std::size_t DataSize = sizeof(DataType);
+    static const std::size_t DefaultBlockSize = 1 << 16;
+
+    explicit BlockIStreamReader(Stream &stream, std::size_t blockSize = DefaultBlockSize):
+        stream(&stream), capacity(std::max<std::size_t>(blockSize / DataSize, 1) * DataSize),
+        position(0), loaded(0)
+    {
+    }
+
+    bool operator() (DataType &d)
+    {
+        if (position + DataSize > loaded && !fill())
+            return false;
+        std::memcpy(&d, block.data() + position, DataSize);
+        position += DataSize;
+        return true;
+    }
+
+    // reads up to count values, returns number of values read
+    std::size_t operator() (DataType *d, std::size_t count)
+    {
+        std::size_t done = 0;
+        while (done < count && (position + DataSize <= loaded || fill()))
+        {
+            std::size_t n = std::min((loaded - position) / DataSize, count - done);
+            std::memcpy(d + done, block.data() + position, n * DataSize);
+            position += n * DataSize;
+            done += n;
+        }
+        return done;
+    }
+
+    // bytes of the block kept in memory
+    std::size_t memorySize() const
+    {
+        return block.capacity();
+    }
+
+private:
+    bool fill()
+    {
+        if (block.empty())
+            block.resize(capacity);
+        std::size_t tail = loaded - position;
+        std::memmove(block.data(), block.data() + position, tail);
+        position = 0;
+        loaded = tail;
+        if (*stream)
+        {
+            std::streamsize got = stream->rdbuf()->sgetn(block.data() + loaded, block.size() - loaded);
+            loaded += std::max<std::streamsize>(got, 0);
+            if (loaded < block.size())
+                stream->setstate(std::ios_base::eofbit);
+        }
+        return loaded >= DataSize;
+    }
+
+    Stream *stream;
+    std::size_t capacity;
+    std::vector<char> block;
+    std::size_t position, loaded;
+};
+
+#endif // BLOCKISTREAMREADER_H
@@ -0,0 +1,92 @@
+#ifndef BLOCKOSTREAMWRITER_H
+#define BLOCKOSTREAMWRITER_H
+
+#include <ostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+// Collects raw values in memory and passes them to the stream buffer by big blocks
+// (one sputn per block, which goes straight to write(2) for file buffers).
+// The block is allocated on the first write and freed by release(). A full block only goes
+// to the stream buffer, the stream itself is flushed by flush(), release() and on destruction.
+// DataT should be trivially copyable.
+template <typename DataT>
+class BlockOStreamWriter
+{
+public:
+    typedef DataT DataType;
+    typedef std::ostream Stream;
+
+    static const std::size_t DataSize = sizeof(DataType);
+    static const std::size_t DefaultBlockSize = 1 << 16;
+
+    explicit BlockOStreamWriter(Stream &stream, std::size_t blockSize = DefaultBlockSize):
+        stream(&stream), capacity(std::max<std::size_t>(blockSize / DataSize, 1) * DataSize), used(0)
+    {}
+
+    ~BlockOStreamWriter()
+    {
+        flush();
+    }
+
+    void operator() (const DataType &data)
+    {
+        if (block.empty())
+            block.resize(capacity);
+        if (used + DataSize > block.size())
+            writeBlock();
+        std::memcpy(block.data() + used, &data, DataSize);
+        used += DataSize;
+    }
+
+    void operator() (const DataType *data, std::size_t count)
+    {
+        if (block.empty())
+            block.resize(capacity);
+        while (count)
+        {
+            if (used + DataSize > block.size())
+                writeBlock();
+            std::size_t n = std::min((block.size() - used) / DataSize, count);
+            std::memcpy(block.data() + used, data, n * DataSize);
+            used += n * DataSize;
+            data += n;
+            count -= n;
+        }
+    }
+
+    void flush()
+    {
+        writeBlock();
+        stream->flush();
+    }
+
+    // flushes and frees the block, writing after it allocates a new one
+    void release()
+    {
+        flush();
+        std::vector<char>().swap(block);
+    }
+
+    // bytes of the block kept in memory
+    std::size_t memorySize() const
+    {
+        return block.capacity();
+    }
+
+private:
+    void writeBlock()
+    {
+        if (used && stream->rdbuf()->sputn(block.data(), used) != std::streamsize(used))
+            stream->setstate(std::ios_base::badbit);
+        used = 0;
+    }
+
+    Stream *stream;
+    std::size_t capacity;
+    std::vector<char> block;
+    std::size_t used;
+};
+
+#endif // BLOCKOSTREAMWRITER_H
@@ -0,0 +1,167 @@
+#ifndef COMPRESSEDFSTREAMQUEUE_H
+#define COMPRESSEDFSTREAMQUEUE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+#include <unistd.h>
+
+#include <fstream>
+#include <vector>
+
+#include "blockcodecs.h"
+
+// TempQueue for ExternalSorter which keeps its file compressed.
+// Values are collected into blocks of BlockBytes, every block is encoded by Codec
+// and written as (value count, encoded size, encoded bytes). The block is allocated
+// on the first push, so empty queues cost nothing, and freed by finishPushing(), which
+// ExternalSorter calls when it starts the next bucket: only the bucket being filled keeps
+// a block while buckets are formed. Every bucket keeps one decoded block while they are merged.
+// DataT should be trivially copyable, integers are delta-coded by default.
+template <typename DataT,
+          class Codec = typename DefaultBlockCodec<DataT>::Type,
+          std::size_t BlockBytes = 1 << 16>
+class CompressedFStreamQueue
+{
+public:
+    CompressedFStreamQueue(): state(Pushing), position(0), encodedBytes(0)
+    {
+        std::strcpy(fileName, P_tmpdir "/sortextXXXXXX");
+        int fd = mkstemp(fileName);
+        if (fd >= 0)
+        {
+            close(fd);
+            stream.open(fileName, std::ios_base::out | std::ios_base::binary);
+        }
+    }
+    ~CompressedFStreamQueue()
+    {
+        stream.close();
+        remove(fileName);
+    }
+
+    void push(const DataT& data)
+    {
+        assert(state == Pushing);
+        if (block.empty())
+            block.reserve(BlockSize);
+        block.push_back(data);
+        if (block.size() == BlockSize)
+            writeBlock();
+    }
+
+    // writes the collected values and frees the block, values may still be pushed after it
+    void finishPushing()
+    {
+        assert(state == Pushing);
+        if (!block.empty())
+            writeBlock();
+        std::vector<DataT>().swap(block);
+        std::vector<char>().swap(encoded);
+    }
+    bool pop(DataT& data)
+    {
+        if (state != Popping)
+            setState(Popping);
+        if (position == block.size() && !readBlock())
+            return false;
+        data = block[position++];
+        return true;
+    }
+
+    // bytes written to the file so far
+    std::size_t fileSize() const
+    {
+        return encodedBytes;
+    }
+
+    // bytes of blocks kept in memory
+    std::size_t memorySize() const
+    {
+        return block.capacity() * sizeof(DataT) + encoded.capacity();
+    }
+
+protected:
+    enum State
+    {
+        Pushing = 0,
+        Popping = 1
+    };
+
+    void setState(State newState)
+    {
+        assert(newState == Popping);
+        if (!block.empty())
+            writeBlock();
+        std::vector<DataT>().swap(block);
+        std::vector<char>().swap(encoded);
+        stream.close();
+        stream.open(fileName, std::ios_base::in | std::ios_base::binary);
+        position = 0;
+        state = newState;
+    }
+
+private:
+    static const std::size_t BlockSize = BlockBytes / sizeof(DataT) ? BlockBytes / sizeof(DataT) : 1;
+
+    void writeBlock()
+    {
+        encoded.clear();
+        Varint::put(block.size(), encoded);
+        std::size_t header = encoded.size();
+        Codec::encode(block.data(), block.size(), encoded);
+
+        std::vector<char> size;
+        Varint::put(encoded.size() - header, size);
+        stream.write(encoded.data(), header);
+        stream.write(size.data(), size.size());
+        stream.write(encoded.data() + header, encoded.size() - header);
+        encodedBytes += encoded.size() + size.size();
+        block.clear();
+    }
+
+    bool readBlock()
+    {
+        std::uint64_t count, size;
+        if (!getVarint(count) || !count || !getVarint(size))
+            return false;
+        encoded.resize(size);
+        block.resize(count);
+        position = 0;
+        if (!stream.read(encoded.data(), size) ||
+            !Codec::decode(encoded.data(), size, block.data(), count))
+        {
+            stream.setstate(std::ios_base::badbit);
+            block.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool getVarint(std::uint64_t &value)
+    {
+        char bytes[10];
+        std::size_t used = 0;
+        while (used < sizeof(bytes) && stream.get(bytes[used]))
+            if (!(bytes[used++] & 0x80))
+            {
+                const char *begin = bytes;
+                return Varint::get(begin, bytes + used, value);
+            }
+        return false;
+    }
+
+    char fileName[sizeof(P_tmpdir "/sortextXXXXXX")];
+    State state;
+
+    std::fstream stream;
+
+    std::vector<DataT> block;
+    std::size_t position;
+    std::vector<char> encoded;
+    std::size_t encodedBytes;
+};
+
+#endif // COMPRESSEDFSTREAMQUEUE_H
@@ -9,6 +9,10 @@
 
 #include "optimalstreamio.h"
 
+// TempQueue for ExternalSorter which keeps its values in a temporary file.
+// Memory of the writer (e.g. the block of BlockOStreamWriter) is freed by finishPushing(),
+// which ExternalSorter calls when it starts the next bucket, and when popping starts,
+// memory of the reader is kept while the queue is popped.
 template <typename DataT, class ReaderT, class WriterT>
 class FStreamQueue
 {
@@ -36,6 +40,19 @@ public:
         return reader(data);
     }
 
+    // writes the collected values and frees the writer memory, values may still be pushed after it
+    void finishPushing()
+    {
+        assert(state == Pushing);
+        release(writer, 0);
+    }
+
+    // bytes kept in memory by the reader and the writer (0 for those which don't tell)
+    std::size_t memorySize() const
+    {
+        return memorySize(reader, 0) + memorySize(writer, 0);
+    }
+
 protected:
     enum State
     {
@@ -52,6 +69,7 @@ protected:
         }
         else if (newState == Popping)
         {
+            release(writer, 0);
             stream.close();
             stream.open(fileName, std::ios_base::in | std::ios_base::binary);
             stream.precision(10);
@@ -60,6 +78,30 @@ protected:
     }
 
 private:
+    template <class IO>
+    static auto release(IO &io, int) -> decltype(io.release(), void())
+    {
+        io.release();
+    }
+
+    template <class IO>
+    static void release(IO &io, long)
+    {
+        io.flush();
+    }
+
+    template <class IO>
+    static auto memorySize(const IO &io, int) -> decltype(std::size_t(io.memorySize()))
+    {
+        return io.memorySize();
+    }
+
+    template <class IO>
+    static std::size_t memorySize(const IO &, long)
+    {
+        return 0;
+    }
+
     char fileName[L_tmpnam];
     State state;
 
@@ -1,7 +1,7 @@
 #ifndef ISTREAMREADER_H
 #define ISTREAMREADER_H
 
-#include <ios>
+#include <istream>
 
 template <typename DataT>
 class IStreamReader
@@ -19,7 +19,7 @@ public:
         if (!*stream)
             return false;
         *stream >> data;
-        return *stream;
+        return static_cast<bool>(*stream);
     }
 
 private:
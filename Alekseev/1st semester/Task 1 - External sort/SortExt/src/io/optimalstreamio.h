@@ -9,6 +9,9 @@
 #include "rawistreamreader.h"
 #include "rawostreamwriter.h"
 
+#include "blockistreamreader.h"
+#include "blockostreamwriter.h"
+
 template<typename DataT> struct IsRawWritable :
         std::integral_constant<bool, std::is_integral<DataT>::value || std::is_floating_point<DataT>::value> {};
 //        std::integral_constant<bool, std::is_arithmetic<typename std::remove_all_extents<DataT>::type >::value> {};
@@ -17,12 +20,12 @@ template<typename DataT> struct OptimalStreamIO
 {
     typedef typename std::conditional<
                                       IsRawWritable<DataT>::value,
-                                      RawIStreamReader<DataT>,
+                                      BlockIStreamReader<DataT>,
                                       IStreamReader<DataT>
                      >::type ReaderType;
     typedef typename std::conditional<
                                       IsRawWritable<DataT>::value,
-                                      RawOStreamWriter<DataT>,
+                                      BlockOStreamWriter<DataT>,
                                       OStreamWriter<DataT>
                      >::type WriterType;
 };
@@ -22,6 +22,11 @@ public:
         *stream << data << suffix();
     }
 
+    void flush()
+    {
+        stream->flush();
+    }
+
 private:
     std::string suffix() const
     {
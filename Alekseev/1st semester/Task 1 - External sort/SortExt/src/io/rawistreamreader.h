@@ -22,7 +22,7 @@ public:
         if (!*stream)
             return false;
         stream->read(reinterpret_cast<char*>(&d), DataSize);
-        return *stream;
+        return static_cast<bool>(*stream);
     }
 
 private:
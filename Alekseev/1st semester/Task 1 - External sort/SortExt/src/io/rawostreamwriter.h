@@ -21,6 +21,11 @@ public:
         stream->write(reinterpret_cast<const char*>(&data), DataSize);
     }
 
+    void flush()
+    {
+        stream->flush();
+    }
+
 private:
     Stream *stream;
 };
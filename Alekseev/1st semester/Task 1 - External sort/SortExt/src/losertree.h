@@ -0,0 +1,103 @@
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+
+// Tournament tree for k-way merge. Inner nodes keep only indices of the sources
+// which lost the match there, so replacing the winner's head costs one comparison per level.
+// If Stable, equal keys are taken from the source with the smaller index first.
+template<typename DataT,
+         class Comparator = std::less<DataT>,
+         bool Stable      = false>
+class LoserTree
+{
+public:
+    explicit LoserTree(std::size_t ways, const Comparator &compare = Comparator()):
+        ways(ways), heads(ways), alive(ways, false), tree(ways ? ways : 1), compare(compare)
+    {}
+
+    // slot for the current head of the source; call activate() after filling it
+    DataT &head(std::size_t way)
+    {
+        return heads[way];
+    }
+    void activate(std::size_t way)
+    {
+        alive[way] = true;
+    }
+
+    void build()
+    {
+        if (!ways)
+            return;
+        std::vector<std::size_t> winners(ways);
+        for (std::size_t node = ways - 1; node > 0; --node)
+        {
+            std::size_t a = player(2 * node, winners), b = player(2 * node + 1, winners);
+            if (beats(b, a))
+                std::swap(a, b);
+            winners[node] = a;
+            tree[node] = b;
+        }
+        tree[0] = ways > 1 ? winners[1] : 0;
+    }
+
+    bool isEmpty() const
+    {
+        return !ways || !alive[tree[0]];
+    }
+    std::size_t winner() const
+    {
+        return tree[0];
+    }
+    DataT &top()
+    {
+        return heads[tree[0]];
+    }
+
+    // top() was overwritten by the next value of the winner source
+    void update()
+    {
+        replay(tree[0]);
+    }
+    // winner source is empty
+    void exhaust()
+    {
+        alive[tree[0]] = false;
+        replay(tree[0]);
+    }
+
+private:
+    std::size_t player(std::size_t position, const std::vector<std::size_t> &winners) const
+    {
+        return position >= ways ? position - ways : winners[position];
+    }
+
+    bool beats(std::size_t a, std::size_t b)
+    {
+        if (!alive[a] || !alive[b])
+            return alive[a];
+        if (Stable)
+            return compare(heads[a], heads[b]) || (a < b && !compare(heads[b], heads[a]));
+        return compare(heads[a], heads[b]);
+    }
+
+    void replay(std::size_t current)
+    {
+        for (std::size_t node = (current + ways) >> 1; node > 0; node >>= 1)
+            if (beats(tree[node], current))
+                std::swap(tree[node], current);
+        tree[0] = current;
+    }
+
+    std::size_t ways;
+    std::vector<DataT> heads;
+    std::vector<bool> alive;
+    std::vector<std::size_t> tree;
+
+    Comparator compare;
+};
+
+#endif // LOSERTREE_H
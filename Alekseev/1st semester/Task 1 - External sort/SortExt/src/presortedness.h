@@ -0,0 +1,78 @@
+#ifndef PRESORTEDNESS_H
+#define PRESORTEDNESS_H
+
+#include <vector>
+#include <algorithm>
+
+// Order found in a buffer by one scan before it goes to LocalSorter
+struct BufferOrder
+{
+    enum Kind
+    {
+        Sorted,     // nothing to do
+        Reversed,   // strictly descending, so reversing it keeps equal elements in order
+        FewRuns,    // at most maxRuns ascending runs, merged pairwise with std::inplace_merge
+        Unordered   // left untouched for LocalSorter
+    };
+};
+
+// Puts [begin, end) in order if it is sorted, reversed or made of a few ascending runs.
+// The scan stops as soon as there are more than maxRuns runs and the buffer isn't descending,
+// so a random buffer costs about 2 * maxRuns comparisons and at most maxRuns run starts are stored.
+template<class It, class Comparator>
+BufferOrder::Kind orderPresorted(It begin, It end, Comparator compare, std::size_t maxRuns)
+{
+    if (end - begin < 2)
+        return BufferOrder::Sorted;
+
+    // while the buffer is descending every element starts a run, so runs are only counted
+    std::vector<It> runs;
+    std::size_t descents = 0;
+    bool descending = true;
+    for (It current = begin + 1; current < end; ++current)
+    {
+        if (!compare(*current, *(current - 1)))
+        {
+            if (!descending)
+                continue;
+            descending = false;
+            if (descents + 1 > maxRuns)
+                return BufferOrder::Unordered;
+            for (It run = begin; run < current; ++run)
+                runs.push_back(run);
+        }
+        else if (descending)
+            ++descents;
+        else
+        {
+            runs.push_back(current);
+            if (runs.size() > maxRuns)
+                return BufferOrder::Unordered;
+        }
+    }
+
+    if (descending)
+    {
+        std::reverse(begin, end);
+        return BufferOrder::Reversed;
+    }
+    if (runs.size() == 1)
+        return BufferOrder::Sorted;
+
+    runs.push_back(end);
+    while (runs.size() > 2)
+    {
+        std::vector<It> merged;
+        for (std::size_t i = 0; i + 1 < runs.size(); i += 2)
+        {
+            merged.push_back(runs[i]);
+            if (i + 2 < runs.size())
+                std::inplace_merge(runs[i], runs[i + 1], runs[i + 2], compare);
+        }
+        merged.push_back(end);
+        runs.swap(merged);
+    }
+    return BufferOrder::FewRuns;
+}
+
+#endif // PRESORTEDNESS_H
@@ -0,0 +1,187 @@
+#ifndef SORTSTATISTICS_H
+#define SORTSTATISTICS_H
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <sstream>
+#include <algorithm>
+
+// Statistics policies for ExternalSorter.
+// NoSortStatistics has only empty inline methods, so a sorter without statistics does no extra work.
+// SortStatistics counts records and bytes read and written in every phase, sizes of buckets,
+// time of every phase, comparator calls made by the merge and the biggest buffer allocated.
+
+struct SortPhases
+{
+    enum Phase
+    {
+        Reading,        // calls of the input reader
+        Sorting,        // LocalSorter (heap operations of replacement selection)
+        SpillWriting,   // pushing sorted data to buckets
+        Merging,        // merge of buckets, its time includes writing of the output
+        OutputWriting,  // calls of the output writer
+        PhasesCount
+    };
+};
+
+// sizeof for fixed-size types, length for strings
+template<typename DataT>
+inline std::uint64_t recordBytes(const DataT &)
+{
+    return sizeof(DataT);
+}
+
+inline std::uint64_t recordBytes(const std::string &s)
+{
+    return s.size();
+}
+
+// counts calls of the wrapped comparator
+template<class Comparator>
+class CountingComparator
+{
+public:
+    explicit CountingComparator(std::uint64_t *counter = 0): counter(counter) {}
+
+    template<typename DataT>
+    bool operator()(const DataT &a, const DataT &b)
+    {
+        ++*counter;
+        return compare(a, b);
+    }
+
+private:
+    Comparator compare;
+    std::uint64_t *counter;
+};
+
+class NoSortStatistics : public SortPhases
+{
+public:
+    template<class Comparator> struct Compare
+    {
+        typedef Comparator Type;
+    };
+
+    class Timer
+    {
+    public:
+        Timer(NoSortStatistics &, Phase) {}
+    };
+
+    template<class Comparator> Comparator comparator()
+    {
+        return Comparator();
+    }
+
+    template<typename DataT> void read(Phase, const DataT &) {}
+    template<typename DataT> void written(Phase, const DataT &) {}
+    void bucket(std::uint64_t) {}
+    void buffer(std::size_t) {}
+};
+
+class SortStatistics : public SortPhases
+{
+public:
+    struct PhaseStatistics
+    {
+        std::uint64_t recordsRead, bytesRead, recordsWritten, bytesWritten;
+        double seconds;
+    };
+
+    PhaseStatistics phases[PhasesCount];
+    std::vector<std::uint64_t> buckets;  // records in every bucket
+    std::uint64_t comparisons;
+    std::size_t peakBufferBytes;
+
+    SortStatistics()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (PhaseStatistics &phase : phases)
+            phase = PhaseStatistics();
+        buckets.clear();
+        comparisons = 0;
+        peakBufferBytes = 0;
+    }
+
+    static const char *phaseName(Phase phase)
+    {
+        static const char *names[PhasesCount] = {"reading", "sorting", "spillWriting", "merging", "outputWriting"};
+        return names[phase];
+    }
+
+    std::string toJson() const
+    {
+        std::ostringstream out;
+        out << "{\"phases\": {";
+        for (int phase = 0; phase < PhasesCount; ++phase)
+        {
+            const PhaseStatistics &p = phases[phase];
+            out << (phase ? ", " : "") << "\"" << phaseName(Phase(phase)) << "\": {"
+                << "\"recordsRead\": " << p.recordsRead << ", \"bytesRead\": " << p.bytesRead
+                << ", \"recordsWritten\": " << p.recordsWritten << ", \"bytesWritten\": " << p.bytesWritten
+                << ", \"seconds\": " << p.seconds << "}";
+        }
+        out << "}, \"buckets\": [";
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+            out << (i ? ", " : "") << buckets[i];
+        out << "], \"comparisons\": " << comparisons << ", \"peakBufferBytes\": " << peakBufferBytes << "}";
+        return out.str();
+    }
+
+    // interface used by ExternalSorter
+
+    template<class Comparator> struct Compare
+    {
+        typedef CountingComparator<Comparator> Type;
+    };
+
+    // adds time from construction to destruction to the phase
+    class Timer
+    {
+    public:
+        Timer(SortStatistics &statistics, Phase phase):
+            seconds(&statistics.phases[phase].seconds), start(std::chrono::steady_clock::now())
+        {}
+        ~Timer()
+        {
+            *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        double *seconds;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    template<class Comparator> CountingComparator<Comparator> comparator()
+    {
+        return CountingComparator<Comparator>(&comparisons);
+    }
+
+    template<typename DataT> void read(Phase phase, const DataT &data)
+    {
+        ++phases[phase].recordsRead;
+        phases[phase].bytesRead += recordBytes(data);
+    }
+    template<typename DataT> void written(Phase phase, const DataT &data)
+    {
+        ++phases[phase].recordsWritten;
+        phases[phase].bytesWritten += recordBytes(data);
+    }
+    void bucket(std::uint64_t records)
+    {
+        buckets.push_back(records);
+    }
+    void buffer(std::size_t bytes)
+    {
+        peakBufferBytes = std::max(peakBufferBytes, bytes);
+    }
+};
+
+#endif // SORTSTATISTICS_H
@@ -0,0 +1,81 @@
+#ifndef TOPKTHRESHOLD_H
+#define TOPKTHRESHOLD_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+// Running bound for selection of the k smallest elements from sorted buckets.
+// Every bucket gives checkpoints: evenly spaced elements among its first k ones, the checkpoint
+// at position p certifies that the bucket has p elements not greater than it.
+// The threshold is the smallest checkpoint such that checkpoints not greater than it certify
+// at least k elements, so nothing greater than the threshold can be among the k smallest.
+template<typename DataT,
+         class Comparator = std::less<DataT>>
+class TopKThreshold
+{
+public:
+    explicit TopKThreshold(std::size_t k, std::size_t checkpointsPerBucket = 64):
+        k(k), step(std::max<std::size_t>(1, k / std::max<std::size_t>(1, checkpointsPerBucket))), found(false)
+    {}
+
+    bool isKnown() const
+    {
+        return found;
+    }
+    const DataT &value() const
+    {
+        return threshold;
+    }
+
+    // true if the element can't be among the k smallest ones
+    bool rejects(const DataT &data)
+    {
+        return found && compare(threshold, data);
+    }
+
+    // adds checkpoints of the sorted bucket
+    void addBucket(const DataT *bucket, std::size_t size)
+    {
+        std::size_t limit = std::min(size, k), previous = 0;
+        for (std::size_t position = step; previous < limit; position += step)
+        {
+            position = std::min(position, limit);
+            checkpoints.push_back(Checkpoint(bucket[position - 1], position - previous));
+            previous = position;
+        }
+        update();
+    }
+
+private:
+    // element and the number of elements it certifies
+    typedef std::pair<DataT, std::size_t> Checkpoint;
+
+    void update()
+    {
+        std::sort(checkpoints.begin(), checkpoints.end(),
+                  [this](const Checkpoint &a, const Checkpoint &b) { return compare(a.first, b.first); });
+        std::size_t certified = 0;
+        for (std::size_t i = 0; i < checkpoints.size(); ++i)
+        {
+            certified += checkpoints[i].second;
+            if (certified >= k)
+            {
+                threshold = checkpoints[i].first;
+                found = true;
+                // greater checkpoints will never be the threshold
+                checkpoints.erase(checkpoints.begin() + i + 1, checkpoints.end());
+                return;
+            }
+        }
+    }
+
+    std::size_t k, step;
+    std::vector<Checkpoint> checkpoints;
+    DataT threshold;
+    bool found;
+    Comparator compare;
+};
+
+#endif // TOPKTHRESHOLD_H
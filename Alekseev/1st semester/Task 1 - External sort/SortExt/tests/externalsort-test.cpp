@@ -104,3 +104,319 @@ TEST(ExternalSort, ManuallyGeneratedComplexData)
         EXPECT_EQ(expected[i].s, writer.contents()[i].s);
     }
 }
+
+TEST(ExternalSort, ReplacementSelectionPermutation)
+{
+    ExternalSorter<int> sorter(ExternalSorter<int>::ReplacementSelection);
+
+    std::vector<int> data;
+    for (int i = 0; i < 200000; ++i)
+        data.push_back(i);
+    ShuffledVectorReader<int> reader(5, data);
+    VectorWriter<int> writer;
+
+    ASSERT_TRUE(sorter.sort(reader, writer, 3000));
+    EXPECT_EQ(data, writer.contents());
+}
+
+TEST(ExternalSort, ReplacementSelectionComplexData)
+{
+    typedef ExternalSorter<ComplexData, ComplexDataComparator> Sorter;
+    Sorter sorter(Sorter::ReplacementSelection);
+
+    std::vector<ComplexData> data =
+    {
+        ComplexData(3.1415926, "pi"),
+        ComplexData(54e200, "huge"),
+        ComplexData(0., "zero"),
+        ComplexData(3.14, "some"),
+        ComplexData(3.1415926, "pi"),
+        ComplexData(-0., "another zero")
+    };
+
+    VectorReader<ComplexData> reader(data);
+    VectorWriter<ComplexData> writer;
+
+    ASSERT_TRUE(sorter.sort(reader, writer, 2));
+
+    std::vector<ComplexData> expected = data;
+    sort(expected.begin(), expected.end(), ComplexDataComparator());
+    EXPECT_EQ(expected, writer.contents());
+}
+
+TEST(ExternalSort, CompressedTempQueue)
+{
+    ExternalSorter<int, std::less<int>, StdSorter<std::less<int>>, CompressedFStreamQueue<int>> sorter;
+
+    std::vector<int> data;
+    for (int i = -100000; i < 100000; ++i)
+        data.push_back(i);
+    ShuffledVectorReader<int> reader(17, data);
+    VectorWriter<int> writer;
+
+    ASSERT_TRUE(sorter.sort(reader, writer, 7000));
+    EXPECT_EQ(data, writer.contents());
+}
+
+TEST(ExternalSort, Statistics)
+{
+    typedef ExternalSorter<int, std::less<int>, StdSorter<std::less<int>>,
+                           FStreamQueue<int, OptimalStreamIO<int>::ReaderType, OptimalStreamIO<int>::WriterType>,
+                           SortStatistics> Sorter;
+
+    std::vector<int> data;
+    for (int i = 0; i < 50000; ++i)
+        data.push_back(i);
+
+    Sorter sorter;
+    ShuffledVectorReader<int> reader(5, data);
+    VectorWriter<int> writer;
+    ASSERT_TRUE(sorter.sort(reader, writer, 7000));
+    EXPECT_EQ(data, writer.contents());
+
+    const SortStatistics &statistics = sorter.getStatistics();
+    EXPECT_EQ(50000u, statistics.phases[SortStatistics::Reading].recordsRead);
+    EXPECT_EQ(50000u * sizeof(int), statistics.phases[SortStatistics::Reading].bytesRead);
+    EXPECT_EQ(50000u, statistics.phases[SortStatistics::SpillWriting].recordsWritten);
+    EXPECT_EQ(50000u, statistics.phases[SortStatistics::Merging].recordsRead);
+    EXPECT_EQ(50000u, statistics.phases[SortStatistics::OutputWriting].recordsWritten);
+    EXPECT_EQ(std::vector<std::uint64_t>({7000, 7000, 7000, 7000, 7000, 7000, 7000, 1000}), statistics.buckets);
+    EXPECT_GE(statistics.comparisons, 50000u);
+    // the merge keeps a head and a read block for each of 8 buckets
+    EXPECT_EQ(8 * (sizeof(int) + BlockIStreamReader<int>::DefaultBlockSize), statistics.peakBufferBytes);
+    EXPECT_GT(statistics.phases[SortStatistics::Merging].seconds, 0.0);
+
+    sorter.getStatistics().reset();
+    Sorter selection(Sorter::ReplacementSelection);
+    VectorReader<int> sortedReader(std::vector<int>(data.rbegin(), data.rend()));
+    VectorWriter<int> sortedWriter;
+    ASSERT_TRUE(selection.sort(sortedReader, sortedWriter, 100));
+    EXPECT_EQ(std::vector<std::uint64_t>({50000}), selection.getStatistics().buckets);
+}
+
+TEST(ExternalSort, SortTop)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 100000; ++i)
+        data.push_back(i);
+
+    // k fits into the buffer, k is bigger than the buffer, k is bigger than the input
+    std::size_t tops[] = {10, 7000, 25000, 200000};
+    for (std::size_t k : tops)
+    {
+        ExternalSorter<int> sorter;
+        ShuffledVectorReader<int> reader(7, data);
+        VectorWriter<int> writer;
+        ASSERT_TRUE(sorter.sortTop(reader, writer, 7000, k));
+        std::vector<int> expected(data.begin(), data.begin() + std::min(k, data.size()));
+        EXPECT_EQ(expected, writer.contents());
+    }
+
+    typedef ExternalSorter<int, std::less<int>, StdSorter<std::less<int>>,
+                           FStreamQueue<int, OptimalStreamIO<int>::ReaderType, OptimalStreamIO<int>::WriterType>,
+                           SortStatistics> Sorter;
+    Sorter sorter;
+    ShuffledVectorReader<int> reader(9, data);
+    VectorWriter<int> writer;
+    ASSERT_TRUE(sorter.sortTop(reader, writer, 5000, 8000));
+    EXPECT_EQ(std::vector<int>(data.begin(), data.begin() + 8000), writer.contents());
+    // buckets are truncated and later ones are pruned by the threshold
+    EXPECT_LT(sorter.getStatistics().phases[SortStatistics::SpillWriting].recordsWritten, 50000u);
+
+    Sorter inMemory;
+    ShuffledVectorReader<int> heapReader(9, data);
+    VectorWriter<int> heapWriter;
+    ASSERT_TRUE(inMemory.sortTop(heapReader, heapWriter, 5000, 100));
+    EXPECT_EQ(std::vector<int>(data.begin(), data.begin() + 100), heapWriter.contents());
+    EXPECT_TRUE(inMemory.getStatistics().buckets.empty());
+}
+
+TEST(ExternalSort, SortRange)
+{
+    ExternalSorter<int> sorter;
+
+    std::vector<int> data;
+    for (int i = -50000; i < 50000; ++i)
+        data.push_back(i);
+    ShuffledVectorReader<int> reader(13, data);
+    VectorWriter<int> writer;
+
+    ASSERT_TRUE(sorter.sortRange(reader, writer, 3000, -1000, 20000));
+    std::vector<int> expected;
+    for (int i = -1000; i < 20000; ++i)
+        expected.push_back(i);
+    EXPECT_EQ(expected, writer.contents());
+}
+
+namespace
+{
+struct Event
+{
+    int key;
+    int count;
+    long long value;
+
+    bool operator<(const Event &other) const
+    {
+        return key < other.key;
+    }
+};
+
+struct SumValues
+{
+    void operator()(Event &accumulated, const Event &next) const
+    {
+        accumulated.value += next.value;
+    }
+};
+
+std::vector<Event> randomEvents(std::size_t n, int keys, int seed)
+{
+    srand(seed);
+    std::vector<Event> events(n);
+    for (Event &event : events)
+    {
+        event.key = rand() % keys;
+        event.count = 1;
+        event.value = rand() % 1000;
+    }
+    return events;
+}
+}
+
+TEST(ExternalSort, SortUnique)
+{
+    typedef ExternalSorter<Event, std::less<Event>, StdSorter<std::less<Event>>,
+                           FStreamQueue<Event, BlockIStreamReader<Event>, BlockOStreamWriter<Event>>,
+                           SortStatistics> Sorter;
+
+    // all keys fit into the buffer: one bucket; they don't: collapsing in the merge
+    int keySets[] = {300, 4000};
+    for (int keys : keySets)
+    {
+        std::vector<Event> events = randomEvents(100000, keys, keys);
+        std::vector<int> counts(keys, 0);
+        std::vector<long long> sums(keys, 0);
+        for (const Event &event : events)
+        {
+            ++counts[event.key];
+            sums[event.key] += event.value;
+        }
+
+        Sorter sorter;
+        VectorReader<Event> reader(events);
+        VectorWriter<Event> writer;
+        ASSERT_TRUE(sorter.sortUnique(reader, writer, 1000, CountDuplicates<Event, int, &Event::count>()));
+        ASSERT_EQ(std::size_t(keys), writer.contents().size());
+        for (int key = 0; key < keys; ++key)
+        {
+            EXPECT_EQ(key, writer.contents()[key].key);
+            EXPECT_EQ(counts[key], writer.contents()[key].count);
+        }
+        if (keys < 1000)
+            EXPECT_EQ(std::vector<std::uint64_t>({std::uint64_t(keys)}), sorter.getStatistics().buckets);
+        else
+            EXPECT_GT(sorter.getStatistics().buckets.size(), 1u);
+
+        VectorReader<Event> sumReader(events);
+        VectorWriter<Event> sumWriter;
+        ASSERT_TRUE(sorter.sortUnique(sumReader, sumWriter, 1000, SumValues()));
+        ASSERT_EQ(std::size_t(keys), sumWriter.contents().size());
+        for (int key = 0; key < keys; ++key)
+            EXPECT_EQ(sums[key], sumWriter.contents()[key].value);
+    }
+
+    ExternalSorter<int> sorter;
+    std::vector<int> data;
+    for (int i = 0; i < 50000; ++i)
+        data.push_back(i % 7000);
+    ShuffledVectorReader<int> reader(3, data);
+    VectorWriter<int> writer;
+    ASSERT_TRUE(sorter.sortUnique(reader, writer, 500));
+    std::vector<int> expected;
+    for (int i = 0; i < 7000; ++i)
+        expected.push_back(i);
+    EXPECT_EQ(expected, writer.contents());
+}
+
+TEST(ExternalSort, SortUniqueKeepsInputOrder)
+{
+    struct StableSorter
+    {
+        void operator() (Event *begin, Event *end)
+        {
+            std::stable_sort(begin, end);
+        }
+    };
+    typedef ExternalSorter<Event, std::less<Event>, StableSorter,
+                           FStreamQueue<Event, BlockIStreamReader<Event>, BlockOStreamWriter<Event>>> Sorter;
+
+    // value is the position in the input (VectorReader reads from the back),
+    // KeepFirst should keep the first one of every key
+    const int keys = 4000;
+    std::vector<Event> events = randomEvents(100000, keys, 11);
+    std::vector<long long> first(keys, -1);
+    for (std::size_t i = events.size(); i-- > 0;)
+    {
+        events[i].value = events.size() - 1 - i;
+        if (first[events[i].key] < 0)
+            first[events[i].key] = events[i].value;
+    }
+
+    Sorter sorter;
+    VectorReader<Event> reader(events);
+    VectorWriter<Event> writer;
+    ASSERT_TRUE(sorter.sortUnique(reader, writer, 1000));
+    ASSERT_EQ(std::size_t(keys), writer.contents().size());
+    for (int key = 0; key < keys; ++key)
+        EXPECT_EQ(first[key], writer.contents()[key].value);
+}
+
+TEST(ExternalSort, PresortedBuffers)
+{
+    typedef ExternalSorter<int, std::less<int>, StdSorter<std::less<int>>,
+                           FStreamQueue<int, OptimalStreamIO<int>::ReaderType, OptimalStreamIO<int>::WriterType>,
+                           SortStatistics> Sorter;
+
+    // VectorReader reads from the back
+    std::vector<int> sorted;
+    for (int i = 0; i < 30000; ++i)
+        sorted.push_back(i);
+    std::vector<int> ascendingInput(sorted.rbegin(), sorted.rend());
+
+    Sorter sorter;
+    VectorReader<int> reader(ascendingInput);
+    VectorWriter<int> writer;
+    ASSERT_TRUE(sorter.sort(reader, writer, 1000));
+    EXPECT_EQ(sorted, writer.contents());
+    EXPECT_EQ(std::vector<std::uint64_t>({30000}), sorter.getStatistics().buckets);
+
+    // three appended sorted segments
+    std::vector<int> segments;
+    srand(9);
+    for (int segment = 0; segment < 3; ++segment)
+    {
+        std::vector<int> part(10000);
+        for (int &x : part)
+            x = rand() % 100000;
+        std::sort(part.begin(), part.end());
+        segments.insert(segments.end(), part.begin(), part.end());
+    }
+    std::vector<int> expected = segments;
+    std::sort(expected.begin(), expected.end());
+
+    Sorter segmentsSorter;
+    VectorReader<int> segmentsReader(std::vector<int>(segments.rbegin(), segments.rend()));
+    VectorWriter<int> segmentsWriter;
+    ASSERT_TRUE(segmentsSorter.sort(segmentsReader, segmentsWriter, 1000));
+    EXPECT_EQ(expected, segmentsWriter.contents());
+    EXPECT_EQ(std::vector<std::uint64_t>({10000, 10000, 10000}), segmentsSorter.getStatistics().buckets);
+
+    // descending input: every buffer is reversed, buckets can't be joined
+    Sorter reversedSorter;
+    VectorReader<int> reversedReader(sorted);
+    VectorWriter<int> reversedWriter;
+    ASSERT_TRUE(reversedSorter.sort(reversedReader, reversedWriter, 1000));
+    EXPECT_EQ(sorted, reversedWriter.contents());
+    EXPECT_EQ(30u, reversedSorter.getStatistics().buckets.size());
+}
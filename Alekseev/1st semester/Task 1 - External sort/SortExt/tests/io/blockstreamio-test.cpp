@@ -0,0 +1,99 @@
+#include <sstream>
+#include <vector>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "src/io/blockistreamreader.h"
+#include "src/io/blockostreamwriter.h"
+
+TEST(BlockIStreamReader, EmptyInput)
+{
+    std::istringstream iss("");
+    BlockIStreamReader<int> read(iss);
+
+    int x;
+    EXPECT_FALSE(read(x));
+}
+
+TEST(BlockStreamIO, Integers)
+{
+    std::vector<int> data;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 10000; ++i)
+        data.push_back(gen());
+
+    for (std::size_t blockSize : {1, 4, 10, 4096})
+    {
+        std::stringstream ss;
+        do
+        {
+            BlockOStreamWriter<int> write(ss, blockSize);
+            for (int x : data)
+                write(x);
+        } while (false);
+
+        BlockIStreamReader<int> read(ss, blockSize);
+        int x;
+        for (int exp : data)
+        {
+            ASSERT_TRUE(read(x));
+            EXPECT_EQ(exp, x);
+        }
+        EXPECT_FALSE(read(x));
+    }
+}
+
+TEST(BlockStreamIO, Spans)
+{
+    std::vector<double> data;
+    for (int i = 0; i < 5000; ++i)
+        data.push_back(i * 0.5);
+
+    std::stringstream ss;
+    BlockOStreamWriter<double> write(ss, 1000);
+    write(data.data(), 123);
+    write(data[123]);
+    write(data.data() + 124, data.size() - 124);
+    write.flush();
+
+    std::vector<double> result(data.size() + 5);
+    BlockIStreamReader<double> read(ss, 333);
+    EXPECT_EQ(7u, read(result.data(), 7));
+    EXPECT_EQ(data.size() - 7, read(result.data() + 7, result.size() - 7));
+    result.resize(data.size());
+    EXPECT_EQ(data, result);
+}
+
+TEST(BlockOStreamWriter, FlushesStreamOnlyOnRequest)
+{
+    // counts sync calls, which std::ostream::flush makes
+    class SyncCounter: public std::stringbuf
+    {
+    public:
+        SyncCounter(): syncs(0) {}
+        int syncs;
+
+    protected:
+        int sync()
+        {
+            ++syncs;
+            return std::stringbuf::sync();
+        }
+    };
+
+    SyncCounter buffer;
+    std::ostream os(&buffer);
+    do
+    {
+        BlockOStreamWriter<int> write(os, 16);
+        for (int i = 0; i < 100; ++i)
+            write(i);
+        EXPECT_EQ(0, buffer.syncs) << "Full blocks shouldn't flush the stream";
+        write.flush();
+        EXPECT_EQ(1, buffer.syncs);
+        write(100);
+    } while (false);
+    EXPECT_EQ(2, buffer.syncs);
+    EXPECT_EQ(101 * sizeof(int), buffer.str().size());
+}
@@ -0,0 +1,176 @@
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "src/io/compressedfstreamqueue.h"
+
+namespace
+{
+struct Record
+{
+    double weight;
+    std::int32_t id;
+    char tag[4];
+
+    bool operator== (const Record &other) const
+    {
+        return weight == other.weight && id == other.id && !std::memcmp(tag, other.tag, sizeof(tag));
+    }
+};
+
+template<class Codec, typename DataT>
+void checkCodec(const std::vector<DataT> &data)
+{
+    std::vector<char> encoded;
+    Codec::encode(data.data(), data.size(), encoded);
+    std::vector<DataT> decoded(data.size());
+    ASSERT_TRUE(Codec::decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    EXPECT_EQ(data, decoded);
+
+    if (!encoded.empty())
+    {
+        encoded.pop_back();
+        EXPECT_FALSE(Codec::decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    }
+}
+}
+
+TEST(BlockCodecs, DeltaVarint)
+{
+    checkCodec<DeltaVarintCodec<int>>(std::vector<int>{});
+    checkCodec<DeltaVarintCodec<int>>(std::vector<int>{0, 1, 2, 3, 100, 100, 100000});
+    checkCodec<DeltaVarintCodec<int>>(std::vector<int>{2147483647, -2147483647 - 1, 0, -5, 2147483647});
+    checkCodec<DeltaVarintCodec<unsigned long long>>(std::vector<unsigned long long>{~0ULL, 0, ~0ULL, 1});
+    checkCodec<DeltaVarintCodec<signed char>>(std::vector<signed char>{-128, 127, 0, -1});
+
+    std::vector<int> sorted(1000);
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+        sorted[i] = 1000000 + int(i) * 3;
+    std::vector<char> encoded;
+    DeltaVarintCodec<int>::encode(sorted.data(), sorted.size(), encoded);
+    EXPECT_LE(encoded.size(), sorted.size() + 4);
+}
+
+TEST(BlockCodecs, LZBytes)
+{
+    checkCodec<LZByteCodec<char>>(std::vector<char>{});
+    checkCodec<LZByteCodec<char>>(std::vector<char>{'a', 'b', 'c'});
+    checkCodec<LZByteCodec<char>>(std::vector<char>(1000, 'z'));
+
+    std::mt19937 generator(42);
+    std::vector<Record> records(3000);
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        records[i].weight = double(generator() % 50) / 4;
+        records[i].id = std::int32_t(i / 10);
+        std::memcpy(records[i].tag, "abc", 4);
+    }
+    checkCodec<LZByteCodec<Record>>(records);
+
+    std::vector<char> encoded;
+    LZByteCodec<Record>::encode(records.data(), records.size(), encoded);
+    EXPECT_LT(encoded.size(), records.size() * sizeof(Record) / 2);
+
+    std::vector<unsigned> noise(5000);
+    for (unsigned &x : noise)
+        x = generator();
+    checkCodec<LZByteCodec<unsigned>>(noise);
+}
+
+TEST(CompressedFStreamQueue, Integers)
+{
+    CompressedFStreamQueue<int> q0, q1, q2;
+
+    int x;
+    EXPECT_FALSE(q0.pop(x));
+
+    static std::vector<int> v1 = {123, -43, 0, 32}, v2 = {0, 1, 2, 3};
+
+    for (int v : v1)
+        q1.push(v);
+
+    for (size_t i = 0; i < v1.size(); ++i)
+    {
+        ASSERT_TRUE(q1.pop(x));
+        EXPECT_EQ(v1[i], x);
+
+        q2.push(v2[i]);
+    }
+    EXPECT_FALSE(q1.pop(x));
+
+    for (int v : v2)
+    {
+        ASSERT_TRUE(q2.pop(x));
+        EXPECT_EQ(v, x);
+    }
+    EXPECT_FALSE(q2.pop(x));
+}
+
+TEST(CompressedFStreamQueue, SortedRunManyBlocks)
+{
+    CompressedFStreamQueue<long long, DeltaVarintCodec<long long>, 4096> queue;
+    const long long n = 100000;
+    std::mt19937 generator(7);
+    std::vector<long long> run;
+    long long current = -(1LL << 40);
+    for (long long i = 0; i < n; ++i)
+    {
+        current += generator() % 20;
+        run.push_back(current);
+        queue.push(current);
+    }
+
+    long long x;
+    for (long long v : run)
+    {
+        ASSERT_TRUE(queue.pop(x));
+        ASSERT_EQ(v, x);
+    }
+    EXPECT_FALSE(queue.pop(x));
+    EXPECT_LE(queue.fileSize() * 5, n * sizeof(long long)) << "Sorted run should be compressed at least 5 times";
+}
+
+TEST(CompressedFStreamQueue, FinishPushing)
+{
+    CompressedFStreamQueue<int, DeltaVarintCodec<int>, 400> queue;
+    EXPECT_EQ(0u, queue.memorySize());
+    for (int i = 0; i < 250; ++i)
+        queue.push(i);
+    EXPECT_GT(queue.memorySize(), 0u);
+
+    queue.finishPushing();
+    EXPECT_EQ(0u, queue.memorySize()) << "Partial block should be written and freed";
+    queue.push(250);
+
+    int x;
+    for (int i = 0; i <= 250; ++i)
+    {
+        ASSERT_TRUE(queue.pop(x));
+        ASSERT_EQ(i, x);
+    }
+    EXPECT_FALSE(queue.pop(x));
+}
+
+TEST(CompressedFStreamQueue, Records)
+{
+    CompressedFStreamQueue<Record, LZByteCodec<Record>, 1000> queue;
+    std::vector<Record> records(5000);
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        records[i].weight = double(i % 7);
+        records[i].id = std::int32_t(i);
+        std::memcpy(records[i].tag, "xyz", 4);
+        queue.push(records[i]);
+    }
+
+    Record x;
+    for (const Record &v : records)
+    {
+        ASSERT_TRUE(queue.pop(x));
+        ASSERT_EQ(v, x);
+    }
+    EXPECT_FALSE(queue.pop(x));
+    EXPECT_LT(queue.fileSize(), records.size() * sizeof(Record));
+}
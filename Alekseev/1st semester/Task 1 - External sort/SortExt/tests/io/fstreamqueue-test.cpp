@@ -40,6 +40,28 @@ TEST(FStreamQueue, Integers)
     EXPECT_FALSE(q2.pop(x));
 }
 
+TEST(FStreamQueue, FinishPushing)
+{
+    FStreamQueue<int, BlockIStreamReader<int>, BlockOStreamWriter<int>> queue;
+    EXPECT_EQ(0u, queue.memorySize());
+    for (int i = 0; i < 250; ++i)
+        queue.push(i);
+    EXPECT_EQ(std::size_t(BlockOStreamWriter<int>::DefaultBlockSize), queue.memorySize());
+
+    queue.finishPushing();
+    EXPECT_EQ(0u, queue.memorySize()) << "Writer block should be written and freed";
+    queue.push(250);
+
+    int x;
+    for (int i = 0; i <= 250; ++i)
+    {
+        ASSERT_TRUE(queue.pop(x));
+        ASSERT_EQ(i, x);
+    }
+    EXPECT_FALSE(queue.pop(x));
+    EXPECT_EQ(std::size_t(BlockIStreamReader<int>::DefaultBlockSize), queue.memorySize()) << "Only reader block should be kept";
+}
+
 TEST(FStreamQueue, Strings)
 {
     FStreamQueue<std::string,
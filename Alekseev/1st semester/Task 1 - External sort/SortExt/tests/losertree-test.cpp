@@ -0,0 +1,76 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/losertree.h"
+
+namespace
+{
+template<bool Stable>
+std::vector<std::pair<int, std::size_t>> mergeAll(const std::vector<std::vector<int>> &sources)
+{
+    LoserTree<int, std::less<int>, Stable> tree(sources.size());
+    std::vector<std::size_t> next(sources.size(), 0);
+    for (std::size_t i = 0; i < sources.size(); ++i)
+        if (!sources[i].empty())
+        {
+            tree.head(i) = sources[i][next[i]++];
+            tree.activate(i);
+        }
+    tree.build();
+
+    std::vector<std::pair<int, std::size_t>> merged;
+    while (!tree.isEmpty())
+    {
+        std::size_t source = tree.winner();
+        merged.emplace_back(tree.top(), source);
+        if (next[source] < sources[source].size())
+        {
+            tree.top() = sources[source][next[source]++];
+            tree.update();
+        }
+        else
+            tree.exhaust();
+    }
+    return merged;
+}
+}
+
+TEST(LoserTree, EmptySources)
+{
+    EXPECT_TRUE(mergeAll<false>({}).empty());
+    EXPECT_TRUE(mergeAll<false>({{}, {}, {}}).empty());
+}
+
+TEST(LoserTree, Integers)
+{
+    std::vector<std::vector<int>> sources = {{1, 4, 7}, {}, {2, 5, 8}, {0}, {3, 6, 9, 10}};
+    std::vector<int> merged;
+    for (auto p : mergeAll<false>(sources))
+        merged.push_back(p.first);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}), merged);
+}
+
+TEST(LoserTree, StableRandom)
+{
+    std::mt19937 gen(17);
+    for (std::size_t ways = 1; ways <= 33; ++ways)
+    {
+        std::vector<std::vector<int>> sources(ways);
+        std::vector<std::pair<int, std::size_t>> expected;
+        for (std::size_t i = 0; i < ways; ++i)
+        {
+            sources[i].resize(gen() % 40);
+            for (int &x : sources[i])
+                x = gen() % 8;
+            std::sort(sources[i].begin(), sources[i].end());
+            for (int x : sources[i])
+                expected.emplace_back(x, i);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        EXPECT_EQ(expected, mergeAll<true>(sources));
+    }
+}
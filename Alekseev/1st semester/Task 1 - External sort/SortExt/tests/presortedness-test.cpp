@@ -0,0 +1,65 @@
+#include <vector>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include "gtest/gtest.h"
+
+#include "src/presortedness.h"
+
+TEST(Presortedness, Kinds)
+{
+    std::vector<int> sorted = {1, 2, 2, 3, 7};
+    EXPECT_EQ(BufferOrder::Sorted, orderPresorted(sorted.begin(), sorted.end(), std::less<int>(), 4));
+
+    std::vector<int> reversed = {9, 5, 3, 1};
+    EXPECT_EQ(BufferOrder::Reversed, orderPresorted(reversed.begin(), reversed.end(), std::less<int>(), 4));
+    EXPECT_EQ(std::vector<int>({1, 3, 5, 9}), reversed);
+
+    std::vector<int> runs = {4, 8, 12, 1, 5, 9, 2, 6, 10};
+    EXPECT_EQ(BufferOrder::FewRuns, orderPresorted(runs.begin(), runs.end(), std::less<int>(), 4));
+    EXPECT_EQ(std::vector<int>({1, 2, 4, 5, 6, 8, 9, 10, 12}), runs);
+
+    std::vector<int> unordered = {5, 1, 4, 2, 3, 0, 6, 1, 3};
+    std::vector<int> copy = unordered;
+    EXPECT_EQ(BufferOrder::Unordered, orderPresorted(unordered.begin(), unordered.end(), std::less<int>(), 4));
+    EXPECT_EQ(copy, unordered);
+
+    std::vector<int> descendingPrefix = {6, 5, 4, 3, 2, 7};
+    std::vector<int> prefixCopy = descendingPrefix;
+    EXPECT_EQ(BufferOrder::Unordered,
+              orderPresorted(descendingPrefix.begin(), descendingPrefix.end(), std::less<int>(), 4));
+    EXPECT_EQ(prefixCopy, descendingPrefix);
+    EXPECT_EQ(BufferOrder::FewRuns,
+              orderPresorted(descendingPrefix.begin(), descendingPrefix.end(), std::less<int>(), 5));
+    EXPECT_EQ(std::vector<int>({2, 3, 4, 5, 6, 7}), descendingPrefix);
+
+    std::vector<int> empty, single = {1};
+    EXPECT_EQ(BufferOrder::Sorted, orderPresorted(empty.begin(), empty.end(), std::less<int>(), 1));
+    EXPECT_EQ(BufferOrder::Sorted, orderPresorted(single.begin(), single.end(), std::less<int>(), 1));
+}
+
+TEST(Presortedness, StableRuns)
+{
+    // key and position in the input
+    typedef std::pair<int, int> Item;
+    auto byKey = [](const Item &a, const Item &b) { return a.first < b.first; };
+    srand(5);
+
+    std::vector<Item> items;
+    for (int run = 0; run < 5; ++run)
+    {
+        std::vector<int> keys(100);
+        for (int &key : keys)
+            key = rand() % 30;
+        std::sort(keys.begin(), keys.end());
+        for (int key : keys)
+            items.push_back(Item(key, items.size()));
+    }
+    std::vector<Item> expected = items;
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+
+    EXPECT_EQ(BufferOrder::FewRuns, orderPresorted(items.begin(), items.end(), byKey, 8));
+    EXPECT_EQ(expected, items);
+}
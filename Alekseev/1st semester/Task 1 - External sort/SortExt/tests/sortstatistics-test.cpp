@@ -0,0 +1,52 @@
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+
+#include "src/sortstatistics.h"
+
+TEST(SortStatistics, Counters)
+{
+    static_assert(std::is_empty<NoSortStatistics>::value, "NoSortStatistics should not take memory");
+
+    SortStatistics statistics;
+    statistics.read(SortStatistics::Reading, 5);
+    statistics.read(SortStatistics::Reading, std::string("abc"));
+    statistics.written(SortStatistics::OutputWriting, 1.5);
+    statistics.bucket(3);
+    statistics.buffer(100);
+    statistics.buffer(10);
+
+    CountingComparator<std::less<int>> compare = statistics.comparator<std::less<int>>();
+    EXPECT_TRUE(compare(1, 2));
+    EXPECT_FALSE(compare(1, 1));
+
+    EXPECT_EQ(2u, statistics.phases[SortStatistics::Reading].recordsRead);
+    EXPECT_EQ(sizeof(int) + 3, statistics.phases[SortStatistics::Reading].bytesRead);
+    EXPECT_EQ(sizeof(double), statistics.phases[SortStatistics::OutputWriting].bytesWritten);
+    EXPECT_EQ(std::vector<std::uint64_t>({3}), statistics.buckets);
+    EXPECT_EQ(2u, statistics.comparisons);
+    EXPECT_EQ(100u, statistics.peakBufferBytes);
+
+    statistics.reset();
+    EXPECT_EQ(0u, statistics.phases[SortStatistics::Reading].recordsRead);
+    EXPECT_TRUE(statistics.buckets.empty());
+}
+
+TEST(SortStatistics, Json)
+{
+    SortStatistics statistics;
+    statistics.bucket(4);
+    statistics.bucket(2);
+    statistics.written(SortStatistics::SpillWriting, 7);
+
+    std::string json = statistics.toJson();
+    EXPECT_EQ('{', json.front());
+    EXPECT_EQ('}', json.back());
+    EXPECT_NE(std::string::npos, json.find("\"buckets\": [4, 2]"));
+    EXPECT_NE(std::string::npos, json.find("\"spillWriting\": {\"recordsRead\": 0, \"bytesRead\": 0, "
+                                           "\"recordsWritten\": 1, \"bytesWritten\": 4"));
+    EXPECT_NE(std::string::npos, json.find("\"comparisons\": 0"));
+}
@@ -4,7 +4,13 @@ SOURCES += \
     $$PWD/io/ostreamwriter-test.cpp \
     $$PWD/io/rawistreamreader-test.cpp \
     $$PWD/io/rawostreamwriter-test.cpp \
+    $$PWD/io/blockstreamio-test.cpp \
+    $$PWD/io/compressedfstreamqueue-test.cpp \
     $$PWD/complexdata.cpp \
+    $$PWD/losertree-test.cpp \
+    $$PWD/sortstatistics-test.cpp \
+    $$PWD/topkthreshold-test.cpp \
+    $$PWD/presortedness-test.cpp \
     tests/externalsort-test.cpp
 
 HEADERS += \
@@ -0,0 +1,50 @@
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/topkthreshold.h"
+
+TEST(TopKThreshold, ManualBuckets)
+{
+    TopKThreshold<int> threshold(4, 4);
+    EXPECT_FALSE(threshold.isKnown());
+    EXPECT_FALSE(threshold.rejects(100));
+
+    int first[] = {1, 5, 7};
+    threshold.addBucket(first, 3);
+    EXPECT_FALSE(threshold.isKnown());
+
+    int second[] = {2, 3, 9, 10, 11};
+    threshold.addBucket(second, 5);
+    ASSERT_TRUE(threshold.isKnown());
+    EXPECT_EQ(5, threshold.value());
+    EXPECT_FALSE(threshold.rejects(5));
+    EXPECT_TRUE(threshold.rejects(6));
+}
+
+TEST(TopKThreshold, RandomBuckets)
+{
+    srand(11);
+    const std::size_t k = 300;
+    TopKThreshold<int> threshold(k, 16);
+    std::vector<int> all;
+    for (int bucket = 0; bucket < 20; ++bucket)
+    {
+        std::vector<int> data(200 + rand() % 300);
+        for (int &x : data)
+            x = rand() % 10000;
+        std::sort(data.begin(), data.end());
+        all.insert(all.end(), data.begin(), data.end());
+        threshold.addBucket(data.data(), data.size());
+
+        if (all.size() >= k)
+        {
+            ASSERT_TRUE(threshold.isKnown());
+            std::vector<int> sorted = all;
+            std::nth_element(sorted.begin(), sorted.begin() + k - 1, sorted.end());
+            EXPECT_FALSE(threshold.rejects(sorted[k - 1]));
+        }
+    }
+}
@@ -3,6 +3,8 @@ INCLUDEPATH += $$PWD
 QMAKE_CXXFLAGS += -std=gnu++0x
 
 HEADERS += \
-    ../src/leftistheap.h
+    ../src/leftistheap.h \
+    ../src/daryheap.h \
+    ../src/radixheap.h
 
 SOURCES +=
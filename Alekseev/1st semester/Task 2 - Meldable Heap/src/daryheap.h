@@ -0,0 +1,242 @@
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+template<class T> class Asserted;
+
+// Implicit d-ary heap in one contiguous array, for workloads that never meld.
+// Children of item i are items i*Arity+1 ... i*Arity+Arity. Every item keeps its handle and every
+// handle keeps position of its item, so Index works as in LeftistHeap: set, popAt and takeAt
+// cost O(Arity * log_Arity n), decreaseKey costs O(log_Arity n).
+// Index is bound to the heap object it was taken from and is valid until its key is removed,
+// handles of removed keys are reused.
+template<typename KeyT, class CompareT = std::less<KeyT>, std::size_t Arity = 4>
+class DAryHeap
+{
+    static_assert(Arity >= 2, "arity of heap must be at least 2");
+
+public:
+    typedef KeyT Key;
+    typedef CompareT Compare;
+
+    class Index
+    {
+    public:
+        Index(): _heap(nullptr), _handle(0) {}
+
+        const Key& operator*() const
+        {
+            return _heap->items[_heap->positions[_handle]].key;
+        }
+        const Key& operator->() const
+        {
+            return **this;
+        }
+
+    private:
+        friend class DAryHeap<Key, Compare, Arity>;
+
+        Index(const DAryHeap<Key, Compare, Arity> *heap, std::size_t handle): _heap(heap), _handle(handle) {}
+        const DAryHeap<Key, Compare, Arity> *_heap;
+        std::size_t _handle;
+    };
+
+    DAryHeap():                                compare(Compare()) {}
+    explicit DAryHeap(const Compare &compare): compare(compare) {}
+    explicit DAryHeap(Compare &&compare):      compare(std::move(compare)) {}
+
+    bool isEmpty() const
+    {
+        return items.empty();
+    }
+
+    const Key &top() const
+    {
+        return items.front().key;
+    }
+    Index topIndex() const
+    {
+        return Index(this, items.front().handle);
+    }
+
+    Index push(const Key &key)
+    {
+        return insert(Key(key));
+    }
+
+    template<typename... Args>
+    Index emplace(const Args&... args)
+    {
+        return insert(Key(args...));
+    }
+
+    // changes key in any direction
+    Index set(Index at, const Key &key)
+    {
+        std::size_t position = positions[at._handle];
+        Item item(std::move(items[position]));
+        bool up = compare(key, item.key);
+        item.key = key;
+        if (up)
+            siftUp(position, std::move(item));
+        else
+            siftDown(position, std::move(item));
+        return at;
+    }
+
+    // the same as set, but new key must not be greater than the old one
+    Index decreaseKey(Index at, const Key &key)
+    {
+        std::size_t position = positions[at._handle];
+        assert(!compare(items[position].key, key));
+        Item item(std::move(items[position]));
+        item.key = key;
+        siftUp(position, std::move(item));
+        return at;
+    }
+
+    void pop()
+    {
+        remove(0);
+    }
+    void popAt(Index at)
+    {
+        remove(positions[at._handle]);
+    }
+
+    Key takeTop()
+    {
+        Key ret = std::move(items.front().key);
+        remove(0);
+        return ret;
+    }
+    Key takeAt(Index at)
+    {
+        std::size_t position = positions[at._handle];
+        Key ret = std::move(items[position].key);
+        remove(position);
+        return ret;
+    }
+
+    void swap(DAryHeap<Key, Compare, Arity> &that)
+    {
+        std::swap(items, that.items);
+        std::swap(positions, that.positions);
+        std::swap(freeHandles, that.freeHandles);
+        std::swap(compare, that.compare);
+    }
+
+    void reserve(std::size_t count)
+    {
+        items.reserve(count);
+        positions.reserve(count);
+    }
+
+    Compare * comparator()
+    {
+        return &compare;
+    }
+
+    std::size_t size() const
+    {
+        return items.size();
+    }
+
+private:
+    friend class DAryHeap<Key, Compare, Arity>::Index;
+    friend class Asserted<DAryHeap<Key, Compare, Arity>>;
+
+    struct Item
+    {
+        Item(Key &&key, std::size_t handle): key(std::move(key)), handle(handle) {}
+
+        Key key;
+        std::size_t handle;
+    };
+
+    Index insert(Key &&key)
+    {
+        std::size_t handle;
+        if (freeHandles.empty())
+        {
+            handle = positions.size();
+            positions.push_back(0);
+        }
+        else
+        {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        items.emplace_back(std::move(key), handle);
+        Item item(std::move(items.back()));
+        siftUp(items.size() - 1, std::move(item));
+        return Index(this, handle);
+    }
+
+    void remove(std::size_t position)
+    {
+        assert(position < items.size());
+        freeHandles.push_back(items[position].handle);
+        Item last(std::move(items.back()));
+        items.pop_back();
+        if (position == items.size())
+            return;
+        if (position > 0 && compare(last.key, items[(position - 1) / Arity].key))
+            siftUp(position, std::move(last));
+        else
+            siftDown(position, std::move(last));
+    }
+
+    void place(std::size_t position, Item &&item)
+    {
+        positions[item.handle] = position;
+        items[position] = std::move(item);
+    }
+
+    // puts item to the hole at position and moves the hole up while parents are greater
+    void siftUp(std::size_t position, Item &&item)
+    {
+        while (position > 0)
+        {
+            std::size_t parent = (position - 1) / Arity;
+            if (!compare(item.key, items[parent].key))
+                break;
+            place(position, std::move(items[parent]));
+            position = parent;
+        }
+        place(position, std::move(item));
+    }
+
+    // puts item to the hole at position and moves the hole down while the least child is less
+    void siftDown(std::size_t position, Item &&item)
+    {
+        std::size_t count = items.size();
+        while (true)
+        {
+            std::size_t first = position * Arity + 1;
+            if (first >= count)
+                break;
+            std::size_t last = std::min(first + Arity, count), least = first;
+            for (std::size_t child = first + 1; child < last; ++child)
+                if (compare(items[child].key, items[least].key))
+                    least = child;
+            if (!compare(items[least].key, item.key))
+                break;
+            place(position, std::move(items[least]));
+            position = least;
+        }
+        place(position, std::move(item));
+    }
+
+    std::vector<Item> items;
+    std::vector<std::size_t> positions;
+    std::vector<std::size_t> freeHandles;
+    Compare compare;
+};
+
+#endif // DARYHEAP_H
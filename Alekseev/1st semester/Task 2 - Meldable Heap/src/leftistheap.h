@@ -1,6 +1,8 @@
 #ifndef LEFTISTHEAP_H
 #define LEFTISTHEAP_H
 
+#include <vector>
+#include <algorithm>
 #include <functional>
 
 template<class T> class Asserted;
@@ -44,6 +46,35 @@ public:
         std::swap(root, that.root);
     }
 
+    // builds heap of keys from [begin, end) in O(n): nodes are linked as a complete binary tree,
+    // which is leftist, and keys are sifted down from the last inner node to the root
+    template<class Iterator>
+    LeftistHeap(Iterator begin, Iterator end, const Compare &compare = Compare()):
+        heapSize(0), root(nullptr), compare(compare)
+    {
+        std::vector<NodePtr> nodes;
+        for (; begin != end; ++begin)
+            nodes.push_back(new Node(*begin));
+        for (std::size_t i = nodes.size(); i-- > 0; )
+        {
+            NodePtr node = nodes[i];
+            if (2 * i + 1 < nodes.size())
+            {
+                node->leftSon = nodes[2 * i + 1];
+                node->leftSon->parent = node;
+            }
+            if (2 * i + 2 < nodes.size())
+            {
+                node->rightSon = nodes[2 * i + 2];
+                node->rightSon->parent = node;
+            }
+            node->minHeight = minHeight(node->rightSon) + 1;
+            siftDown(node);
+        }
+        heapSize = nodes.size();
+        root = nodes.empty() ? nullptr : nodes.front();
+    }
+
     ~LeftistHeap()
     {
         purgeTree(root);
@@ -119,10 +150,60 @@ public:
     void absorb(LeftistHeap<Key, Compare> &that)
     {
         merge(root, root, that.root, nullptr);
+        heapSize += that.heapSize;
         that.heapSize = 0;
         that.root = nullptr;
     }
 
+    // melds all heaps in pairs, so no heap takes part in more than log(count) merges
+    void absorbAll(const std::vector<std::reference_wrapper<LeftistHeap<Key, Compare>>> &those)
+    {
+        std::vector<NodePtr> heaps(1, root);
+        for (LeftistHeap<Key, Compare> &that : those)
+        {
+            if (&that == this)
+                continue;
+            heaps.push_back(that.root);
+            heapSize += that.heapSize;
+            that.heapSize = 0;
+            that.root = nullptr;
+        }
+        root = mergeAll(heaps);
+    }
+
+    // takes k smallest keys (all if there are less) in sorted order in O(k log k + k log n).
+    // Only nodes of these keys are touched, the rest of the heap stays as subtrees which are melded in pairs,
+    // so Indices of the remaining keys are still valid
+    std::vector<Key> extractK(std::size_t k)
+    {
+        std::vector<Key> ret;
+        std::vector<NodePtr> frontier;
+        auto greater = [this](NodePtr a, NodePtr b) { return compare(b->key, a->key); };
+        if (root && k)
+            frontier.push_back(root);
+        while (!frontier.empty() && ret.size() < k)
+        {
+            std::pop_heap(frontier.begin(), frontier.end(), greater);
+            NodePtr node = frontier.back();
+            frontier.pop_back();
+            for (NodePtr son : {node->leftSon, node->rightSon})
+                if (son)
+                {
+                    son->parent = nullptr;
+                    frontier.push_back(son);
+                    std::push_heap(frontier.begin(), frontier.end(), greater);
+                }
+            ret.push_back(std::move(node->key));
+            delete node;
+        }
+        if (!ret.empty())
+        {
+            heapSize -= ret.size();
+            root = mergeAll(frontier);
+        }
+        return ret;
+    }
+
     Compare * comparator()
     {
         return &compare;
@@ -180,20 +261,62 @@ private:
         }
     }
 
+    // merges right spines of a and b top-down, then fixes heights bottom-up, no recursion
     void merge(NodePtr &dest, NodePtr a, NodePtr b, NodePtr parent)
     {
-        if (!a || !b)
-            dest = a ? a : b;
-        else
+        NodePtr top = parent;
+        NodePtr *link = &dest;
+        while (a && b)
         {
             if (compare(b->key, a->key))
                 std::swap(a, b);
-            merge(a->rightSon, a->rightSon, b, a);
-            dest = a;
+            *link = a;
+            a->parent = parent;
+            parent = a;
+            link = &a->rightSon;
+            a = a->rightSon;
         }
-        if (dest)
-            dest->parent = parent;
-        updateMinHeight(dest);
+        *link = a ? a : b;
+        if (*link)
+            (*link)->parent = parent;
+        updateMinHeight(*link);
+        for (NodePtr node = parent; node != top; node = node->parent)
+            updateMinHeight(node);
+    }
+
+    // moves key down swapping it with the least son, only for building as keys leave their nodes
+    void siftDown(NodePtr node)
+    {
+        while (true)
+        {
+            NodePtr least = node;
+            if (node->leftSon && compare(node->leftSon->key, least->key))
+                least = node->leftSon;
+            if (node->rightSon && compare(node->rightSon->key, least->key))
+                least = node->rightSon;
+            if (least == node)
+                return;
+            std::swap(node->key, least->key);
+            node = least;
+        }
+    }
+
+    // melds heaps in rounds, merging neighbours in each round
+    NodePtr mergeAll(std::vector<NodePtr> &heaps)
+    {
+        heaps.erase(std::remove(heaps.begin(), heaps.end(), nullptr), heaps.end());
+        if (heaps.empty())
+            return nullptr;
+        while (heaps.size() > 1)
+        {
+            std::size_t half = heaps.size() / 2;
+            for (std::size_t i = 0; i < half; ++i)
+                merge(heaps[i], heaps[2 * i], heaps[2 * i + 1], nullptr);
+            if (heaps.size() % 2)
+                heaps[half++] = heaps.back();
+            heaps.resize(half);
+        }
+        return heaps.front();
     }
 
     void remove(NodePtr node)
@@ -215,14 +338,27 @@ private:
             updateUp(node->parent);
     }
 
+    // left spine of leftist heap may be as long as the heap, so instead of recursion
+    // left sons are rotated to the right until root has no left son, then root is deleted
     void purgeTree(NodePtr root)
     {
-        if (!root)
-            return;
-        purgeTree(root->leftSon);
-        purgeTree(root->rightSon);
-        delete root;
-        --heapSize;
+        while (root)
+        {
+            NodePtr son = root->leftSon;
+            if (son)
+            {
+                root->leftSon = son->rightSon;
+                son->rightSon = root;
+                root = son;
+            }
+            else
+            {
+                son = root->rightSon;
+                delete root;
+                --heapSize;
+                root = son;
+            }
+        }
     }
 
     std::size_t heapSize;
@@ -0,0 +1,330 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+// Maps key of RadixHeap to unsigned radix preserving order of keys.
+// Signed integers are shifted by 2^63, pairs are ordered by their first element only.
+// Specialize it for other keys.
+template<typename Key, class Enable = void>
+struct RadixKey;
+
+template<typename Key>
+struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value>::type>
+{
+    std::uint64_t operator()(Key key) const
+    {
+        return std::is_signed<Key>::value
+                ? std::uint64_t(std::int64_t(key)) ^ (std::uint64_t(1) << 63)
+                : std::uint64_t(key);
+    }
+};
+
+template<typename A, typename B>
+struct RadixKey<std::pair<A, B>>
+{
+    std::uint64_t operator()(const std::pair<A, B> &key) const
+    {
+        return RadixKey<A>()(key.first);
+    }
+};
+
+// Radix heap for monotone workloads such as Dijkstra: pushed key must not be less than the last
+// taken one. Bucket 0 keeps keys with radix equal to radix of the last taken key, bucket i > 0 keeps
+// keys whose highest bit differing from it is bit i-1. Taking top from empty bucket 0 moves the least
+// nonempty bucket to lower ones, every key moves at most 64 times, so push is O(1) and takeTop is
+// O(log C) amortized, C is the maximal difference of radixes.
+// top and topIndex don't move keys: they find the least key of the least nonempty bucket and remember
+// it until it is removed or a less key is pushed, so a peek doesn't raise the bound of pushed keys.
+// Index works as in LeftistHeap, set and popAt leave a stale entry in its bucket which is dropped
+// when met (lazy deletion). Keys with equal radix are taken in arbitrary order.
+template<typename KeyT, class RadixT = RadixKey<KeyT> >
+class RadixHeap
+{
+public:
+    typedef KeyT Key;
+    typedef RadixT Radix;
+
+    // compares radixes, so heap sort with it gives the order of takeTop
+    class Compare
+    {
+    public:
+        explicit Compare(const Radix &radix = Radix()): radix(radix) {}
+
+        bool operator()(const Key &a, const Key &b) const
+        {
+            return radix(a) < radix(b);
+        }
+
+    private:
+        Radix radix;
+    };
+
+    class Index
+    {
+    public:
+        Index(): _heap(nullptr), _handle(0) {}
+
+        const Key& operator*() const
+        {
+            return _heap->slots[_handle].key;
+        }
+        const Key& operator->() const
+        {
+            return **this;
+        }
+
+    private:
+        friend class RadixHeap<Key, Radix>;
+
+        Index(const RadixHeap<Key, Radix> *heap, std::size_t handle): _heap(heap), _handle(handle) {}
+        const RadixHeap<Key, Radix> *_heap;
+        std::size_t _handle;
+    };
+
+    RadixHeap():                            heapSize(0), last(0), peeked(false), peekedTop(), radix(Radix()),
+                                            compare(radix) {}
+    explicit RadixHeap(const Radix &radix): heapSize(0), last(0), peeked(false), peekedTop(), radix(radix),
+                                            compare(radix) {}
+
+    bool isEmpty() const
+    {
+        return !heapSize;
+    }
+
+    // not const: drops stale entries and remembers the top
+    const Key &top()
+    {
+        return slots[peek().handle].key;
+    }
+    Index topIndex()
+    {
+        return Index(this, peek().handle);
+    }
+
+    Index push(const Key &key)
+    {
+        return insert(Key(key));
+    }
+
+    template<typename... Args>
+    Index emplace(const Args&... args)
+    {
+        return insert(Key(args...));
+    }
+
+    // new key must not be less than the last taken one
+    Index set(Index at, const Key &key)
+    {
+        Slot &slot = slots[at._handle];
+        ++slot.stamp; // entry with old key becomes stale
+        slot.key = key;
+        put(at._handle);
+        return at;
+    }
+
+    void pop()
+    {
+        release(take().handle);
+    }
+    void popAt(Index at)
+    {
+        release(at._handle);
+    }
+
+    Key takeTop()
+    {
+        std::size_t handle = take().handle;
+        Key ret = std::move(slots[handle].key);
+        release(handle);
+        return ret;
+    }
+    Key takeAt(Index at)
+    {
+        Key ret = std::move(slots[at._handle].key);
+        release(at._handle);
+        return ret;
+    }
+
+    void swap(RadixHeap<Key, Radix> &that)
+    {
+        for (std::size_t i = 0; i < BucketsCount; ++i)
+            std::swap(buckets[i], that.buckets[i]);
+        std::swap(slots, that.slots);
+        std::swap(freeHandles, that.freeHandles);
+        std::swap(heapSize, that.heapSize);
+        std::swap(last, that.last);
+        std::swap(peeked, that.peeked);
+        std::swap(peekedTop, that.peekedTop);
+        std::swap(radix, that.radix);
+        std::swap(compare, that.compare);
+    }
+
+    Compare * comparator()
+    {
+        return &compare;
+    }
+
+    std::size_t size() const
+    {
+        return heapSize;
+    }
+
+private:
+    static const std::size_t BucketsCount = std::numeric_limits<std::uint64_t>::digits + 1;
+
+    friend class RadixHeap<Key, Radix>::Index;
+
+    struct Slot
+    {
+        explicit Slot(Key &&key): key(std::move(key)), stamp(0) {}
+
+        Key key;
+        std::size_t stamp;
+    };
+
+    struct Entry
+    {
+        std::uint64_t radix;
+        std::size_t handle, stamp;
+    };
+
+    bool isAlive(const Entry &entry) const
+    {
+        return slots[entry.handle].stamp == entry.stamp;
+    }
+
+    std::size_t bucketOf(std::uint64_t value) const
+    {
+        return value == last ? 0 : std::numeric_limits<std::uint64_t>::digits - __builtin_clzll(value ^ last);
+    }
+
+    Index insert(Key &&key)
+    {
+        std::size_t handle;
+        if (freeHandles.empty())
+        {
+            handle = slots.size();
+            slots.emplace_back(std::move(key));
+        }
+        else
+        {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            slots[handle].key = std::move(key);
+        }
+        put(handle);
+        ++heapSize;
+        return Index(this, handle);
+    }
+
+    void put(std::size_t handle)
+    {
+        Entry entry = {radix(slots[handle].key), handle, slots[handle].stamp};
+        assert(entry.radix >= last);
+        buckets[bucketOf(entry.radix)].push_back(entry);
+        if (peeked && entry.radix < peekedTop.radix)
+            peekedTop = entry;
+    }
+
+    void release(std::size_t handle)
+    {
+        ++slots[handle].stamp;
+        freeHandles.push_back(handle);
+        --heapSize;
+    }
+
+    // drops stale entries from the end of bucket 0, returns true if it has a live one
+    bool dropStale()
+    {
+        std::vector<Entry> &first = buckets[0];
+        while (!first.empty() && !isAlive(first.back()))
+            first.pop_back();
+        return !first.empty();
+    }
+
+    // returns the top entry without moving entries between buckets and without changing last
+    const Entry &peek()
+    {
+        assert(heapSize);
+        if (dropStale())
+            return buckets[0].back();
+        if (peeked && isAlive(peekedTop))
+            return peekedTop;
+
+        peeked = false;
+        for (std::size_t i = 1; !peeked; ++i)
+        {
+            for (const Entry &entry : buckets[i])
+                if (isAlive(entry) && (!peeked || entry.radix < peekedTop.radix))
+                {
+                    peekedTop = entry;
+                    peeked = true;
+                }
+            if (!peeked)
+                buckets[i].clear();
+        }
+        return peekedTop;
+    }
+
+    // makes the top entry the last one of bucket 0 and returns it
+    const Entry &pull()
+    {
+        assert(heapSize);
+        std::vector<Entry> &first = buckets[0];
+        while (true)
+        {
+            if (dropStale())
+                return first.back();
+
+            std::size_t i = 1;
+            while (buckets[i].empty())
+                ++i;
+            std::vector<Entry> &bucket = buckets[i];
+            std::uint64_t least = std::numeric_limits<std::uint64_t>::max();
+            bool found = false;
+            for (const Entry &entry : bucket)
+                if (isAlive(entry) && entry.radix <= least)
+                {
+                    least = entry.radix;
+                    found = true;
+                }
+            if (found)
+            {
+                last = least;
+                peeked = false;
+                for (const Entry &entry : bucket)
+                    if (isAlive(entry))
+                        buckets[bucketOf(entry.radix)].push_back(entry); // always to a lower bucket
+            }
+            bucket.clear();
+        }
+    }
+
+    // takes the entry returned by peek, so top, topIndex and takeTop agree on equal keys;
+    // caller must release it, the entry left in bucket 0 becomes stale then
+    Entry take()
+    {
+        Entry ret = peek();
+        if (pull().handle == ret.handle)
+            buckets[0].pop_back();
+        return ret;
+    }
+
+    std::vector<Entry> buckets[BucketsCount];
+    std::vector<Slot> slots;
+    std::vector<std::size_t> freeHandles;
+    std::size_t heapSize;
+    std::uint64_t last;
+    bool peeked;
+    Entry peekedTop;
+    Radix radix;
+    Compare compare;
+};
+
+#endif // RADIXHEAP_H
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+
+#include "daryheap.h"
+#include "leftistheap.h"
+#include "testutils.h"
+#include "dijkstra.h"
+#include "sort.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+TEST(DAryHeap, SortSequence)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        std::vector<int> seq;
+
+        std::mt19937 gen(i);
+        seq.resize(300 + std::abs((int)gen()) % 200);
+        for (size_t i = 0; i < seq.size(); ++i)
+            seq[i] = gen() % 100;
+
+        HeapSortChecker<Asserted<DAryHeap<int>>> checker;
+        checker.check(seq);
+        HeapSortChecker<Asserted<DAryHeap<int, std::greater<int>, 2>>> binaryChecker;
+        binaryChecker.check(seq);
+        HeapSortChecker<Asserted<DAryHeap<int, std::less<int>, 7>>> oddChecker;
+        oddChecker.check(seq);
+    }
+}
+
+TEST(DAryHeap, IndicesAfterRemovals)
+{
+    std::mt19937 gen(42);
+    Asserted<DAryHeap<int>> heap;
+    std::vector<DAryHeap<int>::Index> ids;
+    for (int i = 0; i < 3000; ++i)
+    {
+        int action = gen() % 4;
+        if (action == 0 || ids.empty())
+            ids.push_back(heap.push(gen() % 1000));
+        else
+        {
+            std::size_t at = gen() % ids.size();
+            if (action == 1)
+            {
+                int key = *ids[at];
+                ASSERT_EQ(key, heap.takeAt(ids[at]));
+                ids.erase(ids.begin() + at);
+            }
+            else
+                heap.set(ids[at], gen() % 1000);
+        }
+    }
+    std::vector<int> expected;
+    for (DAryHeap<int>::Index id : ids)
+        expected.push_back(*id);
+    std::sort(expected.begin(), expected.end());
+    for (int key : expected)
+        ASSERT_EQ(key, heap.takeTop());
+    ASSERT_TRUE(heap.isEmpty());
+}
+
+TEST(DAryHeap, DecreaseKeyAndTopIndex)
+{
+    DAryHeap<std::pair<long long, int>> heap;
+    std::vector<DAryHeap<std::pair<long long, int>>::Index> ids;
+    for (int i = 0; i < 100; ++i)
+        ids.push_back(heap.emplace(1000 + i, i));
+    for (int i = 0; i < 100; i += 3)
+    {
+        heap.decreaseKey(ids[i], std::make_pair(-i, i));
+        ASSERT_EQ(i, heap.top().second);
+        ASSERT_EQ(i, (*heap.topIndex()).second);
+    }
+    heap.popAt(ids[0]);
+    ASSERT_EQ(99u, heap.size());
+    long long previous = -1000;
+    while (!heap.isEmpty())
+    {
+        long long key = heap.takeTop().first;
+        ASSERT_LE(previous, key);
+        previous = key;
+    }
+}
+
+TEST(DAryHeap, DijkstraMatchesLeftistHeap)
+{
+    std::vector<std::vector<int>> cases
+    {
+        {10, 20, 20},
+        {100, 2000, 200}
+    };
+    for (int i = 0; i < 200; ++i)
+    {
+        auto param = cases[i%cases.size()];
+        auto testcase = RandomGraphGenerator::gen(i, param[0], param[1], param[2]);
+
+        typedef std::pair<long long, int> Pair;
+
+        Dijkstra d(testcase);
+        std::vector<ll> expected = d.solve<LeftistHeap<Pair>>(0);
+        ASSERT_EQ(expected, d.solve<Asserted<DAryHeap<Pair>>>(0));
+        typedef DAryHeap<Pair, std::less<Pair>, 2> BinaryHeap;
+        ASSERT_EQ(expected, d.solve<BinaryHeap>(0));
+    }
+}
+
+TEST(DAryHeap, DijkstraLargeGraph)
+{
+    typedef std::pair<long long, int> Pair;
+
+    auto testcase = RandomGraphGenerator::gen(2014, 200000, 1000000, 1000000000);
+    Dijkstra d(testcase);
+    ASSERT_EQ(d.solve<LeftistHeap<Pair>>(0), d.solve<DAryHeap<Pair>>(0));
+}
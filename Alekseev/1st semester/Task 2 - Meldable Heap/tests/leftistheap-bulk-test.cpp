@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include "leftistheap.h"
+#include "testutils.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+
+namespace
+{
+std::vector<int> randomSequence(int seed, std::size_t size, int maxValue)
+{
+    std::mt19937 gen(seed);
+    std::vector<int> ret(size);
+    for (int &x : ret)
+        x = std::abs((int)gen()) % maxValue;
+    return ret;
+}
+}
+
+TEST(Bulk, RangeConstructor)
+{
+    for (std::size_t size : {0, 1, 2, 3, 7, 8, 100, 1000, 1025})
+    {
+        std::vector<int> seq = randomSequence(size, size, 50);
+        Asserted<LeftistHeap<int>> heap(seq.begin(), seq.end());
+        std::sort(seq.begin(), seq.end());
+        for (int expected : seq)
+            ASSERT_EQ(expected, heap.takeTop());
+        ASSERT_TRUE(heap.isEmpty());
+    }
+
+    std::vector<int> seq = randomSequence(1, 1000, 1000000);
+    Asserted<LeftistHeap<int, std::greater<int>>> heap(seq.begin(), seq.end());
+    ASSERT_EQ(*std::max_element(seq.begin(), seq.end()), heap.takeTop());
+}
+
+TEST(Bulk, AbsorbAll)
+{
+    std::vector<Asserted<LeftistHeap<int>>> heaps(17);
+    std::vector<Asserted<LeftistHeap<int>>*> those;
+    for (std::size_t i = 0; i < heaps.size(); ++i)
+    {
+        for (int x : randomSequence(i, i * i, 1000))
+            heaps[i].push(x);
+        those.push_back(&heaps[i]);
+    }
+    those.push_back(&heaps[0]); // absorbing itself is ignored
+    heaps[0].absorbAll(those);
+
+    heaps[1].absorbAll({});
+    heaps[1].absorbAll({&heaps[2], &heaps[0]});
+    ASSERT_EQ(0u, heaps[0].size());
+
+    int previous = -1;
+    while (!heaps[1].isEmpty())
+    {
+        int key = heaps[1].takeTop();
+        ASSERT_LE(previous, key);
+        previous = key;
+    }
+}
+
+TEST(Bulk, ExtractK)
+{
+    std::vector<int> seq = randomSequence(3, 3000, 500);
+    Asserted<LeftistHeap<int>> heap(seq.begin(), seq.end());
+    std::sort(seq.begin(), seq.end());
+
+    ASSERT_TRUE(heap.extractK(0).empty());
+    std::size_t taken = 0;
+    for (std::size_t k : {1, 2, 10, 100, 1000, 5000})
+    {
+        std::vector<int> ret = heap.extractK(k);
+        ASSERT_TRUE(std::equal(ret.begin(), ret.end(), seq.begin() + taken));
+        taken += ret.size();
+        heap.push(seq.back() + 1);
+        seq.push_back(seq.back() + 1);
+    }
+    ASSERT_EQ(1u, heap.size());
+    ASSERT_EQ(seq.back(), heap.takeTop());
+}
+
+TEST(Bulk, RangeConstructorMatchesPushes)
+{
+    std::vector<int> seq = randomSequence(4, 1000000, 1000000000);
+
+    LeftistHeap<int> pushed;
+    for (int x : seq)
+        pushed.push(x);
+    LeftistHeap<int> built(seq.begin(), seq.end());
+
+    ASSERT_EQ(pushed.size(), built.size());
+    EXPECT_EQ(pushed.extractK(1000), built.extractK(1000));
+}
+
+TEST(Bulk, LongLeftSpine)
+{
+    // every pushed key becomes the root and the previous heap its left son,
+    // so recursive teardown would go as deep as the heap is big
+    std::unique_ptr<LeftistHeap<int>> heap(new LeftistHeap<int>());
+    for (int i = 3000000; i > 0; --i)
+        heap->push(i);
+    LeftistHeap<int> other;
+    for (int i = 0; i < 1000; ++i)
+        other.push(3000000 + i);
+    heap->absorb(other);
+    ASSERT_EQ(1, heap->takeTop());
+    ASSERT_EQ(2, heap->takeTop());
+    heap.reset();
+}
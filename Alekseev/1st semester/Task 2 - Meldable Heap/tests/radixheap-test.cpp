@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include "radixheap.h"
+#include "leftistheap.h"
+#include "dijkstra.h"
+#include "sort.h"
+
+#include <set>
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
+
+
+TEST(RadixHeap, SortSequence)
+{
+    for (int i = 0; i < 20; ++i)
+    {
+        std::vector<int> seq;
+
+        std::mt19937 gen(i);
+        seq.resize(10000 + std::abs((int)gen()) % 500);
+        for (size_t i = 0; i < seq.size(); ++i)
+            seq[i] = gen();
+
+        HeapSortChecker<RadixHeap<int>> checker;
+        checker.check(seq);
+    }
+    HeapSortChecker<RadixHeap<long long>> extremes;
+    extremes.check({std::numeric_limits<long long>::max(), 0, -1, std::numeric_limits<long long>::min(), 1, 0});
+}
+
+TEST(RadixHeap, MonotoneWithIndices)
+{
+    std::mt19937 gen(7);
+    RadixHeap<long long> heap;
+    std::vector<RadixHeap<long long>::Index> ids;
+    std::multiset<long long> control;
+    long long last = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        int action = gen() % 5;
+        if (action < 2 || ids.empty())
+        {
+            long long key = last + gen() % 1000;
+            ids.push_back(heap.push(key));
+            control.insert(key);
+        }
+        else
+        {
+            std::size_t at = gen() % ids.size();
+            long long key = *ids[at];
+            if (action == 2)
+            {
+                long long decreased = last + (key - last) / 2;
+                heap.set(ids[at], decreased); // decrease key
+                control.erase(control.find(key));
+                control.insert(decreased);
+                ASSERT_EQ(decreased, *ids[at]);
+            }
+            else if (action == 3)
+            {
+                ASSERT_EQ(key, heap.takeAt(ids[at]));
+                control.erase(control.find(key));
+                ids.erase(ids.begin() + at);
+            }
+            else
+            {
+                ASSERT_EQ(*control.begin(), heap.top());
+                const long long *top = &*heap.topIndex();
+                ids.erase(std::find_if(ids.begin(), ids.end(),
+                                       [top](RadixHeap<long long>::Index id) { return &*id == top; }));
+                last = *top;
+                ASSERT_EQ(last, heap.takeTop());
+                control.erase(control.begin());
+            }
+        }
+        ASSERT_EQ(control.size(), heap.size());
+    }
+    for (long long key : control)
+        ASSERT_EQ(key, heap.takeTop());
+    ASSERT_TRUE(heap.isEmpty());
+}
+
+TEST(RadixHeap, PeekKeepsBound)
+{
+    RadixHeap<int> heap;
+    heap.push(10);
+    heap.push(20);
+    EXPECT_EQ(10, heap.top());
+    heap.push(5); // only the last taken key bounds pushed ones
+    EXPECT_EQ(5, heap.top());
+    RadixHeap<int>::Index six = heap.push(6);
+    heap.set(heap.topIndex(), 15);
+    EXPECT_EQ(6, *heap.topIndex());
+    heap.popAt(six);
+    EXPECT_EQ(10, heap.top());
+    EXPECT_EQ(10, heap.takeTop());
+    heap.push(12);
+    EXPECT_EQ(12, heap.top());
+    heap.push(10);
+    EXPECT_EQ(10, heap.takeTop());
+    EXPECT_EQ(12, heap.takeTop());
+    EXPECT_EQ(15, heap.takeTop());
+    EXPECT_EQ(20, heap.takeTop());
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(RadixHeap, DijkstraMatchesLeftistHeap)
+{
+    typedef std::pair<long long, int> Pair;
+
+    std::vector<std::vector<int>> cases
+    {
+        {10, 20, 20},
+        {100, 2000, 200},
+        {1000, 5000, 1000000000}
+    };
+    for (int i = 0; i < 300; ++i)
+    {
+        auto param = cases[i%cases.size()];
+        auto testcase = RandomGraphGenerator::gen(i, param[0], param[1], param[2]);
+
+        Dijkstra d(testcase);
+        ASSERT_EQ(d.solve<LeftistHeap<Pair>>(0), d.solve<RadixHeap<Pair>>(0));
+    }
+}
+
+TEST(RadixHeap, DijkstraLargeGraph)
+{
+    typedef std::pair<long long, int> Pair;
+
+    auto testcase = RandomGraphGenerator::gen(2014, 200000, 1000000, 1000000000);
+    Dijkstra d(testcase);
+    ASSERT_EQ(d.solve<LeftistHeap<Pair>>(0), d.solve<RadixHeap<Pair>>(0));
+}
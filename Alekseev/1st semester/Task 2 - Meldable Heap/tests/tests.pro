@@ -15,7 +15,10 @@ INCLUDEPATH += $$GTEST/include/
 
 SOURCES += gtest_main.cc \
     leftistheap-integration-stress-test.cpp \
-    leftistheap-melding-test.cpp
+    leftistheap-melding-test.cpp \
+    leftistheap-bulk-test.cpp \
+    daryheap-test.cpp \
+    radixheap-test.cpp
 
 HEADERS += \
     testutils.h \
@@ -6,10 +6,12 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <algorithm>
 
 #include "gtest/gtest.h"
 
 #include "leftistheap.h"
+#include "daryheap.h"
 
 template<class T>
 class Asserted{};
@@ -50,6 +52,15 @@ public:
 
     explicit Asserted(const Compare& compare = Compare()): heap(compare) {}
 
+    template<class Iterator>
+    Asserted(Iterator begin, Iterator end, const Compare& compare = Compare()):
+        heap(begin, end, compare), controlSet(begin, end, compare)
+    {
+        assertInvariants();
+        assertKeysSet(controlSet);
+        EXPECT_EQ(controlSet.size(), heap.size());
+    }
+
     bool isEmpty()
     {
         return heap.isEmpty();
@@ -60,6 +71,11 @@ public:
         return heap.comparator();
     }
 
+    std::size_t size()
+    {
+        return heap.size();
+    }
+
     template<typename... Args>
     Index emplace(const Args&... args)
     {
@@ -89,7 +105,7 @@ public:
     Key takeTop()
     {
         Key ret = std::move(heap.takeTop());
-        controlSet.erase(ret);
+        controlSet.erase(controlSet.find(ret));
         assertInvariants();
         assertKeysSet(controlSet);
         return ret;
@@ -106,6 +122,41 @@ public:
         that.assertInvariants();
         that.assertKeysSet(that.controlSet);
     }
+    void absorbAll(const std::vector<Asserted<Heap>*> &those)
+    {
+        std::vector<std::reference_wrapper<Heap>> heaps;
+        for (Asserted<Heap> *that : those)
+        {
+            heaps.push_back(that->heap);
+            if (that == this)
+                continue;
+            controlSet.insert(that->controlSet.begin(), that->controlSet.end());
+            that->controlSet.clear();
+        }
+        heap.absorbAll(heaps);
+
+        assertInvariants();
+        assertKeysSet(controlSet);
+        EXPECT_EQ(controlSet.size(), heap.size());
+        for (Asserted<Heap> *that : those)
+            EXPECT_TRUE(that == this || that->heap.isEmpty());
+    }
+    std::vector<Key> extractK(std::size_t k)
+    {
+        std::vector<Key> ret = heap.extractK(k);
+        EXPECT_EQ(std::min(k, controlSet.size()), ret.size());
+        for (const Key &key : ret)
+        {
+            EXPECT_FALSE(heap.compare(key, *controlSet.begin())) << "extracted keys are not the smallest";
+            EXPECT_FALSE(heap.compare(*controlSet.begin(), key)) << "extracted keys are not the smallest";
+            controlSet.erase(controlSet.begin());
+        }
+
+        assertInvariants();
+        assertKeysSet(controlSet);
+        EXPECT_EQ(controlSet.size(), heap.size());
+        return ret;
+    }
 
     void assertKeysSet(std::multiset<Key, Compare> keys)
     {
@@ -202,4 +253,87 @@ private:
     std::multiset<Key, Compare> controlSet;
 };
 
+template<typename KeyT, class CompareT, std::size_t Arity>
+class Asserted<DAryHeap<KeyT, CompareT, Arity>>
+{
+public:
+    typedef KeyT     Key;
+    typedef CompareT Compare;
+
+    typedef DAryHeap<Key, Compare, Arity> Heap;
+    typedef typename Heap::Index          Index;
+
+    explicit Asserted(const Compare& compare = Compare()): heap(compare) {}
+
+    bool isEmpty()
+    {
+        return heap.isEmpty();
+    }
+
+    Compare * comparator()
+    {
+        return heap.comparator();
+    }
+
+    template<typename... Args>
+    Index emplace(const Args&... args)
+    {
+        Index ret = heap.emplace(args...);
+        controlSet.emplace(args...);
+        assertInvariants();
+        return ret;
+    }
+    Index push(const Key &key)
+    {
+        Index ret = heap.push(key);
+        controlSet.insert(key);
+        assertInvariants();
+        return ret;
+    }
+    Index set(Index at, const Key &key)
+    {
+        controlSet.erase(controlSet.find(*at));
+        Index ret = heap.set(at, key);
+        controlSet.insert(key);
+        assertInvariants();
+        EXPECT_EQ(key, *ret);
+        return ret;
+    }
+    Key takeTop()
+    {
+        Key ret = std::move(heap.takeTop());
+        controlSet.erase(controlSet.find(ret));
+        assertInvariants();
+        return ret;
+    }
+    Key takeAt(Index at)
+    {
+        Key ret = std::move(heap.takeAt(at));
+        controlSet.erase(controlSet.find(ret));
+        assertInvariants();
+        return ret;
+    }
+
+    void assertInvariants()
+    {
+        ASSERT_EQ(controlSet.size(), heap.size());
+        std::multiset<Key, Compare> keys;
+        for (std::size_t i = 0; i < heap.items.size(); ++i)
+        {
+            ASSERT_EQ(i, heap.positions[heap.items[i].handle]) << "bad position of item " << i;
+            if (i > 0)
+            {
+                ASSERT_FALSE(heap.compare(heap.items[i].key, heap.items[(i - 1) / Arity].key))
+                        << "item " << i << " is less than parent";
+            }
+            keys.insert(heap.items[i].key);
+        }
+        ASSERT_TRUE(std::equal(keys.begin(), keys.end(), controlSet.begin()));
+    }
+
+private:
+    Heap heap;
+    std::multiset<Key, Compare> controlSet;
+};
+
 #endif // TESTUTILS_H
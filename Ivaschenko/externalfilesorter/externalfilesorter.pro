@@ -13,4 +13,26 @@ HEADERS += \
     externalsorter.h \
     utils/tempfileiofactory.h \
     sorters/digitalsorter.h \
-    utils/integerbitblockextractor.h
+    utils/integerbitblockextractor.h \
+    utils/blockingqueue.h \
+    utils/losertree.h \
+    utils/alignedblock.h \
+    io/blockfilereader.h \
+    io/blockfilewriter.h \
+    utils/mergeplanner.h \
+    utils/spanio.h \
+    io/mappedfilereader.h \
+    io/mappedfilewriter.h \
+    sorters/radixsorter.h \
+    utils/stringarena.h \
+    utils/integertext.h \
+    utils/partitionedmerger.h \
+    utils/sortstatistics.h \
+    utils/spillfile.h \
+    utils/spillfileiofactory.h \
+    io/spillrunreader.h \
+    io/spillrunwriter.h \
+    utils/topkthreshold.h \
+    utils/duplicatereducers.h \
+    utils/presortedness.h \
+    utils/taggedlosertree.h
@@ -3,54 +3,78 @@
 
 #include <cstdio>
 #include <cassert>
+#include <cstdint>
 
-#include <queue>
+#include <vector>
 #include <string>
 #include <memory>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <functional>
 
 #include "io/binaryfilewriter.h"
 #include "io/binaryfilereader.h"
 
 #include "utils/tempfileiofactory.h"
+#include "utils/blockingqueue.h"
+#include "utils/losertree.h"
+#include "utils/mergeplanner.h"
+#include "utils/spanio.h"
+#include "utils/stringarena.h"
+#include "utils/partitionedmerger.h"
+#include "utils/sortstatistics.h"
+#include "utils/topkthreshold.h"
+#include "utils/duplicatereducers.h"
+#include "utils/presortedness.h"
+#include "utils/taggedlosertree.h"
 
-namespace impl
-{
-	template<typename T, typename Comparator> class StablePairComparator
-	{
-		public:
-			bool operator () (const std::pair<T, int> &a, const std::pair<T, int> &b)
-			{
-				return (cmp(b.first, a.first) || (!cmp(a.first, b.first) && a.second > b.second));
-			}
-
-		private:
-			Comparator cmp;
-	};
-
-	template<typename T, typename Comparator> class PairComparator
-	{
-		public:
-			bool operator () (const std::pair<T, int> &a, const std::pair<T, int> &b)
-			{
-				return cmp(b.first, a.first);
-			}
-
-		private:
-			Comparator cmp;
-	};
-}
+#include "io/mappedfilereader.h"
 
 /**
  * ExternalFileSorter class is used for sorting extenal fixed-type data files using
  * default or custom reader, writer, sorter and comparator functors
+ * Statistics is a policy recording work done in every phase of sorting: NoSortStatistics
+ * (default) records nothing and costs nothing, SortStatistics collects counters and times
  */
-template<typename DataType, typename Comparator> class ExternalSorter
+template<typename DataType, typename Comparator, typename Statistics = NoSortStatistics> class ExternalSorter
 {
 	public:
+		ExternalSorter(): readBufferSize(temporaryReaderBuffer), maxOpenFiles(MergePlanner::openFilesLimit()) {}
+
+		/**
+		 * Value of readBufferSize meaning buffer size reported by TemporaryReader (default),
+		 * see MergePlanner::readerBufferSize
+		 */
+		static const std::size_t temporaryReaderBuffer = std::numeric_limits<std::size_t>::max();
+
+		/**
+		 * Returns statistics collected by all sorts done so far
+		 */
+		Statistics& getStatistics()
+		{
+			return statistics;
+		}
+
+		/**
+		 * Sets limits used to choose fan-in of merging: (readBufferSize) bytes of buffer in every
+		 * temporary reader and writer are counted against available memory (0 - buffers are not counted,
+		 * temporaryReaderBuffer - the size reported by TemporaryReader), not more than (maxOpenFiles)
+		 * temporary files are opened at once
+		 * Runs which do not fit are merged in several passes
+		 */
+		void setMergeLimits(std::size_t readBufferSize, std::size_t maxOpenFiles)
+		{
+			this->readBufferSize = readBufferSize;
+			this->maxOpenFiles = maxOpenFiles;
+		}
+
 		/**
 		 * Reads external data from reader spliting it into pieces each not more (availableMemory) bytes
 		 * Sorts each piece and writes them into files in binary format
-		 * Then performs merging of this files using mergesort algorithm with binary heap
+		 * Then performs merging of this files using mergesort algorithm with loser tree
 		 * Outputs result using Writer
 		 * Uses not more than (avaialbeMemory) bytes for storing data at any moment
 		 * Returns true if succeeded and false if error occured or data set is empty
@@ -79,8 +103,8 @@ template<typename DataType, typename Comparator> class ExternalSorter
 			if (!readAndSortChunks<Reader, TemporaryWriter, Sorter>(bufferSize, reader, sorter, factory))
 				return false;
 
-			return mergeFiles<Writer, TemporaryReader, impl::PairComparator<DataType, Comparator>, IOFactory>
-					(writer, factory);
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, false, IOFactory>
+					(availableMemory, writer, factory);
 		}
 
 		/**
@@ -101,96 +125,979 @@ template<typename DataType, typename Comparator> class ExternalSorter
 			if (!readAndSortChunks<Reader, TemporaryWriter, Sorter>(bufferSize, reader, sorter, factory))
 				return false;
 
-			return mergeFiles<Writer, TemporaryReader, impl::StablePairComparator<DataType, Comparator>, IOFactory >
-					(writer, factory);
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, true, IOFactory>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Pipelined variant of ExternalFileSorter::sort function
+		 * Reading of the next chunk, sorting of the current one and writing of the previous one
+		 * are performed simultaneously, chunk itself is sorted by (threads) workers
+		 * (hardware concurrency if threads = 0). All three chunks share (availableMemory) bytes
+		 * Reader and Writer are called only from the calling thread, Sorter is copied to every worker
+		 * Important: default sorting is unstable
+		 */
+		template<typename Reader, typename Writer, typename Sorter,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool pipelinedSort(std::size_t availableMemory,
+						   Reader &reader, Writer &writer,
+						   Sorter sorter, std::size_t threads = 0, IOFactory factory = IOFactory())
+		{
+			if (availableMemory < sizeof(DataType)) return false;
+			if (!readAndSortChunksPipelined<Reader, TemporaryWriter, Sorter>
+					(availableMemory, reader, sorter, factory, threads))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, false, IOFactory>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Stable variant of ExternalFileSorter::pipelinedSort function
+		 * Important: requires stable Sorter
+		 */
+		template<typename Reader, typename Writer, typename Sorter,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool pipelinedStableSort(std::size_t availableMemory,
+								 Reader &reader, Writer &writer,
+								 Sorter sorter, std::size_t threads = 0, IOFactory factory = IOFactory())
+		{
+			if (availableMemory < sizeof(DataType)) return false;
+			if (!readAndSortChunksPipelined<Reader, TemporaryWriter, Sorter>
+					(availableMemory, reader, sorter, factory, threads))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, true, IOFactory>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function which forms initial runs by replacement selection:
+		 * elements are kept in a heap of (availableMemory) bytes and are written to the current run
+		 * while they are not less than the last written one. Runs are about twice longer than memory
+		 * on random data and input which is nearly sorted produces a single run
+		 * No Sorter is needed. Important: sorting is unstable
+		 */
+		template<typename Reader, typename Writer,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool replacementSelectionSort(std::size_t availableMemory,
+									  Reader &reader, Writer &writer, IOFactory factory = IOFactory())
+		{
+			if (!readReplacementSelectionRuns<Reader, TemporaryWriter>(availableMemory, reader, factory))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, false, IOFactory>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function which outputs only (k) smallest elements in order
+		 * If (k) elements fit into (availableMemory) bytes they are selected by a bounded heap and
+		 * nothing is written to temporary files. Otherwise only the first (k) elements of every sorted
+		 * chunk are written, elements greater than a running threshold (see TopKThreshold) are dropped
+		 * while reading and merging stops after (k) elements
+		 * Returns true if succeeded and false if error occured or nothing was written
+		 * Important: sorting is unstable
+		 */
+		template<typename Reader, typename Writer, typename Sorter,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool partialSort(std::size_t availableMemory, std::size_t k,
+						 Reader &reader, Writer &writer,
+						 Sorter sorter, IOFactory factory = IOFactory())
+		{
+			std::size_t bufferSize = availableMemory / sizeof(DataType);
+			if (!bufferSize || !k) return false;
+			if (k <= bufferSize)
+				return selectSmallest(k, reader, writer);
+			if (!readAndSortPrunedChunks<Reader, TemporaryWriter, Sorter>(bufferSize, k, reader, sorter, factory))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, false, IOFactory>
+					(availableMemory, writer, factory, k);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function which sorts only elements from [low, high) range,
+		 * other elements are dropped while reading
+		 * Important: default sorting is unstable
+		 */
+		template<typename Reader, typename Writer, typename Sorter,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool rangeSort(std::size_t availableMemory, const DataType &low, const DataType &high,
+					   Reader &reader, Writer &writer,
+					   Sorter sorter, IOFactory factory = IOFactory())
+		{
+			RangeReader<Reader> rangeReader(reader, low, high);
+			return sort<RangeReader<Reader>, Writer, Sorter, TemporaryReader, TemporaryWriter, IOFactory>
+					(availableMemory, rangeReader, writer, sorter, factory);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function which collapses equal elements (by Comparator)
+		 * into one using (reducer): KeepFirst keeps the first one, CountDuplicates sums their counters,
+		 * any functor reducer(DataType &accumulated, const DataType &next) folds them its own way
+		 * Elements are collapsed in every sorted chunk before it is written, free space of the chunk
+		 * is filled by new elements (sorted and merged into it) while collapsing frees at least
+		 * 1 / refillFraction of the buffer, so one run may hold many times more input than memory.
+		 * Every merge (intermediate and final) collapses equal elements of different runs too
+		 * Accumulated element is the first one in input order if Sorter is stable
+		 */
+		template<typename Reader, typename Writer, typename Sorter, typename Reducer = KeepFirst,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool uniqueSort(std::size_t availableMemory,
+						Reader &reader, Writer &writer,
+						Sorter sorter, Reducer reducer = Reducer(), IOFactory factory = IOFactory())
+		{
+			std::size_t bufferSize = availableMemory / sizeof(DataType);
+			if (!bufferSize) return false;
+			if (!readAndReduceChunks<Reader, TemporaryWriter, Sorter>(bufferSize, reader, sorter, reducer, factory))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, true, IOFactory>
+					(availableMemory, writer, factory, std::numeric_limits<std::size_t>::max(), reducer);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function for big records (tag sort)
+		 * KeyExtractor is a functor returning std::uint64_t normalized key prefix of a record which
+		 * agrees with Comparator: a < b implies key(a) <= key(b)
+		 * Every chunk is sorted as array of compact (key prefix, index) tags, full records are compared
+		 * only when prefixes are equal and are not moved in memory at all: they are written to the run
+		 * in order of sorted tags. Runs are merged by TaggedLoserTree, which plays on prefixes too
+		 * Tags take 16 bytes per record of (availableMemory). No Sorter is needed, sorting is stable
+		 */
+		template<typename Reader, typename Writer, typename KeyExtractor,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool tagSort(std::size_t availableMemory,
+					 Reader &reader, Writer &writer, IOFactory factory = IOFactory())
+		{
+			typedef TaggedLoserTree<DataType, MergeComparator, KeyExtractor, true> Tree;
+			std::size_t bufferSize = availableMemory / (sizeof(DataType) + sizeof(std::uint64_t) + sizeof(std::size_t));
+			if (!bufferSize) return false;
+			if (!readAndTagSortChunks<Reader, TemporaryWriter, KeyExtractor>(bufferSize, reader, factory))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, true, IOFactory, impl::NoReducer, Tree>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function for std::string which does not allocate memory
+		 * for every string: chunk is kept in StringArena (characters packed into one block and index
+		 * with 8-byte key prefixes) and its actual size in bytes is limited by (availableMemory)
+		 * Runs are written with TemporaryWriter::operator () (const char*, std::size_t)
+		 * No Sorter is needed, order is bytewise (Comparator must be std::less<std::string>)
+		 */
+		template<typename Reader, typename Writer,
+				 typename TemporaryReader = BinaryFileReader<DataType>,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< BinaryFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool arenaSort(std::size_t availableMemory,
+					   Reader &reader, Writer &writer, IOFactory factory = IOFactory())
+		{
+			static_assert(std::is_same<DataType, std::string>::value, "arenaSort works with std::string only");
+			static_assert(std::is_same<Comparator, std::less<std::string> >::value,
+						  "arenaSort sorts in bytewise order only");
+			if (!readArenaRuns<Reader, TemporaryWriter>(availableMemory, reader, factory))
+				return false;
+
+			return mergeFiles<Writer, TemporaryReader, TemporaryWriter, false, IOFactory>
+					(availableMemory, writer, factory);
+		}
+
+		/**
+		 * Variant of ExternalFileSorter::sort function with parallel final merge, result is written
+		 * to file (outputFileName) in BinaryFileWriter format
+		 * Every sorted chunk is sampled before it is written, after all runs are formed (and merged
+		 * in several passes if MergePlanner requires) key space is cut into partitions by quantiles
+		 * of the sample, runs are mapped to memory and cut at the same keys by binary search,
+		 * partitions are merged by (threads) workers (hardware concurrency if threads = 0) straight
+		 * to their offsets in the output file (see PartitionedMerger)
+		 * Every worker uses its own output buffer, all of them share (availableMemory) bytes,
+		 * sample takes samplesPerChunk elements of every chunk in addition
+		 * Result is stable if Sorter is stable
+		 */
+		template<typename Reader, typename Sorter,
+				 typename TemporaryWriter = BinaryFileWriter<DataType>,
+				 typename IOFactory = TempFileIOFactory< MappedFileReader<DataType>, BinaryFileWriter<DataType> > >
+		bool parallelMergeSort(std::size_t availableMemory, Reader &reader, const std::string &outputFileName,
+							   Sorter sorter, std::size_t threads = 0, IOFactory factory = IOFactory())
+		{
+			typedef MappedFileReader<DataType> TemporaryReader;
+			std::size_t bufferSize = availableMemory / sizeof(DataType);
+			if (!bufferSize) return false;
+			if (!threads)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			std::vector<DataType> samples;
+			if (!readAndSortChunks<Reader, TemporaryWriter, Sorter>(bufferSize, reader, sorter, factory, &samples))
+				return false;
+			if (!reduceRuns<TemporaryReader, TemporaryWriter, true, IOFactory>(availableMemory, factory))
+				return false;
+
+			PartitionedMerger<DataType, Comparator, true> merger(samples, threads * partitionsPerThread);
+			std::vector< std::unique_ptr<TemporaryReader> > runs;
+			for (std::size_t i = 0; i < tempFiles; ++i)
+			{
+				runs.push_back(factory.openReader());
+				if (!runs.back()->ready()) return false;
+				merger.addRun(runs.back()->begin(), runs.back()->end());
+			}
+
+			typename Statistics::Timer timer(statistics, Statistics::Merging);
+			statistics.buffer(std::max<std::size_t>(1, bufferSize / threads) * std::min(threads, merger.partitions())
+							  * sizeof(DataType));
+			if (!merger.merge(outputFileName, threads, bufferSize / threads)) return false;
+			for (const std::unique_ptr<TemporaryReader> &run : runs)
+			{
+				statistics.read(Statistics::Merging, run->begin(), run->end() - run->begin());
+				statistics.written(Statistics::OutputWriting, run->begin(), run->end() - run->begin());
+			}
+			return true;
 		}
 
+		/**
+		 * Number of elements taken from every sorted chunk to choose splitters of parallel merge
+		 */
+		static const std::size_t samplesPerChunk = 256;
+
+		/**
+		 * Parallel merge cuts key space into this number of partitions per worker to balance load
+		 */
+		static const std::size_t partitionsPerThread = 4;
+
+		/**
+		 * uniqueSort keeps filling a chunk while collapsing of duplicates frees at least
+		 * this part of the buffer
+		 */
+		static const std::size_t refillFraction = 8;
+
+		/**
+		 * Chunk made of not more than this number of ascending runs is merged naturally instead of sorting
+		 */
+		static const std::size_t naturalMergeRuns = 8;
+
 	private:
 		std::size_t tempFiles;
+		std::size_t readBufferSize, maxOpenFiles;
+		Statistics statistics;
+
+		typedef typename Statistics::template Compare<Comparator>::Type MergeComparator;
+
+		/**
+		 * Reader which passes only elements from [low, high) range
+		 */
+		template<typename Reader> class RangeReader
+		{
+			public:
+				RangeReader(Reader &reader, const DataType &low, const DataType &high)
+					: reader(&reader), low(low), high(high) {}
+
+				bool operator () (DataType &element)
+				{
+					while ((*reader)(element))
+						if (!cmp(element, low) && cmp(element, high)) return true;
+					return false;
+				}
+
+			private:
+				Reader *reader;
+				DataType low, high;
+				Comparator cmp;
+		};
 
 		/**
 		 * Writes an array of data to file in binary format
+		 * Whole array is passed at once if TemporaryWriter has span overload
 		 * Returns true if succeeded
 		 */
-		template<typename TemporaryWriter, typename ForwardIterator, typename IOFactory>
-		bool writeFile(ForwardIterator start, std::size_t items, IOFactory &factory)
+		template<typename TemporaryWriter, typename IOFactory>
+		bool writeFile(DataType *elements, std::size_t items, IOFactory &factory)
 		{
 			std::unique_ptr<TemporaryWriter> writer = factory.openWriter();
-			for (; items; --items, ++start)
-				if (!writer->operator()(*start)) return false;
+			if (!appendRun(*writer, elements, items)) return false;
+			statistics.run(items);
+			return true;
+		}
+
+		/**
+		 * Writes an array of data to already opened temporary (writer)
+		 * Returns true if succeeded
+		 */
+		template<typename TemporaryWriter>
+		bool appendRun(TemporaryWriter &writer, DataType *elements, std::size_t items)
+		{
+			typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+			if (!impl::writeSpan(writer, elements, items)) return false;
+			statistics.written(Statistics::SpillWriting, elements, items);
 			return true;
 		}
 
 		/**
 		 * Reads data from reader to buffer, sorts it and outputs to temporary files
+		 * Chunk is read at once if Reader has span overload
+		 * Chunk which is already sorted, strictly descending or made of a few ascending runs is put
+		 * in order without Sorter (see impl::orderPresorted). Chunk which starts not less than
+		 * the previous one ends is appended to its file, so sorted input gives a single run
+		 * If (samples) is given, evenly spaced elements of every sorted chunk are added to it,
+		 * samplesPerChunk from a full chunk and proportionally less from the last one
 		 * Returns number of created files (less or equal 0 if error)
 		 */
 		template<typename Reader, typename TemporaryWriter,
 				 typename Sorter, typename IOFactory >
 		int readAndSortChunks(std::size_t bufferSize, Reader &reader,
-							  Sorter &sorter, IOFactory &factory)
+							  Sorter &sorter, IOFactory &factory, std::vector<DataType> *samples = 0)
 		{
+			std::size_t sampleStep = std::max<std::size_t>(1, bufferSize / samplesPerChunk);
 			std::vector<DataType> buffer(bufferSize);
+			statistics.buffer(bufferSize * sizeof(DataType));
+			tempFiles = 0;
+			std::size_t currentSize, runSize = 0;
+			std::unique_ptr<TemporaryWriter> run;
+			DataType last = DataType();
+			Comparator cmp;
+
+			while ((currentSize = readChunk(reader, buffer.data(), bufferSize)) != 0)
+			{
+				{
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					if (impl::orderPresorted(buffer.begin(), buffer.begin() + currentSize, cmp, naturalMergeRuns)
+							== impl::ChunkOrder::Unordered)
+						sorter(buffer.begin(), buffer.begin() + currentSize);
+				}
+				if (samples)
+					for (std::size_t i = sampleStep / 2; i < currentSize; i += sampleStep)
+						samples->push_back(buffer[i]);
+				if (!run || cmp(buffer[0], last))
+				{
+					if (run) statistics.run(runSize);
+					run.reset();
+					run = factory.openWriter();
+					runSize = 0;
+					++tempFiles;
+				}
+				last = buffer[currentSize - 1];
+				if (!appendRun(*run, buffer.data(), currentSize)) return 0;
+				runSize += currentSize;
+				if (currentSize < bufferSize) break;
+			}
+			if (run) statistics.run(runSize);
+			return tempFiles;
+		}
+
+		/**
+		 * Version of readAndSortChunks for uniqueSort: equal elements of the sorted chunk are collapsed
+		 * by (reducer), freed space is filled with new elements which are sorted separately and merged
+		 * into the chunk, chunk is written when collapsing frees less than 1 / refillFraction of it
+		 * New elements are read into the upper half of the free space and merged backwards into
+		 * the lower half, so the merge takes no memory besides the buffer
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter, typename Sorter,
+				 typename Reducer, typename IOFactory>
+		int readAndReduceChunks(std::size_t bufferSize, Reader &reader,
+								Sorter &sorter, Reducer &reducer, IOFactory &factory)
+		{
+			std::size_t minimalRefill = std::max<std::size_t>(2, bufferSize / refillFraction);
+			std::vector<DataType> buffer(bufferSize);
+			statistics.buffer(bufferSize * sizeof(DataType));
 			tempFiles = 0;
 			std::size_t currentSize = 0;
 
-			while (reader(buffer[currentSize]))
+			bool more = true;
+			while (more)
 			{
-				++currentSize;
-				if (currentSize == bufferSize)
+				std::size_t start = currentSize ? bufferSize - (bufferSize - currentSize) / 2 : 0;
+				std::size_t items = readChunk(reader, buffer.data() + start, bufferSize - start);
+				more = start + items == bufferSize;
 				{
-					sorter(buffer.begin(), buffer.begin() + currentSize);
-					if (!writeFile<TemporaryWriter, decltype(buffer.begin()), IOFactory>
-							(buffer.begin(), currentSize, factory)) return 0;
-					currentSize = 0;
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					sorter(buffer.begin() + start, buffer.begin() + start + items);
+					mergeBackward(buffer.data(), currentSize, buffer.data() + start, items);
+					currentSize = reduceSorted(buffer.data(), currentSize + items, reducer);
+				}
+				if (currentSize && (!more || bufferSize - currentSize < minimalRefill))
+				{
+					if (!writeFile<TemporaryWriter, IOFactory>(buffer.data(), currentSize, factory)) return 0;
 					++tempFiles;
+					currentSize = 0;
+				}
+			}
+			return tempFiles;
+		}
+
+		/**
+		 * Merges sorted (run) of (runItems) elements into sorted (elements) of (items) elements,
+		 * result takes first (items + runItems) elements. Run should not start before the end
+		 * of the result, equal elements of the run go after the ones of (elements)
+		 */
+		static void mergeBackward(DataType *elements, std::size_t items, DataType *run, std::size_t runItems)
+		{
+			if (run == elements) return;
+			Comparator cmp;
+			while (runItems)
+				if (items && cmp(run[runItems - 1], elements[items - 1]))
+				{
+					--items;
+					elements[items + runItems] = std::move(elements[items]);
+				}
+				else
+				{
+					--runItems;
+					elements[items + runItems] = std::move(run[runItems]);
+				}
+		}
+
+		/**
+		 * Collapses equal consecutive elements of sorted (elements) by (reducer)
+		 * Returns number of elements left
+		 */
+		template<typename Reducer>
+		std::size_t reduceSorted(DataType *elements, std::size_t items, Reducer &reducer)
+		{
+			if (!items) return 0;
+			Comparator cmp;
+			std::size_t last = 0;
+			for (std::size_t i = 1; i < items; ++i)
+				if (cmp(elements[last], elements[i]))
+				{
+					if (++last != i)
+						elements[last] = std::move(elements[i]);
+				}
+				else
+					reducer(elements[last], elements[i]);
+			return last + 1;
+		}
+
+		/**
+		 * Version of readAndSortChunks for tagSort: chunk is sorted as array of (key prefix, index)
+		 * tags, equal records keep their input order, then records are written in order of tags
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter, typename KeyExtractor, typename IOFactory>
+		int readAndTagSortChunks(std::size_t bufferSize, Reader &reader, IOFactory &factory)
+		{
+			typedef std::pair<std::uint64_t, std::size_t> Tag; // key prefix and index of record in chunk
+			std::vector<DataType> buffer(bufferSize);
+			std::vector<Tag> tags(bufferSize);
+			statistics.buffer(bufferSize * (sizeof(DataType) + sizeof(Tag)));
+			KeyExtractor key;
+			Comparator cmp;
+			tempFiles = 0;
+			std::size_t currentSize;
+
+			while ((currentSize = readChunk(reader, buffer.data(), bufferSize)) != 0)
+			{
+				{
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					for (std::size_t i = 0; i < currentSize; ++i)
+						tags[i] = Tag(key(buffer[i]), i);
+					std::sort(tags.begin(), tags.begin() + currentSize, [&](const Tag &a, const Tag &b)
+					{
+						if (a.first != b.first) return a.first < b.first;
+						if (cmp(buffer[a.second], buffer[b.second])) return true;
+						return !cmp(buffer[b.second], buffer[a.second]) && a.second < b.second;
+					});
+				}
+				{
+					typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+					std::unique_ptr<TemporaryWriter> writer = factory.openWriter();
+					for (std::size_t i = 0; i < currentSize; ++i)
+						if (!(*writer)(buffer[tags[i].second])) return 0;
+					statistics.written(Statistics::SpillWriting, buffer.data(), currentSize);
+					statistics.run(currentSize);
+				}
+				++tempFiles;
+				if (currentSize < bufferSize) break;
+			}
+			return tempFiles;
+		}
+
+		/**
+		 * Reads up to (count) elements from (reader) to (elements) recording it to statistics
+		 * Returns number of elements read
+		 */
+		template<typename Reader>
+		std::size_t readChunk(Reader &reader, DataType *elements, std::size_t count)
+		{
+			typename Statistics::Timer timer(statistics, Statistics::Reading);
+			std::size_t items = impl::readSpan(reader, elements, count);
+			statistics.read(Statistics::Reading, elements, items);
+			return items;
+		}
+
+		/**
+		 * Selects (k) smallest elements from (reader) by a bounded max-heap and outputs them in order
+		 * Returns true if no error occured and at least one element was written
+		 */
+		template<typename Reader, typename Writer>
+		bool selectSmallest(std::size_t k, Reader &reader, Writer &writer)
+		{
+			std::vector<DataType> heap;
+			heap.reserve(k);
+			statistics.buffer(k * sizeof(DataType));
+			Comparator cmp;
+			DataType current;
+			while (readElement(reader, current))
+			{
+				typename Statistics::Timer timer(statistics, Statistics::Sorting);
+				if (heap.size() < k)
+				{
+					heap.push_back(current);
+					std::push_heap(heap.begin(), heap.end(), cmp);
+				}
+				else if (cmp(current, heap.front()))
+				{
+					std::pop_heap(heap.begin(), heap.end(), cmp);
+					heap.back() = current;
+					std::push_heap(heap.begin(), heap.end(), cmp);
 				}
 			}
-			if (currentSize != 0)
 			{
-				sorter(buffer.begin(), buffer.begin() + currentSize);
-				if (!writeFile<TemporaryWriter, decltype(buffer.begin()), IOFactory>
-						(buffer.begin(), currentSize, factory)) return 0;
-				currentSize = 0;
+				typename Statistics::Timer timer(statistics, Statistics::Sorting);
+				std::sort_heap(heap.begin(), heap.end(), cmp);
+			}
+			for (DataType &element : heap)
+				if (!writeElement(writer, element, Statistics::OutputWriting)) return false;
+			return !heap.empty();
+		}
+
+		/**
+		 * Version of readAndSortChunks for selection of (k) smallest elements: only first (k) elements
+		 * of every sorted chunk are written, elements rejected by TopKThreshold are not stored
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter, typename Sorter, typename IOFactory>
+		int readAndSortPrunedChunks(std::size_t bufferSize, std::size_t k, Reader &reader,
+									Sorter &sorter, IOFactory &factory)
+		{
+			std::vector<DataType> buffer(bufferSize);
+			statistics.buffer(bufferSize * sizeof(DataType));
+			TopKThreshold<DataType, Comparator> threshold(k);
+			tempFiles = 0;
+
+			bool more = true;
+			while (more)
+			{
+				std::size_t currentSize = 0;
+				while (currentSize < bufferSize && (more = readElement(reader, buffer[currentSize])))
+					if (!threshold.rejects(buffer[currentSize])) ++currentSize;
+				if (!currentSize) break;
+				{
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					sorter(buffer.begin(), buffer.begin() + currentSize);
+				}
+				std::size_t kept = std::min(currentSize, k);
+				if (!writeFile<TemporaryWriter, IOFactory>(buffer.data(), kept, factory)) return 0;
 				++tempFiles;
+				threshold.addRun(buffer.data(), kept);
+			}
+			return tempFiles;
+		}
+
+		/**
+		 * Sorts (items) elements starting from (start) with (threads) workers:
+		 * every worker sorts its own slice with a copy of (sorter), then slices are merged pairwise
+		 * Result is stable if (sorter) is stable
+		 */
+		template<typename Sorter, typename RandomAccessIterator>
+		void sortChunk(RandomAccessIterator start, std::size_t items, Sorter &sorter, std::size_t threads)
+		{
+			std::size_t slices = std::max<std::size_t>(1, std::min(threads, items));
+			std::vector<RandomAccessIterator> bounds;
+			for (std::size_t i = 0; i <= slices; ++i)
+				bounds.push_back(start + items * i / slices);
+
+			std::vector<Sorter> sorters(slices, sorter);
+			std::vector<std::thread> workers;
+			for (std::size_t i = 1; i < slices; ++i)
+				workers.emplace_back([&bounds, &sorters, i] { sorters[i](bounds[i], bounds[i + 1]); });
+			sorters[0](bounds[0], bounds[1]);
+			for (auto &worker : workers)
+				worker.join();
+
+			while (bounds.size() > 2)
+			{
+				std::vector<RandomAccessIterator> merged;
+				workers.clear();
+				for (std::size_t i = 0; i + 1 < bounds.size(); i += 2)
+				{
+					merged.push_back(bounds[i]);
+					if (i + 2 < bounds.size())
+						workers.emplace_back([&bounds, i]
+							{ std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], Comparator()); });
+				}
+				merged.push_back(bounds.back());
+				for (auto &worker : workers)
+					worker.join();
+				bounds.swap(merged);
+			}
+		}
+
+		/**
+		 * Pipelined version of readAndSortChunks: (availableMemory) is shared by three buffers,
+		 * one is filled by reader, one is sorted and one is written to temporary file at the same time
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter,
+				 typename Sorter, typename IOFactory >
+		int readAndSortChunksPipelined(std::size_t availableMemory, Reader &reader,
+									   Sorter &sorter, IOFactory &factory, std::size_t threads)
+		{
+			typedef std::pair<std::size_t, std::size_t> Chunk; // buffer index and number of items
+			const std::size_t stages = 3;
+
+			std::size_t bufferSize = availableMemory / sizeof(DataType) / stages;
+			if (!bufferSize)
+				return readAndSortChunks<Reader, TemporaryWriter, Sorter>
+						(availableMemory / sizeof(DataType), reader, sorter, factory);
+			if (!threads)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			std::vector< std::vector<DataType> > buffers(stages, std::vector<DataType>(bufferSize));
+			statistics.buffer(stages * bufferSize * sizeof(DataType));
+			BlockingQueue<std::size_t> freeBuffers;
+			BlockingQueue<Chunk> sortQueue, writeQueue;
+			for (std::size_t i = 0; i < stages; ++i)
+				freeBuffers.push(i);
+
+			tempFiles = 0;
+			std::atomic<bool> failed(false);
+
+			std::thread sortingStage([&]
+			{
+				Chunk chunk;
+				while (sortQueue.pop(chunk))
+				{
+					if (!failed)
+					{
+						typename Statistics::Timer timer(statistics, Statistics::Sorting);
+						sortChunk(buffers[chunk.first].begin(), chunk.second, sorter, threads);
+					}
+					writeQueue.push(chunk);
+				}
+				writeQueue.close();
+			});
+
+			std::thread writingStage([&]
+			{
+				Chunk chunk;
+				while (writeQueue.pop(chunk))
+				{
+					if (!failed)
+					{
+						if (writeFile<TemporaryWriter, IOFactory>
+								(buffers[chunk.first].data(), chunk.second, factory))
+							++tempFiles;
+						else
+							failed = true;
+					}
+					freeBuffers.push(chunk.first);
+				}
+			});
+
+			std::size_t current;
+			while (!failed && freeBuffers.pop(current))
+			{
+				std::size_t currentSize = readChunk(reader, buffers[current].data(), bufferSize);
+				if (currentSize)
+					sortQueue.push(Chunk(current, currentSize));
+				if (currentSize < bufferSize) break;
+			}
+			sortQueue.close();
+
+			sortingStage.join();
+			writingStage.join();
+			return failed ? 0 : tempFiles;
+		}
+
+		/**
+		 * Element of the replacement selection heap: value and number of run it belongs to
+		 */
+		struct RunElement
+		{
+			std::size_t run;
+			DataType value;
+		};
+
+		/**
+		 * Orders heap by run number, then by value (std heap functions build max-heap)
+		 */
+		class RunElementComparator
+		{
+			public:
+				bool operator () (const RunElement &a, const RunElement &b)
+				{
+					return a.run != b.run ? a.run > b.run : cmp(b.value, a.value);
+				}
+
+			private:
+				Comparator cmp;
+		};
+
+		/**
+		 * Reads one element from (reader) recording it to statistics
+		 */
+		template<typename Reader>
+		bool readElement(Reader &reader, DataType &element)
+		{
+			typename Statistics::Timer timer(statistics, Statistics::Reading);
+			if (!reader(element)) return false;
+			statistics.read(Statistics::Reading, &element, 1);
+			return true;
+		}
+
+		/**
+		 * Reads data from reader and forms sorted runs using replacement selection with a heap
+		 * of not more than (availableMemory) bytes, writes each run to its own temporary file
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter, typename IOFactory>
+		int readReplacementSelectionRuns(std::size_t availableMemory, Reader &reader, IOFactory &factory)
+		{
+			std::size_t heapSize = availableMemory / sizeof(RunElement);
+			tempFiles = 0;
+			if (!heapSize) return 0;
+
+			std::vector<RunElement> heap;
+			heap.reserve(heapSize);
+			statistics.buffer(heapSize * sizeof(RunElement));
+			RunElement current;
+			current.run = 0;
+			while (heap.size() < heapSize && readElement(reader, current.value))
+				heap.push_back(current);
+
+			RunElementComparator heapCmp;
+			Comparator cmp;
+			{
+				typename Statistics::Timer timer(statistics, Statistics::Sorting);
+				std::make_heap(heap.begin(), heap.end(), heapCmp);
+			}
+
+			std::unique_ptr<TemporaryWriter> run;
+			std::size_t runLength = 0;
+			while (!heap.empty())
+			{
+				{
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					std::pop_heap(heap.begin(), heap.end(), heapCmp);
+				}
+				RunElement &top = heap.back();
+				if (!run || top.run != current.run)
+				{
+					if (run) statistics.run(runLength);
+					run = factory.openWriter();
+					current.run = top.run;
+					runLength = 0;
+					++tempFiles;
+				}
+				{
+					typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+					if (!run->operator() (top.value)) return 0;
+					statistics.written(Statistics::SpillWriting, &top.value, 1);
+					++runLength;
+				}
+
+				if (readElement(reader, current.value))
+				{
+					typename Statistics::Timer timer(statistics, Statistics::Sorting);
+					std::size_t nextRun = cmp(current.value, top.value) ? top.run + 1 : top.run;
+					top.value = current.value;
+					top.run = nextRun;
+					std::push_heap(heap.begin(), heap.end(), heapCmp);
+				}
+				else
+					heap.pop_back();
 			}
-			assert(currentSize == 0);
+			if (run) statistics.run(runLength);
+			return tempFiles;
+		}
+
+		/**
+		 * Sorts strings in (arena) and writes them to the new temporary file
+		 * Returns true if succeeded
+		 */
+		template<typename TemporaryWriter, typename IOFactory>
+		bool writeArena(impl::StringArena &arena, IOFactory &factory)
+		{
+			{
+				typename Statistics::Timer timer(statistics, Statistics::Sorting);
+				arena.sort();
+			}
+			typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+			std::unique_ptr<TemporaryWriter> writer = factory.openWriter();
+			for (std::size_t i = 0; i < arena.size(); ++i)
+				if (!writer->operator()(arena.data(i), arena.length(i))) return false;
+			statistics.written(Statistics::SpillWriting, arena.size(),
+							   arena.usedBytes() - arena.size() * sizeof(impl::StringArena::Entry));
+			statistics.run(arena.size());
+			++tempFiles;
+			arena.clear();
+			return true;
+		}
+
+		/**
+		 * Reads strings to arena of (availableMemory) bytes and outputs sorted runs to temporary files
+		 * String which does not fit even into the empty arena forms a run by itself
+		 * Returns number of created files (less or equal 0 if error)
+		 */
+		template<typename Reader, typename TemporaryWriter, typename IOFactory>
+		int readArenaRuns(std::size_t availableMemory, Reader &reader, IOFactory &factory)
+		{
+			impl::StringArena arena(availableMemory);
+			statistics.buffer(availableMemory);
+			std::string current;
+			tempFiles = 0;
+
+			while (readElement(reader, current))
+			{
+				if (!arena.fits(current.size()) && !arena.empty()
+						&& !writeArena<TemporaryWriter, IOFactory>(arena, factory)) return 0;
+				if (arena.fits(current.size()))
+					arena.push(current.data(), current.size());
+				else
+				{
+					typename Statistics::Timer timer(statistics, Statistics::SpillWriting);
+					std::unique_ptr<TemporaryWriter> writer = factory.openWriter();
+					if (!writer->operator()(current.data(), current.size())) return 0;
+					statistics.written(Statistics::SpillWriting, &current, 1);
+					statistics.run(1);
+					++tempFiles;
+				}
+			}
+			if (!arena.empty() && !writeArena<TemporaryWriter, IOFactory>(arena, factory)) return 0;
 			return tempFiles;
 		}
 
 		/**
 		 * Merges temporary sorted files created after reading data into one and outputs to (writer)
-		 * Uses mergesort algorithm with binary heap (HeapClass)
+		 * If there are more files than MergePlanner allows to merge within (availableMemory) bytes
+		 * and opened files limit, consecutive files are merged into new temporary ones first
+		 * Equal elements are taken from earlier files first if (Stable)
+		 * Not more than (limit) smallest elements are merged at every step,
+		 * equal elements are collapsed by (reducer) at every step unless it is impl::NoReducer
+		 * Runs are merged by (Tree): LoserTree or another tree with the same interface
 		 * Returns true if no error occured
 		 */
-		template<typename Writer, typename TemporaryReader, typename PairComparator, typename IOFactory>
-		bool mergeFiles(Writer &writer, IOFactory &factory)
+		template<typename Writer, typename TemporaryReader, typename TemporaryWriter,
+				 bool Stable, typename IOFactory, typename Reducer = impl::NoReducer,
+				 typename Tree = LoserTree<DataType, MergeComparator, Stable> >
+		bool mergeFiles(std::size_t availableMemory, Writer &writer, IOFactory &factory,
+						std::size_t limit = std::numeric_limits<std::size_t>::max(), Reducer reducer = Reducer())
 		{
-			typedef std::pair<DataType, int> HeapElement;
+			if (!reduceRuns<TemporaryReader, TemporaryWriter, Stable, IOFactory, Reducer, Tree>
+					(availableMemory, factory, limit, reducer))
+				return false;
+			return mergeRuns<Writer, TemporaryReader, Stable, IOFactory, Reducer, Tree>
+					(tempFiles, writer, factory, Statistics::OutputWriting, limit, reducer);
+		}
 
+		/**
+		 * Merges consecutive temporary files into new temporary ones while there are more files
+		 * than MergePlanner allows to merge at once within (availableMemory) bytes and opened files limit
+		 * Returns true if no error occured
+		 */
+		template<typename TemporaryReader, typename TemporaryWriter, bool Stable, typename IOFactory,
+				 typename Reducer = impl::NoReducer, typename Tree = LoserTree<DataType, MergeComparator, Stable> >
+		bool reduceRuns(std::size_t availableMemory, IOFactory &factory,
+						std::size_t limit = std::numeric_limits<std::size_t>::max(), Reducer reducer = Reducer())
+		{
 			assert(tempFiles != 0);
-			std::vector< std::unique_ptr<TemporaryReader> > streams;
+			std::size_t buffer = readBufferSize == temporaryReaderBuffer
+					? MergePlanner::readerBufferSize<TemporaryReader>() : readBufferSize;
+			MergePlanner planner(availableMemory, sizeof(DataType), buffer, maxOpenFiles);
+			while (tempFiles > planner.fanIn())
+			{
+				std::vector<std::size_t> groups = planner.nextPass(tempFiles);
+				for (std::size_t group : groups)
+				{
+					std::unique_ptr<TemporaryWriter> output = factory.openWriter();
+					if (!mergeRuns<TemporaryWriter, TemporaryReader, Stable, IOFactory, Reducer, Tree>
+							(group, *output, factory, Statistics::SpillWriting, limit, reducer)) return false;
+				}
+				tempFiles = groups.size();
+				statistics.mergePass();
+			}
+			return true;
+		}
 
-			std::priority_queue<HeapElement, std::vector<HeapElement>, PairComparator> heap;
-			HeapElement current;
+		/**
+		 * Merges next (runs) temporary files with loser tree and outputs not more than (limit)
+		 * first elements of result to (writer). Output is recorded to statistics as (outputPhase)
+		 * Equal elements are collapsed by (reducer) before output unless it is impl::NoReducer
+		 * Returns true if no error occured
+		 */
+		template<typename Writer, typename TemporaryReader, bool Stable, typename IOFactory,
+				 typename Reducer = impl::NoReducer, typename Tree = LoserTree<DataType, MergeComparator, Stable> >
+		bool mergeRuns(std::size_t runs, Writer &writer, IOFactory &factory, typename Statistics::Phase outputPhase,
+					   std::size_t limit = std::numeric_limits<std::size_t>::max(), Reducer reducer = Reducer())
+		{
+			const bool reducing = !std::is_same<Reducer, impl::NoReducer>::value;
+			MergeComparator cmp = statistics.template comparator<Comparator>();
+			DataType accumulated;
+			bool accumulating = false;
 
-			for (std::size_t i = 0; i < tempFiles; i++)
+			typename Statistics::Timer timer(statistics, Statistics::Merging);
+			std::vector< std::unique_ptr<TemporaryReader> > streams;
+			Tree tree(runs, statistics.template comparator<Comparator>());
+			statistics.buffer(runs * sizeof(DataType));
+
+			for (std::size_t i = 0; i < runs; i++)
 			{
 				streams.push_back(factory.openReader());
-				streams[i]->operator() (current.first);
-				current.second = i;
-				heap.push(current);
+				if (streams[i]->operator() (tree.head(i)))
+					tree.activate(i);
 			}
+			tree.build();
 
-			while (!heap.empty())
+			for (std::size_t merged = 0; !tree.empty() && merged < limit; ++merged)
 			{
-				current = heap.top();
-				heap.pop();
-				if (!writer(current.first)) return false;
-				if (streams[current.second]->operator() (current.first))
-					heap.push(current);
+				std::size_t current = tree.winner();
+				statistics.read(Statistics::Merging, &tree.top(), 1);
+				if (!reducing)
+				{
+					if (!writeElement(writer, tree.top(), outputPhase)) return false;
+				}
+				else if (accumulating && !cmp(accumulated, tree.top()))
+					reducer(accumulated, tree.top());
+				else
+				{
+					if (accumulating && !writeElement(writer, accumulated, outputPhase)) return false;
+					accumulated = tree.top();
+					accumulating = true;
+				}
+				if (streams[current]->operator() (tree.top()))
+					tree.update();
+				else
+					tree.exhaust();
 			}
 
+			return !accumulating || writeElement(writer, accumulated, outputPhase);
+		}
+
+		/**
+		 * Writes one element to (writer) recording it to statistics as (phase)
+		 */
+		template<typename Writer>
+		bool writeElement(Writer &writer, DataType &element, typename Statistics::Phase phase)
+		{
+			typename Statistics::Timer timer(statistics, phase);
+			if (!writer(element)) return false;
+			statistics.written(phase, &element, 1);
 			return true;
 		}
 };
@@ -5,6 +5,19 @@ SOURCES += \
     gtest/io/testcustomstreamreader.cpp \
     gtest/integrationsorttest.cpp \
     gtest/io/testbinaryfilereader.cpp \
-    gtest/sorters/testdigitalsorter.cpp
+    gtest/sorters/testdigitalsorter.cpp \
+    gtest/utils/testlosertree.cpp \
+    gtest/io/testblockfileio.cpp \
+    gtest/utils/testmergeplanner.cpp \
+    gtest/io/testmappedfileio.cpp \
+    gtest/sorters/testradixsorter.cpp \
+    gtest/utils/teststringarena.cpp \
+    gtest/utils/testintegertext.cpp \
+    gtest/utils/testpartitionedmerger.cpp \
+    gtest/utils/testsortstatistics.cpp \
+    gtest/utils/testspillfileiofactory.cpp \
+    gtest/utils/testtopkthreshold.cpp \
+    gtest/utils/testpresortedness.cpp \
+    gtest/utils/testtaggedlosertree.cpp
 
 HEADERS +=
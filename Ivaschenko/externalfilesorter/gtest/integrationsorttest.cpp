@@ -6,9 +6,17 @@
 
 #include "externalsorter.h"
 
+#include "io/blockfilereader.h"
+#include "io/blockfilewriter.h"
+#include "io/mappedfilereader.h"
+#include "io/mappedfilewriter.h"
+
+#include "utils/spillfileiofactory.h"
+
 #include "utils/integerbitblockextractor.h"
 
 #include "sorters/digitalsorter.h"
+#include "sorters/radixsorter.h"
 #include "sorters/standartsorter.h"
 #include "sorters/standartstablesorter.h"
 
@@ -460,3 +468,1112 @@ TEST(ExternalSorter, StableSorting)
 		std::cout << "    Sorting time = " << (clock() - start) / 1000 << "ms" << std::endl;
 	}
 }
+
+TEST(ExternalSorter, PipelinedRandomSequenceSorting)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(std::size_t n, int seed): unread(n), generator(seed) {}
+
+			bool operator () (int &x)
+			{
+				if (!unread) return false;
+				--unread;
+				x = generator();
+				return true;
+			}
+
+		private:
+			std::size_t unread;
+			std::mt19937 generator;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(std::size_t n): readed(0), testSize(n) {}
+
+			bool operator() (int x)
+			{
+				EXPECT_FALSE(readed == testSize) << " extra numbers in output";
+				if (readed > 0) EXPECT_LE(prev, x) << "Error a[" << readed << "] > a[" << readed + 1 << "]";
+				++readed, prev = x;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed, testSize;
+			int prev;
+	};
+
+	ExternalSorter<int, std::less<int> > sorter;
+	std::vector< std::pair<std::size_t, std::size_t> > tests =
+	{
+		{5, 4}, {6, 12}, {7, 8}, {8, 40}, {9, 100}, {10, 8},
+		{100, 12}, {500, 500}, {300500, 48000}, {1000000, 1200000}
+	};
+	std::vector<std::size_t> threads = {1, 2, 3, 4};
+
+	for (size_t i = 0; i < tests.size(); ++i)
+		for (std::size_t t : threads)
+		{
+			RandomSequenceReader reader(tests[i].first, i);
+			SortedSequenceWriter writer(tests[i].first);
+			EXPECT_TRUE(sorter.pipelinedSort(tests[i].second, reader, writer, StandartSorter<int>(), t));
+			EXPECT_EQ(tests[i].first, writer.getReaded()) << "test #" << i << " threads = " << t;
+		}
+}
+
+TEST(ExternalSorter, PipelinedStableSorting)
+{
+	struct Table
+	{
+		int legs;
+		int id;
+
+		bool operator < (const Table &t) const
+		{
+			return legs < t.legs;
+		}
+	};
+
+	class TableReader
+	{
+		public:
+			TableReader(std::size_t n, int seed): generator(seed), readed(0), testSize(n) {}
+
+			bool operator () (Table &a)
+			{
+				if (readed == testSize) return false;
+				a.legs = generator() & 7;
+				a.id = readed++;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t readed, testSize;
+	};
+
+	class SortedTablesWriter
+	{
+		public:
+			SortedTablesWriter(): readed(0) {}
+
+			bool operator() (const Table &x)
+			{
+				if (readed > 0)
+				{
+					EXPECT_LE(prev.legs, x.legs);
+					if (prev.legs == x.legs) EXPECT_LT(prev.id, x.id) << "Stability is broken";
+				}
+				++readed, prev = x;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed;
+			Table prev;
+	};
+
+	ExternalSorter<Table, std::less<Table> > sorter;
+	std::vector< std::pair<std::size_t, std::size_t> > tests =
+	{
+		{5, 1 * sizeof(Table)}, {10, 3 * sizeof(Table)}, {100, 30 * sizeof(Table)}, {100000, 3000 * sizeof(Table)}
+	};
+	for (size_t i = 0; i < tests.size(); ++i)
+	{
+		TableReader reader(tests[i].first, i);
+		SortedTablesWriter writer;
+		EXPECT_TRUE(sorter.pipelinedStableSort(tests[i].second, reader, writer, StandartStableSorter<Table>(), 3));
+		EXPECT_EQ(tests[i].first, writer.getReaded());
+	}
+}
+
+TEST(ExternalSorter, BlockTemporaryIO)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(std::size_t n, int seed): unread(n), generator(seed) {}
+
+			bool operator () (long long &x)
+			{
+				if (!unread) return false;
+				--unread;
+				x = generator();
+				return true;
+			}
+
+		private:
+			std::size_t unread;
+			std::mt19937_64 generator;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(): readed(0) {}
+
+			bool operator() (long long x)
+			{
+				if (readed > 0) EXPECT_LE(prev, x) << "Error a[" << readed << "] > a[" << readed + 1 << "]";
+				++readed, prev = x;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed;
+			long long prev;
+	};
+
+	typedef BlockFileReader<long long> Reader;
+	typedef BlockFileWriter<long long> Writer;
+
+	ExternalSorter<long long, std::less<long long> > sorter;
+	std::vector< std::pair<std::size_t, std::size_t> > tests = {{5, 8}, {100, 80}, {500000, 80000}};
+	for (size_t i = 0; i < tests.size(); ++i)
+	{
+		RandomSequenceReader reader(tests[i].first, i);
+		SortedSequenceWriter writer;
+		EXPECT_TRUE((sorter.sort<RandomSequenceReader, SortedSequenceWriter, StandartSorter<long long>,
+					 Reader, Writer, TempFileIOFactory<Reader, Writer> >
+					 (tests[i].second, reader, writer, StandartSorter<long long>())));
+		EXPECT_EQ(tests[i].first, writer.getReaded());
+	}
+}
+
+TEST(ExternalSorter, ReplacementSelectionRuns)
+{
+	class SequenceReader
+	{
+		public:
+			SequenceReader(std::size_t n, int seed, bool nearlySorted): generator(seed), readed(0),
+																		testSize(n), nearlySorted(nearlySorted) {}
+
+			bool operator () (int &x)
+			{
+				if (readed == testSize) return false;
+				x = nearlySorted ? readed * 10 + generator() % 100 : generator();
+				++readed;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t readed, testSize;
+			bool nearlySorted;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(): readed(0) {}
+
+			bool operator() (int x)
+			{
+				if (readed > 0) EXPECT_LE(prev, x) << "Error a[" << readed << "] > a[" << readed + 1 << "]";
+				++readed, prev = x;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed;
+			int prev;
+	};
+
+	typedef TempFileIOFactory< BinaryFileReader<int>, BinaryFileWriter<int> > BaseFactory;
+
+	class CountingFactory : public BaseFactory
+	{
+		public:
+			CountingFactory(std::size_t &counter): counter(&counter) {}
+
+			std::unique_ptr< BinaryFileWriter<int> > openWriter()
+			{
+				++*counter;
+				return BaseFactory::openWriter();
+			}
+
+		private:
+			std::size_t *counter;
+	};
+
+	ExternalSorter<int, std::less<int> > sorter;
+	const std::size_t n = 200000, heapElements = 5000;
+	const std::size_t memory = heapElements * (sizeof(std::size_t) + sizeof(int) + 4);
+	// writers of intermediate merge passes would be counted as runs
+	sorter.setMergeLimits(0, MergePlanner::openFilesLimit());
+
+	std::size_t runs = 0;
+	SequenceReader randomReader(n, 7, false);
+	SortedSequenceWriter randomWriter;
+	EXPECT_TRUE((sorter.replacementSelectionSort<SequenceReader, SortedSequenceWriter,
+				 BinaryFileReader<int>, BinaryFileWriter<int>, CountingFactory>
+				 (memory, randomReader, randomWriter, CountingFactory(runs))));
+	EXPECT_EQ(n, randomWriter.getReaded());
+	EXPECT_LE(runs, n / heapElements / 2 + 2) << "Runs should be about twice longer than memory";
+
+	runs = 0;
+	SequenceReader sortedReader(n, 7, true);
+	SortedSequenceWriter sortedWriter;
+	EXPECT_TRUE((sorter.replacementSelectionSort<SequenceReader, SortedSequenceWriter,
+				 BinaryFileReader<int>, BinaryFileWriter<int>, CountingFactory>
+				 (memory, sortedReader, sortedWriter, CountingFactory(runs))));
+	EXPECT_EQ(n, sortedWriter.getReaded());
+	EXPECT_EQ(1u, runs);
+}
+
+TEST(ExternalSorter, MultiPassMerge)
+{
+	class ShuffledPermutationReader
+	{
+		public:
+			ShuffledPermutationReader(int n, int seed): position(0), permutation(n)
+			{
+				for (int i = 0; i < n; ++i)
+					permutation[i] = i;
+				std::shuffle(permutation.begin(), permutation.end(), std::mt19937(seed));
+			}
+
+			bool operator () (int &x)
+			{
+				if (position == permutation.size()) return false;
+				x = permutation[position++];
+				return true;
+			}
+
+		private:
+			std::size_t position;
+			std::vector<int> permutation;
+	};
+
+	class SortedPermutationWriter
+	{
+		public:
+			SortedPermutationWriter(): current(0) {}
+
+			bool operator() (int x)
+			{
+				EXPECT_EQ(current, x);
+				current++;
+				return true;
+			}
+
+			int getReaded() const
+			{
+				return current;
+			}
+
+		private:
+			int current;
+	};
+
+	typedef TempFileIOFactory< BinaryFileReader<int>, BinaryFileWriter<int> > BaseFactory;
+
+	class CountingFactory : public BaseFactory
+	{
+		public:
+			CountingFactory(std::size_t &counter): counter(&counter) {}
+
+			std::unique_ptr< BinaryFileWriter<int> > openWriter()
+			{
+				++*counter;
+				return BaseFactory::openWriter();
+			}
+
+		private:
+			std::size_t *counter;
+	};
+
+	ExternalSorter<int, std::less<int> > sorter;
+	const int n = 10000;
+	const std::size_t memory = 100 * sizeof(int);
+
+	// 100 runs merged by 4 at once: 100 -> 25 -> 7 -> 2 -> output
+	sorter.setMergeLimits(0, 5);
+	std::size_t writers = 0;
+	ShuffledPermutationReader reader(n, 3);
+	SortedPermutationWriter writer;
+	EXPECT_TRUE((sorter.sort<ShuffledPermutationReader, SortedPermutationWriter, StandartSorter<int>,
+				 BinaryFileReader<int>, BinaryFileWriter<int>, CountingFactory>
+				 (memory, reader, writer, StandartSorter<int>(), CountingFactory(writers))));
+	EXPECT_EQ(n, writer.getReaded());
+	EXPECT_EQ(100u + 25u + 7u + 2u, writers);
+
+	// read buffers of 96 bytes: (400 - 96) / (96 + 4) = 3 runs at once
+	sorter.setMergeLimits(96, 1000);
+	writers = 0;
+	ShuffledPermutationReader bufferedReader(n, 4);
+	SortedPermutationWriter bufferedWriter;
+	EXPECT_TRUE((sorter.sort<ShuffledPermutationReader, SortedPermutationWriter, StandartSorter<int>,
+				 BinaryFileReader<int>, BinaryFileWriter<int>, CountingFactory>
+				 (memory, bufferedReader, bufferedWriter, StandartSorter<int>(), CountingFactory(writers))));
+	EXPECT_EQ(n, bufferedWriter.getReaded());
+	EXPECT_EQ(100u + 34u + 12u + 4u + 2u, writers);
+}
+
+TEST(ExternalSorter, MappedFileIO)
+{
+	struct Record
+	{
+		unsigned long long key, payload;
+
+		bool operator < (const Record &r) const
+		{
+			return key < r.key;
+		}
+	};
+
+	const char *inputName = "mappedInput.bin", *outputName = "mappedOutput.bin";
+	const std::size_t n = 300000;
+	std::mt19937_64 generator(16);
+	{
+		MappedFileWriter<Record> input(inputName);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			Record record = {generator(), i};
+			ASSERT_TRUE(input(record));
+		}
+	}
+
+	typedef MappedFileReader<Record> Reader;
+	typedef MappedFileWriter<Record> Writer;
+
+	ExternalSorter<Record, std::less<Record> > sorter;
+	{
+		Reader reader(inputName);
+		Writer writer(outputName);
+		EXPECT_TRUE((sorter.sort<Reader, Writer, StandartSorter<Record>,
+					 Reader, Writer, TempFileIOFactory<Reader, Writer> >
+					 (30000 * sizeof(Record), reader, writer, StandartSorter<Record>())));
+	}
+
+	Reader result(outputName);
+	EXPECT_EQ(n, result.remaining());
+	std::vector<bool> seen(n, false);
+	Record previous = {0, 0}, current;
+	while (result(current))
+	{
+		EXPECT_FALSE(current < previous);
+		ASSERT_LT(current.payload, n);
+		EXPECT_FALSE(seen[current.payload]);
+		seen[current.payload] = true;
+		previous = current;
+	}
+	unlink(inputName);
+	unlink(outputName);
+}
+
+TEST(ExternalSorter, RadixSorterChunks)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(std::size_t n, int seed): unread(n), generator(seed) {}
+
+			bool operator () (long long &x)
+			{
+				if (!unread) return false;
+				--unread;
+				x = generator();
+				return true;
+			}
+
+		private:
+			std::size_t unread;
+			std::mt19937_64 generator;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(): readed(0) {}
+
+			bool operator() (long long x)
+			{
+				if (readed > 0) EXPECT_LE(prev, x) << "Error a[" << readed << "] > a[" << readed + 1 << "]";
+				++readed, prev = x;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed;
+			long long prev;
+	};
+
+	typedef RadixSorter<long long, IntegerBitBlockExtractor<long long> > Sorter;
+
+	ExternalSorter<long long, std::less<long long> > sorter;
+	std::vector< std::pair<std::size_t, std::size_t> > tests = {{10, 16}, {1000, 800}, {1000000, 2400000}};
+	for (size_t i = 0; i < tests.size(); ++i)
+	{
+		RandomSequenceReader reader(tests[i].first, i);
+		SortedSequenceWriter writer;
+		EXPECT_TRUE(sorter.sort(tests[i].second, reader, writer, Sorter(4)));
+		EXPECT_EQ(tests[i].first, writer.getReaded());
+	}
+}
+
+TEST(ExternalSorter, ArenaStringSorting)
+{
+	class LogLineReader
+	{
+		public:
+			LogLineReader(std::size_t n, int seed): unread(n), generator(seed) {}
+
+			bool operator () (std::string &line)
+			{
+				if (!unread) return false;
+				--unread;
+				line = "2015-04-" + std::to_string(10 + generator() % 20) + " host" + std::to_string(generator() % 50);
+				std::size_t length = generator() % (generator() % 100 == 0 ? 5000 : 40);
+				for (std::size_t i = 0; i < length; ++i)
+					line += char('a' + generator() % 26);
+				total += line.size();
+				return true;
+			}
+
+			std::size_t totalBytes() const
+			{
+				return total;
+			}
+
+		private:
+			std::size_t unread, total = 0;
+			std::mt19937 generator;
+	};
+
+	class SortedLinesWriter
+	{
+		public:
+			SortedLinesWriter(): readed(0) {}
+
+			bool operator() (const std::string &line)
+			{
+				if (readed > 0) EXPECT_LE(prev, line) << "Error a[" << readed << "] > a[" << readed + 1 << "]";
+				++readed, prev = line;
+				return true;
+			}
+
+			std::size_t getReaded() const
+			{
+				return readed;
+			}
+
+		private:
+			std::size_t readed;
+			std::string prev;
+	};
+
+	typedef TempFileIOFactory< BinaryFileReader<std::string>, BinaryFileWriter<std::string> > BaseFactory;
+
+	class CountingFactory : public BaseFactory
+	{
+		public:
+			CountingFactory(std::size_t &counter): counter(&counter) {}
+
+			std::unique_ptr< BinaryFileWriter<std::string> > openWriter()
+			{
+				++*counter;
+				return BaseFactory::openWriter();
+			}
+
+		private:
+			std::size_t *counter;
+	};
+
+	ExternalSorter<std::string, std::less<std::string> > sorter;
+	std::vector< std::pair<std::size_t, std::size_t> > tests = {{1, 10}, {100, 100}, {1000, 1 << 20}, {100000, 1 << 20}};
+	for (size_t i = 0; i < tests.size(); ++i)
+	{
+		std::size_t runs = 0;
+		LogLineReader reader(tests[i].first, i);
+		SortedLinesWriter writer;
+		EXPECT_TRUE((sorter.arenaSort<LogLineReader, SortedLinesWriter, BinaryFileReader<std::string>,
+					 BinaryFileWriter<std::string>, CountingFactory>
+					 (tests[i].second, reader, writer, CountingFactory(runs))));
+		EXPECT_EQ(tests[i].first, writer.getReaded());
+
+		std::size_t charged = reader.totalBytes() + tests[i].first * sizeof(impl::StringArena::Entry);
+		if (tests[i].first > 1)
+			EXPECT_LE(charged / tests[i].second, runs) << "Arena should not hold more than available memory";
+		if (tests[i].second >= 1 << 20)
+			EXPECT_LE(runs, 2 * charged / tests[i].second + 1) << "Arena should be filled";
+	}
+}
+
+TEST(ExternalSorter, ParallelMerge)
+{
+	struct Record
+	{
+		int key;
+		unsigned int position;
+
+		bool operator < (const Record &r) const
+		{
+			return key < r.key;
+		}
+	};
+
+	class RandomRecordReader
+	{
+		public:
+			RandomRecordReader(std::size_t n, int seed): generator(seed), position(0), n(n) {}
+
+			bool operator () (Record &record)
+			{
+				if (position == n) return false;
+				record.key = generator() % 5000 - 2500;
+				record.position = position++;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t position, n;
+	};
+
+	const char *outputName = "parallelMerge.bin";
+	const std::size_t n = 400000;
+	std::vector< std::pair<std::size_t, std::size_t> > limits = {{1, 1000}, {4, 1000}, {4, 6}}; // threads, open files
+	for (auto limit : limits)
+	{
+		ExternalSorter<Record, std::less<Record> > sorter;
+		sorter.setMergeLimits(0, limit.second);
+		RandomRecordReader reader(n, 42);
+		ASSERT_TRUE((sorter.parallelMergeSort<RandomRecordReader, StandartStableSorter<Record> >
+					 (10000 * sizeof(Record), reader, outputName, StandartStableSorter<Record>(), limit.first)));
+
+		MappedFileReader<Record> result(outputName);
+		ASSERT_EQ(n, result.remaining());
+		Record previous = {-2500, 0}, current;
+		bool first = true;
+		while (result(current))
+		{
+			EXPECT_FALSE(current < previous);
+			if (!first && current.key == previous.key)
+				EXPECT_LT(previous.position, current.position) << "Equal records should keep input order";
+			previous = current, first = false;
+		}
+	}
+	unlink(outputName);
+}
+
+TEST(ExternalSorter, Statistics)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(std::size_t n, int seed): generator(seed), left(n) {}
+
+			bool operator () (long long &x)
+			{
+				if (!left) return false;
+				x = generator() % 1000000;
+				--left;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t left;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(): written(0), previous(0) {}
+
+			bool operator () (long long x)
+			{
+				EXPECT_LE(previous, x);
+				previous = x, ++written;
+				return true;
+			}
+
+			std::size_t written;
+
+		private:
+			long long previous;
+	};
+
+	const std::size_t n = 100000, chunk = 3000;
+	ExternalSorter<long long, std::less<long long>, SortStatistics> sorter;
+	sorter.setMergeLimits(0, 8);
+	RandomSequenceReader reader(n, 7);
+	SortedSequenceWriter writer;
+	ASSERT_TRUE((sorter.sort<RandomSequenceReader, SortedSequenceWriter, StandartSorter<long long> >
+				 (chunk * sizeof(long long), reader, writer, StandartSorter<long long>())));
+	EXPECT_EQ(n, writer.written);
+
+	const SortStatistics &statistics = sorter.getStatistics();
+	std::size_t runs = (n + chunk - 1) / chunk;
+	EXPECT_EQ(n, statistics.phases[SortStatistics::Reading].recordsRead);
+	EXPECT_EQ(n * sizeof(long long), statistics.phases[SortStatistics::Reading].bytesRead);
+	EXPECT_EQ(n, statistics.phases[SortStatistics::OutputWriting].recordsWritten);
+	EXPECT_EQ(n * (1 + statistics.mergePasses), statistics.phases[SortStatistics::SpillWriting].recordsWritten);
+	EXPECT_EQ(n * (1 + statistics.mergePasses), statistics.phases[SortStatistics::Merging].recordsRead);
+	ASSERT_EQ(runs, statistics.runs.size());
+	EXPECT_EQ(chunk, statistics.runs.front());
+	EXPECT_EQ(n % chunk, statistics.runs.back());
+	EXPECT_EQ(1u, statistics.mergePasses);
+	EXPECT_GE(statistics.comparisons, n * (1 + statistics.mergePasses));
+	EXPECT_EQ(chunk * sizeof(long long), statistics.peakBufferBytes);
+	EXPECT_GT(statistics.phases[SortStatistics::Sorting].seconds, 0.0);
+
+	sorter.getStatistics().reset();
+	RandomSequenceReader smallReader(10, 8);
+	SortedSequenceWriter smallWriter;
+	ASSERT_TRUE((sorter.replacementSelectionSort<RandomSequenceReader, SortedSequenceWriter>
+				 (1 << 20, smallReader, smallWriter)));
+	EXPECT_EQ(std::vector<std::uint64_t>({10}), statistics.runs);
+	EXPECT_EQ(10u, statistics.phases[SortStatistics::OutputWriting].recordsWritten);
+}
+
+TEST(ExternalSorter, SpillFileFactory)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(std::size_t n, int seed): generator(seed), left(n) {}
+
+			bool operator () (unsigned int &x)
+			{
+				if (!left) return false;
+				x = generator();
+				--left;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t left;
+	};
+
+	class SortedSequenceWriter
+	{
+		public:
+			SortedSequenceWriter(): written(0), previous(0) {}
+
+			bool operator () (unsigned int x)
+			{
+				EXPECT_LE(previous, x);
+				previous = x, ++written;
+				return true;
+			}
+
+			std::size_t written;
+
+		private:
+			unsigned int previous;
+	};
+
+	typedef SpillRunReader<unsigned int> Reader;
+	typedef SpillRunWriter<unsigned int> Writer;
+	typedef SpillFileIOFactory<unsigned int> Factory;
+
+	const std::size_t n = 500000;
+	ExternalSorter<unsigned int, std::less<unsigned int> > sorter;
+	sorter.setMergeLimits(Reader::defaultBlockSize, 16);
+	RandomSequenceReader reader(n, 31);
+	SortedSequenceWriter writer;
+	Factory factory(Factory::defaultDirectory(), 4096);
+	EXPECT_TRUE((sorter.sort<RandomSequenceReader, SortedSequenceWriter, StandartSorter<unsigned int>,
+				 Reader, Writer, Factory>
+				 (5000 * sizeof(unsigned int), reader, writer, StandartSorter<unsigned int>(), factory)));
+	EXPECT_EQ(n, writer.written);
+	EXPECT_LE(factory.spillFileSize(), 3 * n * sizeof(unsigned int)) << "Extents of merged runs should be reused";
+}
+
+TEST(ExternalSorter, PartialSort)
+{
+	class RandomSequenceReader
+	{
+		public:
+			RandomSequenceReader(const std::vector<int> &data): data(&data), position(0) {}
+
+			bool operator () (int &x)
+			{
+				if (position == data->size()) return false;
+				x = (*data)[position++];
+				return true;
+			}
+
+		private:
+			const std::vector<int> *data;
+			std::size_t position;
+	};
+
+	class VectorWriter
+	{
+		public:
+			bool operator () (int x)
+			{
+				result.push_back(x);
+				return true;
+			}
+
+			std::vector<int> result;
+	};
+
+	std::mt19937 generator(1543);
+	std::vector<int> data(200000);
+	for (int &x : data)
+		x = generator() % 1000000 - 500000;
+	std::vector<int> sorted = data;
+	std::sort(sorted.begin(), sorted.end());
+
+	std::vector< std::pair<std::size_t, std::size_t> > tests = {{10, 1000}, {1000, 1000}, {5000, 3000},
+																 {50000, 3000}, {300000, 3000}, {199999, 20000}};
+	for (auto test : tests)
+	{
+		std::size_t k = test.first, memory = test.second * sizeof(int), runs = 0;
+		ExternalSorter<int, std::less<int>, SortStatistics> sorter;
+		sorter.setMergeLimits(0, 8);
+		RandomSequenceReader reader(data);
+		VectorWriter writer;
+		ASSERT_TRUE((sorter.partialSort<RandomSequenceReader, VectorWriter, StandartSorter<int> >
+					 (memory, k, reader, writer, StandartSorter<int>())));
+		std::size_t expected = std::min(k, data.size());
+		EXPECT_TRUE(std::equal(sorted.begin(), sorted.begin() + expected, writer.result.begin()));
+		EXPECT_EQ(expected, writer.result.size());
+
+		std::size_t spilled = 0;
+		for (std::uint64_t run : sorter.getStatistics().runs)
+		{
+			EXPECT_LE(run, k) << "Run can not be longer than k";
+			spilled += run, ++runs;
+		}
+		if (k <= test.second)
+			EXPECT_EQ(0u, runs) << "Bounded heap should be used for k = " << k;
+		if (k <= data.size() / 10 && k > test.second)
+			EXPECT_LT(spilled, data.size() / 2) << "Most records should be pruned for k = " << k;
+	}
+}
+
+TEST(ExternalSorter, RangeSort)
+{
+	class PermutationReader
+	{
+		public:
+			PermutationReader(int n): generator(n), permutation(n), position(0)
+			{
+				for (int i = 0; i < n; ++i)
+					permutation[i] = i;
+				std::shuffle(permutation.begin(), permutation.end(), generator);
+			}
+
+			bool operator () (int &x)
+			{
+				if (position == permutation.size()) return false;
+				x = permutation[position++];
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::vector<int> permutation;
+			std::size_t position;
+	};
+
+	class RangeWriter
+	{
+		public:
+			RangeWriter(int low): current(low) {}
+
+			bool operator () (int x)
+			{
+				EXPECT_EQ(current, x);
+				++current;
+				return true;
+			}
+
+			int current;
+	};
+
+	ExternalSorter<int, std::less<int> > sorter;
+	PermutationReader reader(100000);
+	RangeWriter writer(25000);
+	ASSERT_TRUE((sorter.rangeSort<PermutationReader, RangeWriter, StandartSorter<int> >
+				 (1000 * sizeof(int), 25000, 42000, reader, writer, StandartSorter<int>())));
+	EXPECT_EQ(42000, writer.current);
+}
+
+TEST(ExternalSorter, UniqueSort)
+{
+	struct Event
+	{
+		int key, count;
+		long long value;
+
+		bool operator < (const Event &e) const
+		{
+			return key < e.key;
+		}
+	};
+
+	struct SumValues
+	{
+		void operator () (Event &accumulated, const Event &next) const
+		{
+			accumulated.value += next.value;
+		}
+	};
+
+	class EventReader
+	{
+		public:
+			EventReader(std::size_t n, int keys, int seed): generator(seed), left(n), keys(keys) {}
+
+			bool operator () (Event &event)
+			{
+				if (!left) return false;
+				event.key = generator() % keys;
+				event.count = 1;
+				event.value = generator() % 1000;
+				--left;
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t left;
+			int keys;
+	};
+
+	class EventWriter
+	{
+		public:
+			bool operator () (const Event &event)
+			{
+				events.push_back(event);
+				return true;
+			}
+
+			std::vector<Event> events;
+	};
+
+	typedef ExternalSorter<Event, std::less<Event>, SortStatistics> Sorter;
+	typedef CountDuplicates<Event, int, &Event::count> CountEvents;
+	const std::size_t n = 200000;
+
+	// keys do not fit into memory: many runs, collapsing happens in the merge too
+	for (int keys : {500, 5000})
+	{
+		std::vector<int> counts(keys, 0);
+		std::vector<long long> sums(keys, 0);
+		EventReader reference(n, keys, keys);
+		Event event;
+		while (reference(event))
+			++counts[event.key], sums[event.key] += event.value;
+
+		Sorter sorter;
+		sorter.setMergeLimits(0, 4);
+		EventReader reader(n, keys, keys);
+		EventWriter writer;
+		ASSERT_TRUE((sorter.uniqueSort<EventReader, EventWriter, StandartStableSorter<Event>, CountEvents>
+					 (1000 * sizeof(Event), reader, writer, StandartStableSorter<Event>())));
+		ASSERT_EQ(std::size_t(keys), writer.events.size());
+		for (int key = 0; key < keys; ++key)
+		{
+			EXPECT_EQ(key, writer.events[key].key);
+			EXPECT_EQ(counts[key], writer.events[key].count);
+		}
+		const SortStatistics &statistics = sorter.getStatistics();
+		if (keys < 1000)
+			EXPECT_EQ(std::vector<std::uint64_t>({std::uint64_t(keys)}), statistics.runs);
+		else
+			EXPECT_GT(statistics.mergePasses, 0u);
+
+		EventReader sumReader(n, keys, keys);
+		EventWriter sumWriter;
+		ASSERT_TRUE((sorter.uniqueSort<EventReader, EventWriter, StandartSorter<Event>, SumValues>
+					 (1000 * sizeof(Event), sumReader, sumWriter, StandartSorter<Event>())));
+		ASSERT_EQ(std::size_t(keys), sumWriter.events.size());
+		for (int key = 0; key < keys; ++key)
+			EXPECT_EQ(sums[key], sumWriter.events[key].value);
+	}
+
+	// KeepFirst with stable Sorter keeps the first of equal elements in input order
+	Sorter sorter;
+	EventReader reader(n, 3000, 5);
+	EventWriter writer;
+	ASSERT_TRUE((sorter.uniqueSort<EventReader, EventWriter, StandartStableSorter<Event> >
+				 (700 * sizeof(Event), reader, writer, StandartStableSorter<Event>())));
+	std::vector<long long> first(3000, -1);
+	EventReader reference(n, 3000, 5);
+	Event event;
+	while (reference(event))
+		if (first[event.key] < 0) first[event.key] = event.value;
+	ASSERT_EQ(3000u, writer.events.size());
+	for (int key = 0; key < 3000; ++key)
+		EXPECT_EQ(first[key], writer.events[key].value);
+}
+
+TEST(ExternalSorter, PresortedChunks)
+{
+	class SegmentsReader
+	{
+		public:
+			SegmentsReader(const std::vector<int> &data): data(data), position(0) {}
+
+			bool operator () (int &x)
+			{
+				if (position == data.size()) return false;
+				x = data[position++];
+				return true;
+			}
+
+		private:
+			std::vector<int> data;
+			std::size_t position;
+	};
+
+	class VectorWriter
+	{
+		public:
+			bool operator () (int x)
+			{
+				data.push_back(x);
+				return true;
+			}
+
+			std::vector<int> data;
+	};
+
+	const std::size_t chunk = 1000;
+	std::mt19937 generator(21);
+	std::vector<int> sorted(20000), appended, reversed, random(20000);
+	for (std::size_t i = 0; i < sorted.size(); ++i)
+		sorted[i] = i;
+	// three sorted segments appended one after another
+	for (int segment = 0; segment < 3; ++segment)
+		for (int i = 0; i < 7000; ++i)
+			appended.push_back(generator() % 100000);
+	for (int segment = 0; segment < 3; ++segment)
+		std::sort(appended.begin() + segment * 7000, appended.begin() + (segment + 1) * 7000);
+	reversed.assign(sorted.rbegin(), sorted.rend());
+	for (int &x : random)
+		x = generator() % 100000;
+
+	// input, maximal number of runs
+	std::vector< std::pair<std::vector<int>, std::size_t> > tests =
+	{
+		{sorted, 1}, {appended, 3}, {reversed, reversed.size() / chunk}, {random, random.size() / chunk}
+	};
+	for (const auto &test : tests)
+	{
+		ExternalSorter<int, std::less<int>, SortStatistics> sorter;
+		SegmentsReader reader(test.first);
+		VectorWriter writer;
+		ASSERT_TRUE((sorter.sort<SegmentsReader, VectorWriter, StandartSorter<int> >
+					 (chunk * sizeof(int), reader, writer, StandartSorter<int>())));
+		std::vector<int> expected = test.first;
+		std::sort(expected.begin(), expected.end());
+		EXPECT_EQ(expected, writer.data);
+		EXPECT_GE(test.second, sorter.getStatistics().runs.size());
+	}
+}
+
+TEST(ExternalSorter, TagSort)
+{
+	struct Trade
+	{
+		long long price;
+		int id;
+		char payload[244];
+
+		bool operator < (const Trade &t) const
+		{
+			return price < t.price;
+		}
+	};
+
+	// signed price mapped to unsigned prefix keeping the order
+	struct PricePrefix
+	{
+		std::uint64_t operator () (const Trade &t) const
+		{
+			return std::uint64_t(t.price) ^ (std::uint64_t(1) << 63);
+		}
+	};
+
+	class TradeReader
+	{
+		public:
+			TradeReader(std::size_t n, int seed): generator(seed), n(n), position(0) {}
+
+			bool operator () (Trade &t)
+			{
+				if (position == n) return false;
+				t.price = static_cast<long long>(generator() % 20000) - 10000;
+				t.id = position++;
+				std::fill(t.payload, t.payload + sizeof(t.payload), char(t.id));
+				return true;
+			}
+
+		private:
+			std::mt19937 generator;
+			std::size_t n, position;
+	};
+
+	class StableTradeWriter
+	{
+		public:
+			StableTradeWriter(): written(0), previous(std::numeric_limits<long long>::min()), previousId(-1) {}
+
+			bool operator () (const Trade &t)
+			{
+				EXPECT_LE(previous, t.price);
+				if (previous == t.price) EXPECT_LT(previousId, t.id);
+				EXPECT_EQ(char(t.id), t.payload[sizeof(t.payload) - 1]);
+				previous = t.price, previousId = t.id, ++written;
+				return true;
+			}
+
+			std::size_t written;
+
+		private:
+			long long previous;
+			int previousId;
+	};
+
+	static_assert(sizeof(Trade) == 256, "Trade record should take 256 bytes");
+	for (std::size_t n : {1u, 1000u, 50000u})
+	{
+		ExternalSorter<Trade, std::less<Trade>, SortStatistics> sorter;
+		sorter.setMergeLimits(0, 6);
+		TradeReader reader(n, n);
+		StableTradeWriter writer;
+		ASSERT_TRUE((sorter.tagSort<TradeReader, StableTradeWriter, PricePrefix>(500 * 272, reader, writer)));
+		EXPECT_EQ(n, writer.written);
+		EXPECT_EQ(n, sorter.getStatistics().phases[SortStatistics::OutputWriting].recordsWritten);
+	}
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "io/blockfilereader.h"
+#include "io/blockfilewriter.h"
+
+#include <cstdio>
+
+#include <vector>
+#include <random>
+
+TEST(BlockFileIO, ElementByElement)
+{
+	const char *fileName = "testFile.txt";
+	std::vector< std::vector<int> > tests = {{0, 1, 58, 185, 294, 1945, -395}, {193, 2941, -1941}, {}};
+	std::vector<std::size_t> blockSizes = {1, 4, 7, 12, 4096};
+	for (auto test : tests)
+		for (auto blockSize : blockSizes)
+		{
+			{
+				BlockFileWriter<int> writer(fileName, blockSize);
+				for (int x : test)
+					ASSERT_TRUE(writer(x));
+			}
+			BlockFileReader<int> reader(fileName, blockSize);
+			int current;
+			for (int x : test)
+			{
+				ASSERT_TRUE(reader(current));
+				EXPECT_EQ(x, current);
+			}
+			ASSERT_FALSE(reader(current));
+		}
+	unlink(fileName);
+}
+
+TEST(BlockFileIO, Spans)
+{
+	struct Record
+	{
+		int key;
+		char payload[13];
+	};
+
+	const char *fileName = "testFile.txt";
+	std::mt19937 generator(2941);
+	std::vector<Record> data(100000);
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		data[i].key = generator();
+		for (int j = 0; j < 13; ++j)
+			data[i].payload[j] = generator();
+	}
+
+	{
+		BlockFileWriter<Record> writer(fileName, 1000);
+		ASSERT_TRUE(writer(data.data(), 777));
+		ASSERT_TRUE(writer(data[777]));
+		ASSERT_TRUE(writer(data.data() + 778, data.size() - 778));
+	}
+
+	BlockFileReader<Record> reader(fileName, 3000);
+	std::vector<Record> result(data.size() + 10);
+	ASSERT_EQ(15u, reader(result.data(), 15));
+	ASSERT_TRUE(reader(result[15]));
+	ASSERT_EQ(data.size() - 16, reader(result.data() + 16, result.size() - 16));
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		ASSERT_EQ(data[i].key, result[i].key);
+		ASSERT_EQ(0, memcmp(data[i].payload, result[i].payload, sizeof(data[i].payload)));
+	}
+	unlink(fileName);
+}
+
+TEST(BlockFileIO, MissingFile)
+{
+	BlockFileReader<int> reader("no/such/file");
+	int x;
+	EXPECT_FALSE(reader.ready());
+	EXPECT_FALSE(reader(x));
+}
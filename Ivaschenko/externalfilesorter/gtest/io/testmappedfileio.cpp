@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "io/mappedfilereader.h"
+#include "io/mappedfilewriter.h"
+
+#include <cstdio>
+
+#include <vector>
+#include <random>
+
+#include <sys/stat.h>
+
+TEST(MappedFileIO, ElementByElement)
+{
+	const char *fileName = "testFile.txt";
+	std::vector< std::vector<int> > tests = {{0, 1, 58, 185, 294, 1945, -395}, {193, 2941, -1941}, {}};
+	std::vector<std::size_t> windowSizes = {1, 4096, 1 << 20};
+	for (auto test : tests)
+		for (auto windowSize : windowSizes)
+		{
+			{
+				MappedFileWriter<int> writer(fileName, windowSize);
+				ASSERT_TRUE(writer.ready());
+				for (int x : test)
+					ASSERT_TRUE(writer(x));
+				ASSERT_TRUE(writer.close());
+				ASSERT_FALSE(writer(0)) << "Closed writer should not accept elements";
+			}
+			struct stat info;
+			ASSERT_EQ(0, stat(fileName, &info));
+			EXPECT_EQ(test.size() * sizeof(int), static_cast<std::size_t>(info.st_size)) << "File should be truncated";
+
+			MappedFileReader<int> reader(fileName);
+			ASSERT_TRUE(reader.ready());
+			EXPECT_EQ(test.size(), reader.remaining());
+			int current;
+			for (int x : test)
+			{
+				ASSERT_TRUE(reader(current));
+				EXPECT_EQ(x, current);
+			}
+			ASSERT_FALSE(reader(current));
+		}
+	unlink(fileName);
+}
+
+TEST(MappedFileIO, SpansAcrossWindows)
+{
+	struct Record
+	{
+		long long key;
+		char payload[8];
+	};
+
+	const char *fileName = "testFile.txt";
+	std::mt19937 generator(1945);
+	std::vector<Record> data(100000);
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		data[i].key = generator();
+		for (int j = 0; j < 8; ++j)
+			data[i].payload[j] = generator();
+	}
+
+	{
+		// 4096 bytes window is not a multiple of 24 bytes of the record
+		struct Wide
+		{
+			Record record;
+			int tail[2];
+		};
+		MappedFileWriter<Wide> wideWriter(fileName, 4096);
+		Wide wide = Wide();
+		for (std::size_t i = 0; i < 1000; ++i)
+		{
+			wide.record = data[i];
+			ASSERT_TRUE(wideWriter(wide));
+		}
+	}
+	{
+		MappedFileWriter<Record> writer(fileName, 4096);
+		ASSERT_TRUE(writer(data.data(), 777));
+		ASSERT_TRUE(writer(data[777]));
+		ASSERT_TRUE(writer(data.data() + 778, data.size() - 778));
+	}
+
+	MappedFileReader<Record> reader(fileName);
+	std::vector<Record> result(data.size() + 10);
+	ASSERT_EQ(15u, reader(result.data(), 15));
+	ASSERT_TRUE(reader(result[15]));
+	ASSERT_EQ(data.size() - 16, reader(result.data() + 16, result.size() - 16));
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		ASSERT_EQ(data[i].key, result[i].key);
+		ASSERT_EQ(0, memcmp(data[i].payload, result[i].payload, sizeof(data[i].payload)));
+	}
+	unlink(fileName);
+}
+
+TEST(MappedFileIO, MissingFile)
+{
+	MappedFileReader<int> reader("no/such/file");
+	int x;
+	EXPECT_FALSE(reader.ready());
+	EXPECT_FALSE(reader(x));
+
+	MappedFileWriter<int> writer("no/such/file");
+	EXPECT_FALSE(writer.ready());
+	EXPECT_FALSE(writer(x));
+	EXPECT_FALSE(writer.close());
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sorters/radixsorter.h"
+
+#include "utils/integerbitblockextractor.h"
+
+namespace
+{
+	template<typename IntegerType, typename Generator>
+	void checkRandomSorting(std::size_t n, std::size_t threads, Generator generate)
+	{
+		std::vector<IntegerType> data(n);
+		for (auto &x : data)
+			x = generate();
+		std::vector<IntegerType> answer = data;
+		std::sort(answer.begin(), answer.end());
+
+		RadixSorter<IntegerType, IntegerBitBlockExtractor<IntegerType> > sorter(threads);
+		sorter(data.begin(), data.end());
+		EXPECT_EQ(answer, data) << "n = " << n << " threads = " << threads;
+	}
+
+	/*
+	 * Pair sorted by the first element only, second one is the initial position
+	 */
+	struct KeyedItem
+	{
+		unsigned key, position;
+	};
+
+	class KeyExtractor
+	{
+		public:
+			template<typename ForwardIterator>
+			KeyExtractor(ForwardIterator begin, ForwardIterator end) {}
+
+			std::size_t getBlocksNumber() const
+			{
+				return 4;
+			}
+
+			std::size_t getBlockRange(std::size_t block) const
+			{
+				return 1 << 8;
+			}
+
+			std::size_t operator() (const KeyedItem &item, std::size_t block)
+			{
+				return (item.key >> (block << 3)) & 0xFF;
+			}
+	};
+}
+
+TEST(RadixSorter, ManualTests)
+{
+	std::vector< std::vector<int> > tests =
+	{
+		{},
+		{5},
+		{1, -1, 0},
+		{454, -19848, -29495839, -198482, 921, 9482, -294},
+		{1, -1, 1, -1, 1, 1, -1, -1, 1, 0, 0, 0},
+		{7, 7, 7, 7}
+	};
+
+	RadixSorter<int, IntegerBitBlockExtractor<int> > sorter;
+	for (auto test : tests)
+	{
+		std::vector<int> answer = test, output = test;
+		std::sort(answer.begin(), answer.end());
+		sorter(output.begin(), output.end());
+		EXPECT_EQ(answer, output);
+	}
+}
+
+TEST(RadixSorter, RandomIntegers)
+{
+	std::mt19937_64 generator(2015);
+	for (std::size_t threads : {1, 2, 3, 8})
+	{
+		checkRandomSorting<unsigned>(1000, threads, [&] { return unsigned(generator()); });
+		checkRandomSorting<int>(300000, threads, [&] { return int(generator()); });
+		checkRandomSorting<long long>(300000, threads, [&] { return (long long) generator(); });
+		checkRandomSorting<unsigned long long>(300000, threads, [&] { return generator(); });
+	}
+}
+
+TEST(RadixSorter, SkippedBlocks)
+{
+	std::mt19937_64 generator(42);
+	// only the lowest 16 bits differ: three of four passes are skipped
+	checkRandomSorting<unsigned long long>(200000, 4, [&] { return (5ull << 40) + generator() % 60000; });
+	checkRandomSorting<long long>(200000, 2, [&] { return -(long long)(generator() % 1000); });
+	// only the highest block differs
+	checkRandomSorting<unsigned long long>(200000, 3, [&] { return (generator() % 7) << 50; });
+}
+
+TEST(RadixSorter, Stability)
+{
+	std::mt19937 generator(7);
+	for (std::size_t threads : {1, 4})
+	{
+		std::vector<KeyedItem> items(200000);
+		for (std::size_t i = 0; i < items.size(); ++i)
+		{
+			items[i].key = generator() % 1000 * 65536;
+			items[i].position = i;
+		}
+
+		RadixSorter<KeyedItem, KeyExtractor> sorter(threads);
+		sorter(items.begin(), items.end());
+		for (std::size_t i = 1; i < items.size(); ++i)
+		{
+			ASSERT_LE(items[i - 1].key, items[i].key);
+			if (items[i - 1].key == items[i].key)
+				ASSERT_LT(items[i - 1].position, items[i].position);
+		}
+	}
+}
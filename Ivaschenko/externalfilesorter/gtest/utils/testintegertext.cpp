@@ -0,0 +1,96 @@
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/integertext.h"
+#include "io/inputstreamreader.h"
+#include "io/outputstreamwriter.h"
+
+namespace
+{
+	template<typename IntegerType> std::string format(IntegerType value)
+	{
+		char text[24];
+		char *end = text + sizeof(text);
+		return std::string(impl::formatDecimal(value, end), end);
+	}
+
+	template<typename IntegerType> std::string streamed(IntegerType value)
+	{
+		std::ostringstream out;
+		out << value;
+		return out.str();
+	}
+}
+
+/*
+ * Comparing formatDecimal with operator << on bounds and random values
+ */
+TEST(IntegerText, FormatDecimal)
+{
+	EXPECT_EQ(format(0), "0");
+	EXPECT_EQ(format(-7), "-7");
+	EXPECT_EQ(format(10), "10");
+	EXPECT_EQ(format(99), "99");
+	EXPECT_EQ(format(100), "100");
+	EXPECT_EQ(format(std::numeric_limits<int>::min()), streamed(std::numeric_limits<int>::min()));
+	EXPECT_EQ(format(std::numeric_limits<long long>::min()), streamed(std::numeric_limits<long long>::min()));
+	EXPECT_EQ(format(std::numeric_limits<unsigned long long>::max()), streamed(std::numeric_limits<unsigned long long>::max()));
+	EXPECT_EQ(format(std::numeric_limits<short>::min()), streamed(std::numeric_limits<short>::min()));
+
+	std::mt19937_64 generator(1823);
+	for (int i = 0; i < 10000; ++i)
+	{
+		long long value = static_cast<long long>(generator()) >> (generator() % 64);
+		ASSERT_EQ(format(value), streamed(value));
+	}
+}
+
+/*
+ * Writing integers by OutputStreamWriter and reading them back through block boundaries
+ */
+TEST(IntegerText, WriteAndReadBack)
+{
+	std::mt19937_64 generator(4431);
+	std::vector<long long> answer;
+	for (std::size_t i = 0; i < InputStreamReader<long long>::blockSize / 4; ++i)
+		answer.push_back(static_cast<long long>(generator()) >> (generator() % 64));
+	answer.push_back(std::numeric_limits<long long>::min());
+	answer.push_back(-5);
+
+	std::ostringstream out;
+	OutputStreamWriter<long long> writer(out);
+	writer.setDelimeter(" ");
+	for (long long value : answer)
+		ASSERT_TRUE(writer(value));
+
+	std::string text = out.str();
+	std::istringstream in(text);
+	InputStreamReader<long long> reader(in);
+	std::vector<long long> result;
+	long long value;
+	while (reader(value))
+		result.push_back(value);
+	EXPECT_EQ(result, answer);
+	EXPECT_TRUE(in.eof());
+}
+
+/*
+ * Formats other than plain decimal are written by operator <<
+ */
+TEST(IntegerText, WriterKeepsStreamFormat)
+{
+	std::ostringstream out;
+	OutputStreamWriter<int> writer(out);
+	writer.setDelimeter(",");
+	ASSERT_TRUE(writer(255));
+	out << std::hex;
+	ASSERT_TRUE(writer(255));
+	out << std::dec << std::showpos;
+	ASSERT_TRUE(writer(255));
+	EXPECT_EQ(out.str(), "255,ff,+255");
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/losertree.h"
+
+namespace
+{
+	/*
+	 * Merges sequences with LoserTree, returns pairs (value, sequence index) in output order
+	 */
+	template<bool Stable>
+	std::vector< std::pair<int, std::size_t> > mergeSequences(const std::vector< std::vector<int> > &sequences)
+	{
+		LoserTree<int, std::less<int>, Stable> tree(sequences.size());
+		std::vector<std::size_t> position(sequences.size(), 0);
+		for (std::size_t i = 0; i < sequences.size(); ++i)
+			if (!sequences[i].empty())
+			{
+				tree.head(i) = sequences[i][position[i]++];
+				tree.activate(i);
+			}
+		tree.build();
+
+		std::vector< std::pair<int, std::size_t> > result;
+		while (!tree.empty())
+		{
+			std::size_t current = tree.winner();
+			result.push_back(std::make_pair(tree.top(), current));
+			if (position[current] < sequences[current].size())
+			{
+				tree.top() = sequences[current][position[current]++];
+				tree.update();
+			}
+			else
+				tree.exhaust();
+		}
+		return result;
+	}
+}
+
+TEST(LoserTree, ManualMerging)
+{
+	std::vector< std::vector< std::vector<int> > > tests =
+	{
+		{},
+		{{}},
+		{{1, 2, 3}},
+		{{1, 4, 7}, {2, 5, 8}, {3, 6, 9}},
+		{{}, {5}, {}, {1, 1, 1}, {0, 10}},
+		{{-5, 0, 5}, {}, {}, {}, {}, {-10, 20}, {3}}
+	};
+
+	for (auto test : tests)
+	{
+		std::vector<int> answer;
+		for (auto sequence : test)
+			answer.insert(answer.end(), sequence.begin(), sequence.end());
+		std::sort(answer.begin(), answer.end());
+
+		std::vector<int> output;
+		for (auto element : mergeSequences<false>(test))
+			output.push_back(element.first);
+		EXPECT_EQ(answer, output);
+	}
+}
+
+TEST(LoserTree, StableRandomMerging)
+{
+	std::mt19937 generator(1942);
+	for (std::size_t ways = 1; ways < 40; ++ways)
+	{
+		std::vector< std::vector<int> > sequences(ways);
+		for (auto &sequence : sequences)
+		{
+			sequence.resize(generator() % 50);
+			for (auto &x : sequence)
+				x = generator() % 10;
+			std::sort(sequence.begin(), sequence.end());
+		}
+
+		std::vector< std::pair<int, std::size_t> > answer;
+		for (std::size_t i = 0; i < ways; ++i)
+			for (int x : sequences[i])
+				answer.push_back(std::make_pair(x, i));
+		std::sort(answer.begin(), answer.end());
+
+		EXPECT_EQ(answer, mergeSequences<true>(sequences)) << "ways = " << ways;
+	}
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "utils/mergeplanner.h"
+#include "io/blockfilereader.h"
+#include "io/binaryfilereader.h"
+
+TEST(MergePlanner, FanIn)
+{
+	EXPECT_EQ(9u, MergePlanner(1000, 4, 96, 1000).fanIn());
+	EXPECT_EQ(4u, MergePlanner(1000, 4, 96, 5).fanIn());
+	EXPECT_EQ(250u, MergePlanner(1000, 4, 0, 1000).fanIn());
+	EXPECT_EQ(2u, MergePlanner(10, 4, 96, 1000).fanIn()) << "At least two runs should be merged at once";
+	EXPECT_EQ(2u, MergePlanner(1000, 4, 0, 1).fanIn());
+}
+
+TEST(MergePlanner, Passes)
+{
+	MergePlanner planner(1000, 4, 0, 5);
+	EXPECT_EQ(1u, planner.passes(1));
+	EXPECT_EQ(1u, planner.passes(4));
+	EXPECT_EQ(2u, planner.passes(5));
+	EXPECT_EQ(2u, planner.passes(16));
+	EXPECT_EQ(3u, planner.passes(17));
+	EXPECT_EQ(4u, planner.passes(100));
+}
+
+TEST(MergePlanner, BalancedGroups)
+{
+	MergePlanner planner(1000, 4, 0, 5);
+	EXPECT_EQ(std::vector<std::size_t>({4}), planner.nextPass(4));
+	EXPECT_EQ(std::vector<std::size_t>({3, 2}), planner.nextPass(5));
+	EXPECT_EQ(std::vector<std::size_t>({4, 4, 4, 4, 3, 3, 3}), planner.nextPass(25));
+
+	std::vector<std::size_t> groups = planner.nextPass(100);
+	std::size_t total = 0;
+	for (std::size_t group : groups)
+	{
+		EXPECT_LE(group, planner.fanIn());
+		total += group;
+	}
+	EXPECT_EQ(100u, total);
+	EXPECT_EQ(25u, groups.size());
+}
+
+TEST(MergePlanner, OpenFilesLimit)
+{
+	EXPECT_GE(MergePlanner::openFilesLimit(), 3u);
+}
+
+TEST(MergePlanner, ReaderBufferSize)
+{
+	EXPECT_EQ(BlockFileReader<int>::defaultBlockSize, MergePlanner::readerBufferSize< BlockFileReader<int> >());
+	EXPECT_EQ(std::size_t(BUFSIZ), MergePlanner::readerBufferSize< BinaryFileReader<int> >());
+}
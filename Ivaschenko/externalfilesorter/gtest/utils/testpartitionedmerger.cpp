@@ -0,0 +1,114 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utils/partitionedmerger.h"
+#include "io/mappedfilereader.h"
+
+namespace
+{
+	struct Item
+	{
+		int key, run;
+
+		bool operator == (const Item &item) const
+		{
+			return key == item.key && run == item.run;
+		}
+	};
+
+	struct KeyLess
+	{
+		bool operator () (const Item &a, const Item &b) const
+		{
+			return a.key < b.key;
+		}
+	};
+
+	Item item(int key, int run)
+	{
+		Item result = {key, run};
+		return result;
+	}
+
+	std::vector<Item> readAll(const char *fileName)
+	{
+		MappedFileReader<Item> reader(fileName);
+		return std::vector<Item>(reader.begin(), reader.end());
+	}
+}
+
+TEST(PartitionedMerger, Splitters)
+{
+	PartitionedMerger<int, std::less<int> > merger({9, 1, 5, 3, 7, 2, 8, 4, 6, 0}, 5);
+	EXPECT_EQ(5u, merger.partitions());
+
+	PartitionedMerger<int, std::less<int> > duplicates({1, 1, 1, 1, 1, 1, 2, 2}, 4);
+	EXPECT_EQ(3u, duplicates.partitions()) << "Equal splitters should be merged";
+
+	PartitionedMerger<int, std::less<int> > empty({}, 8);
+	EXPECT_EQ(1u, empty.partitions());
+}
+
+/*
+ * Merging random runs with many equal keys by several threads, result is compared with std::stable_sort
+ */
+TEST(PartitionedMerger, StableParallelMerging)
+{
+	const char *fileName = "partitionedMerge.bin";
+	std::mt19937 generator(75);
+	std::vector< std::vector<Item> > runs(13);
+	std::vector<Item> samples, answer;
+	for (std::size_t run = 0; run < runs.size(); ++run)
+	{
+		std::size_t length = generator() % 20000;
+		for (std::size_t i = 0; i < length; ++i)
+			runs[run].push_back(item(generator() % 1000, run));
+		std::sort(runs[run].begin(), runs[run].end(), KeyLess());
+		for (std::size_t i = 0; i < runs[run].size(); i += 100)
+			samples.push_back(runs[run][i]);
+		answer.insert(answer.end(), runs[run].begin(), runs[run].end());
+	}
+	std::stable_sort(answer.begin(), answer.end(), KeyLess());
+
+	for (std::size_t threads : {1, 3, 8})
+	{
+		PartitionedMerger<Item, KeyLess, true> merger(samples, threads * 4);
+		for (const std::vector<Item> &run : runs)
+			merger.addRun(run.data(), run.data() + run.size());
+		EXPECT_EQ(answer.size(), merger.size());
+		ASSERT_TRUE(merger.merge(fileName, threads, 1000));
+		EXPECT_TRUE(readAll(fileName) == answer) << "Wrong result with " << threads << " threads";
+	}
+	unlink(fileName);
+}
+
+/*
+ * Splitters taken from a skewed sample still give correct result
+ */
+TEST(PartitionedMerger, UnrepresentativeSample)
+{
+	const char *fileName = "partitionedMerge.bin";
+	std::vector<Item> first, second;
+	for (int i = 0; i < 5000; ++i)
+	{
+		first.push_back(item(2 * i, 0));
+		second.push_back(item(2 * i + 1, 1));
+	}
+
+	PartitionedMerger<Item, KeyLess> merger({item(-5, 0), item(3, 0), item(100000, 0)}, 3);
+	merger.addRun(first.data(), first.data() + first.size());
+	merger.addRun(second.data(), second.data() + second.size());
+	ASSERT_TRUE(merger.merge(fileName, 3, 64));
+
+	std::vector<Item> result = readAll(fileName);
+	ASSERT_EQ(10000u, result.size());
+	for (int i = 0; i < 10000; ++i)
+		EXPECT_EQ(i, result[i].key);
+	unlink(fileName);
+}
@@ -0,0 +1,74 @@
+#include <vector>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <gtest/gtest.h>
+
+#include "utils/presortedness.h"
+
+TEST(Presortedness, Kinds)
+{
+	std::vector<int> sorted = {1, 2, 2, 3, 7};
+	EXPECT_EQ(impl::ChunkOrder::Sorted, impl::orderPresorted(sorted.begin(), sorted.end(), std::less<int>(), 4));
+
+	std::vector<int> reversed = {9, 5, 3, 1};
+	EXPECT_EQ(impl::ChunkOrder::Reversed,
+			  impl::orderPresorted(reversed.begin(), reversed.end(), std::less<int>(), 4));
+	EXPECT_EQ(std::vector<int>({1, 3, 5, 9}), reversed);
+
+	std::vector<int> notStrictlyReversed = {9, 5, 5, 1};
+	EXPECT_EQ(impl::ChunkOrder::FewRuns,
+			  impl::orderPresorted(notStrictlyReversed.begin(), notStrictlyReversed.end(), std::less<int>(), 4));
+	EXPECT_EQ(std::vector<int>({1, 5, 5, 9}), notStrictlyReversed);
+
+	std::vector<int> runs = {4, 8, 12, 1, 5, 9, 2, 6, 10};
+	EXPECT_EQ(impl::ChunkOrder::FewRuns, impl::orderPresorted(runs.begin(), runs.end(), std::less<int>(), 4));
+	EXPECT_EQ(std::vector<int>({1, 2, 4, 5, 6, 8, 9, 10, 12}), runs);
+
+	std::vector<int> unordered = {5, 1, 4, 2, 3, 0, 6, 1, 3};
+	std::vector<int> copy = unordered;
+	EXPECT_EQ(impl::ChunkOrder::Unordered,
+			  impl::orderPresorted(unordered.begin(), unordered.end(), std::less<int>(), 4));
+	EXPECT_EQ(copy, unordered) << "Unordered chunk must be left untouched";
+
+	std::vector<int> descendingPrefix = {6, 5, 4, 3, 2, 7};
+	std::vector<int> prefixCopy = descendingPrefix;
+	EXPECT_EQ(impl::ChunkOrder::Unordered,
+			  impl::orderPresorted(descendingPrefix.begin(), descendingPrefix.end(), std::less<int>(), 4));
+	EXPECT_EQ(prefixCopy, descendingPrefix);
+	EXPECT_EQ(impl::ChunkOrder::FewRuns,
+			  impl::orderPresorted(descendingPrefix.begin(), descendingPrefix.end(), std::less<int>(), 5));
+	EXPECT_EQ(std::vector<int>({2, 3, 4, 5, 6, 7}), descendingPrefix);
+
+	std::vector<int> empty, single = {1};
+	EXPECT_EQ(impl::ChunkOrder::Sorted, impl::orderPresorted(empty.begin(), empty.end(), std::less<int>(), 1));
+	EXPECT_EQ(impl::ChunkOrder::Sorted, impl::orderPresorted(single.begin(), single.end(), std::less<int>(), 1));
+}
+
+TEST(Presortedness, NaturalMergeIsStable)
+{
+	typedef std::pair<int, int> Item; // key and position in input
+	auto byKey = [](const Item &a, const Item &b) { return a.first < b.first; };
+	std::mt19937 generator(3);
+
+	for (std::size_t runCount = 1; runCount <= 7; ++runCount)
+	{
+		std::vector<Item> items;
+		for (std::size_t run = 0; run < runCount; ++run)
+		{
+			std::vector<int> keys(50 + generator() % 50);
+			for (int &key : keys)
+				key = generator() % 40;
+			std::sort(keys.begin(), keys.end());
+			for (int key : keys)
+				items.push_back(Item(key, items.size()));
+		}
+		std::vector<Item> expected = items;
+		std::stable_sort(expected.begin(), expected.end(), byKey);
+
+		impl::orderPresorted(items.begin(), items.end(), byKey, 8);
+		EXPECT_EQ(expected, items);
+	}
+}
@@ -0,0 +1,66 @@
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "utils/sortstatistics.h"
+
+TEST(SortStatistics, Recording)
+{
+	static_assert(std::is_empty<NoSortStatistics>::value, "NoSortStatistics should not take memory");
+
+	SortStatistics statistics;
+	std::vector<int> numbers = {5, 4, 3};
+	std::vector<std::string> strings = {"abc", "", "de"};
+	statistics.read(SortStatistics::Reading, numbers.data(), numbers.size());
+	statistics.read(SortStatistics::Reading, strings.data(), strings.size());
+	statistics.written(SortStatistics::OutputWriting, 2, 10);
+	statistics.run(3);
+	statistics.run(7);
+	statistics.buffer(100);
+	statistics.buffer(50);
+	statistics.mergePass();
+
+	impl::CountingComparator< std::less<int> > cmp = statistics.comparator< std::less<int> >();
+	EXPECT_TRUE(cmp(1, 2));
+	EXPECT_FALSE(cmp(2, 1));
+
+	EXPECT_EQ(6u, statistics.phases[SortStatistics::Reading].recordsRead);
+	EXPECT_EQ(3 * sizeof(int) + 5, statistics.phases[SortStatistics::Reading].bytesRead);
+	EXPECT_EQ(2u, statistics.phases[SortStatistics::OutputWriting].recordsWritten);
+	EXPECT_EQ(10u, statistics.phases[SortStatistics::OutputWriting].bytesWritten);
+	EXPECT_EQ(std::vector<std::uint64_t>({3, 7}), statistics.runs);
+	EXPECT_EQ(100u, statistics.peakBufferBytes);
+	EXPECT_EQ(1u, statistics.mergePasses);
+	EXPECT_EQ(2u, statistics.comparisons);
+
+	{
+		SortStatistics::Timer timer(statistics, SortStatistics::Sorting);
+	}
+	EXPECT_GE(statistics.phases[SortStatistics::Sorting].seconds, 0.0);
+
+	statistics.reset();
+	EXPECT_TRUE(statistics.runs.empty());
+	EXPECT_EQ(0u, statistics.phases[SortStatistics::Reading].recordsRead);
+	EXPECT_EQ(0u, statistics.comparisons);
+}
+
+TEST(SortStatistics, Json)
+{
+	SortStatistics statistics;
+	statistics.run(12);
+	statistics.run(5);
+	statistics.written(SortStatistics::SpillWriting, 17, 68);
+
+	std::string json = statistics.toJson();
+	EXPECT_EQ('{', json.front());
+	EXPECT_EQ('}', json.back());
+	EXPECT_NE(std::string::npos, json.find("\"runs\": [12, 5]"));
+	EXPECT_NE(std::string::npos, json.find("\"spillWriting\": {\"recordsRead\": 0, \"bytesRead\": 0, "
+										   "\"recordsWritten\": 17, \"bytesWritten\": 68"));
+	for (const char *key : {"reading", "sorting", "merging", "outputWriting", "mergePasses", "comparisons",
+							"peakBufferBytes"})
+		EXPECT_NE(std::string::npos, json.find(std::string("\"") + key + "\"")) << key;
+}
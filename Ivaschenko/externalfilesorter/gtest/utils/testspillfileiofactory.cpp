@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "utils/spillfileiofactory.h"
+
+#include <vector>
+#include <random>
+
+namespace
+{
+	struct Record
+	{
+		int key;
+		char payload[13];
+	};
+}
+
+/*
+ * Runs of different lengths with records crossing extent and block bounds are read back in order
+ */
+TEST(SpillFileIOFactory, RunsAreReadInOrder)
+{
+	std::mt19937 generator(1204);
+	std::vector< std::vector<Record> > runs(7);
+	for (std::size_t run = 0; run < runs.size(); ++run)
+	{
+		runs[run].resize(generator() % 5000);
+		for (Record &record : runs[run])
+		{
+			record.key = generator();
+			for (char &c : record.payload) c = generator();
+		}
+	}
+	runs[3].clear();
+
+	SpillFileIOFactory<Record> factory(SpillFileIOFactory<Record>::defaultDirectory(), 1000, 77, 300);
+	ASSERT_TRUE(factory.ready());
+	for (std::size_t run = 0; run < runs.size(); ++run)
+	{
+		std::unique_ptr< SpillRunWriter<Record> > writer = factory.openWriter();
+		if (run % 2)
+			ASSERT_TRUE(writer->operator() (runs[run].data(), runs[run].size()));
+		else
+			for (const Record &record : runs[run])
+				ASSERT_TRUE(writer->operator() (record));
+	}
+
+	for (std::size_t run = 0; run < runs.size(); ++run)
+	{
+		std::unique_ptr< SpillRunReader<Record> > reader = factory.openReader();
+		std::vector<Record> result(runs[run].size() + 1);
+		if (run % 2)
+			ASSERT_EQ(runs[run].size(), reader->operator() (result.data(), result.size()));
+		else
+		{
+			for (std::size_t i = 0; i < runs[run].size(); ++i)
+				ASSERT_TRUE(reader->operator() (result[i]));
+			Record extra;
+			EXPECT_FALSE(reader->operator() (extra));
+		}
+		for (std::size_t i = 0; i < runs[run].size(); ++i)
+			ASSERT_EQ(0, std::memcmp(&runs[run][i], &result[i], sizeof(Record))) << "Run #" << run << ", record #" << i;
+		EXPECT_TRUE(reader->ready());
+	}
+}
+
+/*
+ * Extents of runs which were read are given to the next runs, file does not grow
+ */
+TEST(SpillFileIOFactory, ExtentsAreReused)
+{
+	SpillFileIOFactory<int> factory(SpillFileIOFactory<int>::defaultDirectory(), 4096);
+	std::vector<int> data(10000);
+	for (std::size_t i = 0; i < data.size(); ++i)
+		data[i] = i;
+
+	{
+		std::unique_ptr< SpillRunWriter<int> > writer = factory.openWriter();
+		ASSERT_TRUE(writer->operator() (data.data(), data.size()));
+	}
+	std::uint64_t size = factory.spillFileSize();
+	EXPECT_EQ(10u * 4096, size);
+
+	for (int pass = 0; pass < 5; ++pass)
+	{
+		std::unique_ptr< SpillRunReader<int> > reader = factory.openReader();
+		std::unique_ptr< SpillRunWriter<int> > writer = factory.openWriter();
+		int x;
+		while (reader->operator() (x))
+			ASSERT_TRUE(writer->operator() (x + 1));
+		reader.reset();
+	}
+	EXPECT_LE(factory.spillFileSize(), 2 * size);
+
+	std::unique_ptr< SpillRunReader<int> > reader = factory.openReader();
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		int x;
+		ASSERT_TRUE(reader->operator() (x));
+		EXPECT_EQ(data[i] + 5, x);
+	}
+}
+
+TEST(SpillFileIOFactory, MissingDirectory)
+{
+	SpillFileIOFactory<int> factory("/nonexistent/directory");
+	EXPECT_FALSE(factory.ready());
+	std::unique_ptr< SpillRunWriter<int> > writer = factory.openWriter();
+	EXPECT_FALSE(writer->operator() (5) && writer->flush());
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/stringarena.h"
+
+namespace
+{
+	std::vector<std::string> sortWithArena(const std::vector<std::string> &strings, std::size_t capacity)
+	{
+		impl::StringArena arena(capacity);
+		for (const std::string &s : strings)
+		{
+			EXPECT_TRUE(arena.fits(s.size()));
+			arena.push(s.data(), s.size());
+		}
+		arena.sort();
+
+		std::vector<std::string> result;
+		for (std::size_t i = 0; i < arena.size(); ++i)
+			result.push_back(std::string(arena.data(i), arena.length(i)));
+		return result;
+	}
+}
+
+TEST(StringArena, ManualTests)
+{
+	std::vector< std::vector<std::string> > tests =
+	{
+		{},
+		{"single"},
+		{"b", "a", "", "ab", "a"},
+		{"prefix_same_1", "prefix_same_0", "prefix_s", "prefix_", "prefix_same_00"},
+		{std::string("a\0b", 3), std::string("a\0", 2), "a", std::string("a\0a", 3)},
+		{"\xff\xfe", "\x01", "zzz", "\x80 high bit"}
+	};
+
+	for (auto test : tests)
+	{
+		std::vector<std::string> answer = test;
+		std::sort(answer.begin(), answer.end());
+		EXPECT_EQ(answer, sortWithArena(test, 4096));
+	}
+}
+
+TEST(StringArena, RandomStrings)
+{
+	std::mt19937 generator(9);
+	std::vector<std::string> strings(20000);
+	for (std::string &s : strings)
+	{
+		s = "2015-03-0" + std::to_string(generator() % 3) + " ";
+		std::size_t length = generator() % 30;
+		for (std::size_t i = 0; i < length; ++i)
+			s += char('a' + generator() % 4);
+	}
+	std::vector<std::string> answer = strings;
+	std::sort(answer.begin(), answer.end());
+	EXPECT_EQ(answer, sortWithArena(strings, 2000000));
+}
+
+TEST(StringArena, Accounting)
+{
+	typedef impl::StringArena::Entry Entry;
+	impl::StringArena arena(10 * sizeof(Entry));
+	EXPECT_TRUE(arena.empty());
+	EXPECT_FALSE(arena.fits(10 * sizeof(Entry)));
+	EXPECT_TRUE(arena.fits(9 * sizeof(Entry)));
+
+	std::string s(sizeof(Entry), 'x');
+	for (int i = 0; i < 5; ++i)
+	{
+		ASSERT_TRUE(arena.fits(s.size()));
+		arena.push(s.data(), s.size());
+	}
+	EXPECT_EQ(10 * sizeof(Entry), arena.usedBytes());
+	EXPECT_FALSE(arena.fits(0));
+
+	arena.clear();
+	EXPECT_TRUE(arena.empty());
+	EXPECT_EQ(0u, arena.usedBytes());
+	EXPECT_TRUE(arena.fits(9 * sizeof(Entry)));
+}
@@ -0,0 +1,121 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "utils/taggedlosertree.h"
+
+namespace
+{
+	struct Record
+	{
+		int key, sequence;
+
+		bool operator < (const Record &r) const
+		{
+			return key < r.key;
+		}
+	};
+
+	/*
+	 * Coarse prefix: many different keys share it, so full records must decide
+	 */
+	struct CoarsePrefix
+	{
+		std::uint64_t operator () (const Record &r) const
+		{
+			return std::uint64_t(r.key / 10);
+		}
+	};
+
+	struct CountingLess
+	{
+		static std::size_t calls;
+
+		bool operator () (const Record &a, const Record &b)
+		{
+			++calls;
+			return a < b;
+		}
+	};
+
+	std::size_t CountingLess::calls = 0;
+}
+
+TEST(TaggedLoserTree, StableRandomMerging)
+{
+	std::mt19937 generator(17);
+	for (std::size_t ways : {1u, 2u, 5u, 16u, 33u})
+	{
+		std::vector< std::vector<Record> > sequences(ways);
+		std::vector<Record> answer;
+		for (std::size_t i = 0; i < ways; ++i)
+		{
+			sequences[i].resize(generator() % 200);
+			for (Record &r : sequences[i])
+				r.key = generator() % 500, r.sequence = i;
+			std::sort(sequences[i].begin(), sequences[i].end());
+			answer.insert(answer.end(), sequences[i].begin(), sequences[i].end());
+		}
+		std::stable_sort(answer.begin(), answer.end());
+
+		TaggedLoserTree<Record, std::less<Record>, CoarsePrefix, true> tree(ways);
+		std::vector<std::size_t> position(ways, 0);
+		for (std::size_t i = 0; i < ways; ++i)
+			if (!sequences[i].empty())
+			{
+				tree.head(i) = sequences[i][position[i]++];
+				tree.activate(i);
+			}
+		tree.build();
+
+		std::vector<Record> result;
+		while (!tree.empty())
+		{
+			std::size_t current = tree.winner();
+			result.push_back(tree.top());
+			if (position[current] < sequences[current].size())
+			{
+				tree.top() = sequences[current][position[current]++];
+				tree.update();
+			}
+			else
+				tree.exhaust();
+		}
+
+		ASSERT_EQ(answer.size(), result.size());
+		for (std::size_t i = 0; i < answer.size(); ++i)
+		{
+			EXPECT_EQ(answer[i].key, result[i].key);
+			EXPECT_EQ(answer[i].sequence, result[i].sequence);
+		}
+	}
+}
+
+TEST(TaggedLoserTree, FullComparisonsOnlyOnTies)
+{
+	struct ExactPrefix
+	{
+		std::uint64_t operator () (const Record &r) const
+		{
+			return std::uint64_t(r.key);
+		}
+	};
+
+	std::vector<Record> heads = {{5, 0}, {3, 1}, {8, 2}, {1, 3}};
+	TaggedLoserTree<Record, CountingLess, ExactPrefix> tree(heads.size());
+	for (std::size_t i = 0; i < heads.size(); ++i)
+	{
+		tree.head(i) = heads[i];
+		tree.activate(i);
+	}
+	CountingLess::calls = 0;
+	tree.build();
+	EXPECT_EQ(1, tree.top().key);
+	tree.top().key = 4;
+	tree.update();
+	EXPECT_EQ(3, tree.top().key);
+	EXPECT_EQ(0u, CountingLess::calls) << "Distinct prefixes must not touch records";
+}
@@ -0,0 +1,62 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include <gtest/gtest.h>
+
+#include "utils/topkthreshold.h"
+
+TEST(TopKThreshold, ManualTests)
+{
+	TopKThreshold<int, std::less<int> > threshold(5, 2);
+	EXPECT_FALSE(threshold.known());
+	EXPECT_FALSE(threshold.rejects(1000000));
+
+	std::vector<int> first = {1, 3, 5};
+	threshold.addRun(first.data(), first.size());
+	EXPECT_FALSE(threshold.known()) << "Three elements can not certify five";
+
+	std::vector<int> second = {2, 4, 6, 8, 10, 12};
+	threshold.addRun(second.data(), second.size());
+	ASSERT_TRUE(threshold.known());
+	EXPECT_EQ(5, threshold.value());
+	EXPECT_FALSE(threshold.rejects(5)) << "Elements equal to threshold may be needed";
+	EXPECT_TRUE(threshold.rejects(6));
+
+	std::vector<int> third = {0, 0, 0, 0, 0};
+	threshold.addRun(third.data(), third.size());
+	EXPECT_EQ(0, threshold.value());
+}
+
+/*
+ * Threshold is never less than the k-th smallest element of all runs
+ */
+TEST(TopKThreshold, RandomRuns)
+{
+	std::mt19937 generator(914);
+	for (std::size_t k : {1, 7, 100, 1000})
+	{
+		TopKThreshold<int, std::less<int> > threshold(k);
+		std::vector<int> all;
+		for (int run = 0; run < 30; ++run)
+		{
+			std::vector<int> data(generator() % 300);
+			for (int &x : data)
+				x = generator() % 10000;
+			std::sort(data.begin(), data.end());
+			threshold.addRun(data.data(), data.size());
+			all.insert(all.end(), data.begin(), data.end());
+
+			if (all.size() >= k)
+			{
+				std::nth_element(all.begin(), all.begin() + k - 1, all.end());
+				if (threshold.known())
+					EXPECT_LE(all[k - 1], threshold.value()) << "k = " << k;
+				else
+					EXPECT_GT(k, 64u) << "Checkpoint at k-th position should make threshold known";
+			}
+		}
+		EXPECT_TRUE(threshold.known());
+	}
+}
@@ -102,7 +102,7 @@ template<typename DataType> class BinaryFileReader : public impl::BinaryFileRead
 		 */
 		bool operator () (DataType &element)
 		{
-			return ready() && stream->read(reinterpret_cast<char*>(&element), sizeof(DataType));
+			return ready() && static_cast<bool>(stream->read(reinterpret_cast<char*>(&element), sizeof(DataType)));
 		}
 
 		/**
@@ -111,7 +111,7 @@ template<typename DataType> class BinaryFileReader : public impl::BinaryFileRead
 		 */
 		virtual bool skip(int elements)
 		{
-			return stream->seekg(elements * sizeof(DataType), std::ios_base::cur);
+			return static_cast<bool>(stream->seekg(elements * sizeof(DataType), std::ios_base::cur));
 		}
 
 	private:
@@ -162,22 +162,15 @@ template<> class BinaryFileReader<std::string> : public impl::BinaryFileReaderHe
 
 		/**
 		 * Read one string
+		 * Characters are read straight into (element), its memory is reused if it is big enough
 		 */
 		bool operator() (std::string &element)
 		{
 			if (!ready()) return false;
 			std::string::size_type size;
 			if (!stream->read(reinterpret_cast<char *>(&size), sizeof(size))) return false;
-			char *buffer = new char[size + 1];
-			buffer[size] = 0;
-			if (!stream->read(buffer, size * sizeof(char)))
-			{
-				delete buffer;
-				return false;
-			}
-			element = std::string(buffer, buffer + size);
-			delete buffer;
-			return true;
+			element.resize(size);
+			return size == 0 || static_cast<bool>(stream->read(&element[0], size));
 		}
 
 	private:
@@ -2,6 +2,7 @@
 #define BINARYFILEWRITER_H
 
 #include <fstream>
+#include <string>
 
 namespace impl
 {
@@ -100,7 +101,7 @@ template <typename DataType> class BinaryFileWriter : public impl::BinaryFileWri
 		bool operator () (const DataType &element)
 		{
 			if (!ready()) return false;
-			return stream->write(reinterpret_cast<const char*>(&element), sizeof(DataType));
+			return static_cast<bool>(stream->write(reinterpret_cast<const char*>(&element), sizeof(DataType)));
 		}
 
 	private:
@@ -146,11 +147,18 @@ template<> class BinaryFileWriter<std::string> : public impl::BinaryFileWriterHe
 		}
 
 		bool operator () (std::string &element)
+		{
+			return operator() (element.data(), element.size());
+		}
+
+		/**
+		 * Writes (size) characters starting from (data) in the same format as std::string
+		 */
+		bool operator () (const char *data, std::string::size_type size)
 		{
 			if (!ready()) return false;
-			std::string::size_type size = element.size();
 			if (!stream->write(reinterpret_cast<char *>(&size), sizeof(size))) return false;
-			if (!stream->write(element.c_str(), element.size())) return false;
+			if (!stream->write(data, size)) return false;
 			return true;
 		}
 
@@ -0,0 +1,146 @@
+#ifndef BLOCKFILEREADER_H
+#define BLOCKFILEREADER_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../utils/alignedblock.h"
+
+/**
+ * Class implementing AbstractReader interface for trivially copyable types
+ * Reads file with read(2) calls by large blocks and hands out elements from memory
+ * Can be used as TemporaryReader of ExternalSorter (has constructor with file name)
+ */
+template<typename DataType> class BlockFileReader
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "BlockFileReader requires trivially copyable type");
+
+	public:
+		static const std::size_t defaultBlockSize = 1 << 20;
+
+		/**
+		 * Initialise reader with file name (std::string). File will be opened and closed by reader
+		 */
+		explicit BlockFileReader(const std::string &fileName, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = open(fileName.c_str(), O_RDONLY);
+			ownDescriptor = true;
+			reset();
+		}
+
+		/**
+		 * Initialise reader with file name (const char*). File will be opened and closed by reader
+		 */
+		explicit BlockFileReader(const char *fileName, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = open(fileName, O_RDONLY);
+			ownDescriptor = true;
+			reset();
+		}
+
+		/**
+		 * Initialise reader with already opened file descriptor, it won't be closed by reader
+		 */
+		explicit BlockFileReader(int fd, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = fd;
+			ownDescriptor = false;
+			reset();
+		}
+
+		~BlockFileReader()
+		{
+			if (ownDescriptor && descriptor >= 0) close(descriptor);
+		}
+
+		/**
+		 * Returns true if file is opened and no error occured
+		 */
+		bool ready() const
+		{
+			return descriptor >= 0 && block.data && !failed;
+		}
+
+		/**
+		 * Reads one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (DataType &element)
+		{
+			if (position + sizeof(DataType) > loaded && !fill()) return false;
+			std::memcpy(&element, block.data + position, sizeof(DataType));
+			position += sizeof(DataType);
+			return true;
+		}
+
+		/**
+		 * Reads up to (count) elements to (elements) array
+		 * Returns number of elements read, it is less than (count) only at the end of file
+		 */
+		std::size_t operator () (DataType *elements, std::size_t count)
+		{
+			std::size_t done = 0;
+			while (done < count)
+			{
+				if (position + sizeof(DataType) > loaded && !fill()) break;
+				std::size_t available = std::min((loaded - position) / sizeof(DataType), count - done);
+				std::memcpy(elements + done, block.data + position, available * sizeof(DataType));
+				position += available * sizeof(DataType);
+				done += available;
+			}
+			return done;
+		}
+
+	private:
+		impl::AlignedBlock block;
+		std::size_t position, loaded;
+		int descriptor;
+		bool ownDescriptor, failed;
+
+		static std::size_t roundBlockSize(std::size_t blockSize)
+		{
+			std::size_t elements = blockSize / sizeof(DataType);
+			return (elements ? elements : 1) * sizeof(DataType);
+		}
+
+		void reset()
+		{
+			position = loaded = 0;
+			failed = false;
+		}
+
+		/**
+		 * Moves unread tail to the beginning of the block and reads as much as possible after it
+		 * Returns true if at least one whole element is available
+		 */
+		bool fill()
+		{
+			if (!ready()) return false;
+			std::size_t tail = loaded - position;
+			std::memmove(block.data, block.data + position, tail);
+			position = 0, loaded = tail;
+			while (loaded < block.bytes)
+			{
+				ssize_t got = read(descriptor, block.data + loaded, block.bytes - loaded);
+				if (got < 0 && errno == EINTR) continue;
+				if (got < 0) failed = true;
+				if (got <= 0) break;
+				loaded += got;
+			}
+			return loaded >= sizeof(DataType);
+		}
+
+		BlockFileReader(const BlockFileReader &reader);
+		BlockFileReader& operator = (const BlockFileReader &reader);
+};
+
+#endif // BLOCKFILEREADER_H
@@ -0,0 +1,151 @@
+#ifndef BLOCKFILEWRITER_H
+#define BLOCKFILEWRITER_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../utils/alignedblock.h"
+
+/**
+ * Class implementing AbstractWriter interface for trivially copyable types
+ * Collects elements in memory and writes them to file with write(2) calls by large blocks
+ * Can be used as TemporaryWriter of ExternalSorter (has constructor with file name)
+ */
+template<typename DataType> class BlockFileWriter
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "BlockFileWriter requires trivially copyable type");
+
+	public:
+		static const std::size_t defaultBlockSize = 1 << 20;
+
+		/**
+		 * Initialise writer with file name (std::string). File will be created (or truncated) and closed by writer
+		 */
+		explicit BlockFileWriter(const std::string &fileName, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+			ownDescriptor = true;
+			reset();
+		}
+
+		/**
+		 * Initialise writer with file name (const char*). File will be created (or truncated) and closed by writer
+		 */
+		explicit BlockFileWriter(const char *fileName, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+			ownDescriptor = true;
+			reset();
+		}
+
+		/**
+		 * Initialise writer with already opened file descriptor, it won't be closed by writer
+		 */
+		explicit BlockFileWriter(int fd, std::size_t blockSize = defaultBlockSize)
+			: block(roundBlockSize(blockSize))
+		{
+			descriptor = fd;
+			ownDescriptor = false;
+			reset();
+		}
+
+		/**
+		 * Flushes buffered data and closes file if needed
+		 */
+		~BlockFileWriter()
+		{
+			flush();
+			if (ownDescriptor && descriptor >= 0) close(descriptor);
+		}
+
+		/**
+		 * Returns true if file is opened and no error occured
+		 */
+		bool ready() const
+		{
+			return descriptor >= 0 && block.data && !failed;
+		}
+
+		/**
+		 * Writes one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType &element)
+		{
+			if (used + sizeof(DataType) > block.bytes && !flush()) return false;
+			std::memcpy(block.data + used, &element, sizeof(DataType));
+			used += sizeof(DataType);
+			return true;
+		}
+
+		/**
+		 * Writes (count) elements from (elements) array
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType *elements, std::size_t count)
+		{
+			while (count)
+			{
+				if (used + sizeof(DataType) > block.bytes && !flush()) return false;
+				std::size_t available = std::min((block.bytes - used) / sizeof(DataType), count);
+				std::memcpy(block.data + used, elements, available * sizeof(DataType));
+				used += available * sizeof(DataType);
+				elements += available, count -= available;
+			}
+			return true;
+		}
+
+		/**
+		 * Writes all buffered data to the file
+		 * Returns true in case of success, false otherwise
+		 */
+		bool flush()
+		{
+			if (!ready()) return false;
+			std::size_t written = 0;
+			while (written < used)
+			{
+				ssize_t done = write(descriptor, block.data + written, used - written);
+				if (done < 0 && errno == EINTR) continue;
+				if (done <= 0)
+				{
+					failed = true;
+					return false;
+				}
+				written += done;
+			}
+			used = 0;
+			return true;
+		}
+
+	private:
+		impl::AlignedBlock block;
+		std::size_t used;
+		int descriptor;
+		bool ownDescriptor, failed;
+
+		static std::size_t roundBlockSize(std::size_t blockSize)
+		{
+			std::size_t elements = blockSize / sizeof(DataType);
+			return (elements ? elements : 1) * sizeof(DataType);
+		}
+
+		void reset()
+		{
+			used = 0;
+			failed = false;
+		}
+
+		BlockFileWriter(const BlockFileWriter &writer);
+		BlockFileWriter& operator = (const BlockFileWriter &writer);
+};
+
+#endif // BLOCKFILEWRITER_H
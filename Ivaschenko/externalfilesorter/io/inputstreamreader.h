@@ -2,9 +2,12 @@
 #define INPUTSTREAMREADER_H
 
 #include <set>
+#include <vector>
 #include <istream>
 #include <type_traits>
 
+#include "../utils/integertext.h"
+
 namespace impl
 {
 	/**
@@ -90,12 +93,16 @@ template<typename DataType, typename = void> class InputStreamReader : public im
  * Features:
  *		- Reading sequences separated by adjustable delimeters
  *		- Reading non-decimal integers
+ * Input is taken from the stream buffer by blocks of blockSize bytes and scanned with lookup tables
+ * of delimeters and digits, so the stream itself is ahead of the last number read
  */
 template<typename IntegerType> class InputStreamReader
 		<IntegerType, typename std::enable_if< std::is_integral<IntegerType>::value >::type>
 		: public impl::InputStreamReaderHelper
 {
 	public:
+		static const std::size_t blockSize = 1 << 16;
+
 		/**
 		 * Initialising from any input stream, default radix is 10.
 		 * Defualt delimeters are space and eoln
@@ -110,38 +117,60 @@ template<typename IntegerType> class InputStreamReader
 		}
 
 		/**
-		 * Read an element. Reads input char by char searching of group of consecutive digits
-		 * surrounded by delimeters. Returns true in case of success, false otherwise
+		 * Binds stream to the reader, data buffered from the previous stream is dropped
+		 */
+		void bindStream(std::istream &in)
+		{
+			impl::InputStreamReaderHelper::bindStream(in);
+			position = loaded = 0;
+		}
+
+		/**
+		 * Read an element. Searches for group of consecutive digits (with optional minus for signed types)
+		 * surrounded by delimeters, other groups are skipped. Returns true in case of success, false otherwise
 		 */
 		bool operator() (IntegerType &number)
 		{
-			if (!ready()) return false;
-			char c = 0;
+			typedef typename std::make_unsigned<IntegerType>::type UnsignedType;
+			if (position == loaded && !ready()) return false;
 			while (true)
 			{
-				while (c == 0 || isDelimeter(c))
-					if (!stream->read(&c, 1)) return false;
+				while (true)
+				{
+					while (position < loaded && isDelimeter(block[position])) ++position;
+					if (position < loaded) break;
+					if (!fetch()) return false;
+				}
 
-				bool minus = c == '-' && std::is_signed<IntegerType>::value;
-				if (minus && !stream->read(&c, 1)) return false;
-				if (digitValue(c) >= 0)
+				bool minus = block[position] == '-' && std::is_signed<IntegerType>::value;
+				if (minus && ++position == loaded && !fetch()) return false;
+
+				UnsignedType value = 0;
+				bool digits = false;
+				while (true)
 				{
-					number = 0;
-					while (digitValue(c) >= 0)
-					{
-						number = number * (IntegerType) radix + (IntegerType) digitValue(c);
-						if (!stream->read(&c, 1)) return true; // Last element before EOF
-					}
-					if (isDelimeter(c))
+					unsigned digit;
+					while (position < loaded && (digit = impl::DigitTable::value(block[position])) < radix)
 					{
-						if (minus) number = -number;
-						return true;
+						value = value * UnsignedType(radix) + UnsignedType(digit);
+						digits = true;
+						++position;
 					}
-					else continue;
+					if (position < loaded || !fetch()) break;
 				}
 
-				while (!isDelimeter(c))
-					if (!stream->read(&c, 1)) return false;
+				if (digits && (position == loaded || isDelimeter(block[position])))
+				{
+					number = IntegerType(minus ? UnsignedType(0) - value : value);
+					return true;
+				}
+
+				while (true)
+				{
+					while (position < loaded && !isDelimeter(block[position])) ++position;
+					if (position < loaded) break;
+					if (!fetch()) return false;
+				}
 			}
 		}
 
@@ -234,6 +263,9 @@ template<typename IntegerType> class InputStreamReader
 		unsigned int radix;
 		bool delimeterMask[alphabet];
 
+		std::vector<unsigned char> block;
+		std::size_t position, loaded;
+
 		/**
 		 * Checks whether radix is valid
 		 */
@@ -243,13 +275,16 @@ template<typename IntegerType> class InputStreamReader
 		}
 
 		/**
-		 * Returns integer value of digit and -1 if invalid character
+		 * Takes the next block from the stream buffer, all previous data must be consumed
+		 * Returns false (and marks stream as failed) if nothing is left
 		 */
-		int digitValue(char c)
+		bool fetch()
 		{
-			int value = isdigit(c) ? c - '0' : tolower(c) - 'a' + 10;
-			return (0 <= value && value < (int) radix) ? value : -1;
-			return -1;
+			if (block.empty()) block.resize(blockSize);
+			position = 0;
+			loaded = stream->rdbuf()->sgetn(reinterpret_cast<char*>(block.data()), block.size());
+			if (loaded == 0) stream->setstate(std::ios_base::eofbit | std::ios_base::failbit);
+			return loaded != 0;
 		}
 };
 
@@ -0,0 +1,137 @@
+#ifndef MAPPEDFILEREADER_H
+#define MAPPEDFILEREADER_H
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Class implementing AbstractReader interface for trivially copyable types
+ * Maps the whole file to memory with mmap(2), elements are copied straight from the mapping,
+ * span overload lets ExternalSorter fill its chunk with a single copy
+ * Can be used as Reader or TemporaryReader of ExternalSorter (has constructor with file name)
+ */
+template<typename DataType> class MappedFileReader
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "MappedFileReader requires trivially copyable type");
+
+	public:
+		/**
+		 * Initialise reader with file name (std::string)
+		 */
+		explicit MappedFileReader(const std::string &fileName)
+		{
+			map(open(fileName.c_str(), O_RDONLY));
+		}
+
+		/**
+		 * Initialise reader with file name (const char*)
+		 */
+		explicit MappedFileReader(const char *fileName)
+		{
+			map(open(fileName, O_RDONLY));
+		}
+
+		~MappedFileReader()
+		{
+			if (data) munmap(const_cast<char*>(data), bytes);
+		}
+
+		/**
+		 * Returns true if file is mapped (or empty) and no error occured
+		 */
+		bool ready() const
+		{
+			return !failed;
+		}
+
+		/**
+		 * Returns number of elements which are not read yet
+		 */
+		std::size_t remaining() const
+		{
+			return (bytes - position) / sizeof(DataType);
+		}
+
+		/**
+		 * Reads one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (DataType &element)
+		{
+			if (position + sizeof(DataType) > bytes) return false;
+			std::memcpy(&element, data + position, sizeof(DataType));
+			position += sizeof(DataType);
+			return true;
+		}
+
+		/**
+		 * Reads up to (count) elements to (elements) array
+		 * Returns number of elements read, it is less than (count) only at the end of file
+		 */
+		std::size_t operator () (DataType *elements, std::size_t count)
+		{
+			count = std::min(count, remaining());
+			std::memcpy(elements, data + position, count * sizeof(DataType));
+			position += count * sizeof(DataType);
+			return count;
+		}
+
+		/**
+		 * Returns pointer to the first element of the file, elements can be accessed directly
+		 * while the reader exists (PartitionedMerger searches and merges runs in place)
+		 */
+		const DataType* begin() const
+		{
+			return reinterpret_cast<const DataType*>(data);
+		}
+
+		const DataType* end() const
+		{
+			return begin() + bytes / sizeof(DataType);
+		}
+
+	private:
+		const char *data;
+		std::size_t bytes, position;
+		bool failed;
+
+		/**
+		 * Maps file opened as (descriptor) and closes descriptor, mapping stays valid
+		 */
+		void map(int descriptor)
+		{
+			data = 0;
+			bytes = position = 0;
+			failed = descriptor < 0;
+			if (failed) return;
+
+			struct stat info;
+			if (fstat(descriptor, &info) != 0)
+				failed = true;
+			else if (info.st_size > 0)
+			{
+				void *mapped = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+				if (mapped == MAP_FAILED)
+					failed = true;
+				else
+				{
+					data = static_cast<const char*>(mapped);
+					bytes = info.st_size;
+					madvise(mapped, bytes, MADV_SEQUENTIAL);
+				}
+			}
+			close(descriptor);
+		}
+
+		MappedFileReader(const MappedFileReader &reader);
+		MappedFileReader& operator = (const MappedFileReader &reader);
+};
+
+#endif // MAPPEDFILEREADER_H
@@ -0,0 +1,169 @@
+#ifndef MAPPEDFILEWRITER_H
+#define MAPPEDFILEWRITER_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/**
+ * Class implementing AbstractWriter interface for trivially copyable types
+ * File is extended by windows of (windowSize) bytes which are reserved with posix_fallocate(3) and mapped
+ * with mmap(2), elements are copied straight into the mapping. Disk space of a window is reserved before it
+ * is mapped, so lack of space is returned as error instead of SIGBUS on write
+ * Extra space is truncated by close() or on destruction
+ * Can be used as Writer or TemporaryWriter of ExternalSorter (has constructor with file name)
+ */
+template<typename DataType> class MappedFileWriter
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "MappedFileWriter requires trivially copyable type");
+
+	public:
+		static const std::size_t defaultWindowSize = 1 << 26;
+
+		/**
+		 * Initialise writer with file name (std::string). File will be created (or truncated)
+		 */
+		explicit MappedFileWriter(const std::string &fileName, std::size_t windowSize = defaultWindowSize)
+		{
+			reset(open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600), windowSize);
+		}
+
+		/**
+		 * Initialise writer with file name (const char*). File will be created (or truncated)
+		 */
+		explicit MappedFileWriter(const char *fileName, std::size_t windowSize = defaultWindowSize)
+		{
+			reset(open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0600), windowSize);
+		}
+
+		~MappedFileWriter()
+		{
+			close();
+		}
+
+		/**
+		 * Unmaps last window, truncates file to the written size and closes it, further writes fail
+		 * Returns true if no error occured while writing and closing
+		 */
+		bool close()
+		{
+			if (descriptor < 0) return !failed;
+			std::size_t written = windowOffset;
+			if (window)
+			{
+				munmap(window, windowBytes);
+				written += used;
+			}
+			if (ftruncate(descriptor, written) != 0) failed = true;
+			if (::close(descriptor) != 0) failed = true;
+			descriptor = -1;
+			window = 0;
+			used = windowBytes;
+			return !failed;
+		}
+
+		/**
+		 * Returns true if file is opened and no error occured
+		 */
+		bool ready() const
+		{
+			return descriptor >= 0 && !failed;
+		}
+
+		/**
+		 * Writes one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType &element)
+		{
+			if (used + sizeof(DataType) <= windowBytes)
+			{
+				std::memcpy(window + used, &element, sizeof(DataType));
+				used += sizeof(DataType);
+				return true;
+			}
+			return put(reinterpret_cast<const char*>(&element), sizeof(DataType));
+		}
+
+		/**
+		 * Writes (count) elements from (elements) array
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType *elements, std::size_t count)
+		{
+			return put(reinterpret_cast<const char*>(elements), count * sizeof(DataType));
+		}
+
+	private:
+		int descriptor;
+		char *window;
+		std::size_t windowBytes, windowOffset, used;
+		bool failed;
+
+		void reset(int fd, std::size_t windowSize)
+		{
+			std::size_t page = sysconf(_SC_PAGESIZE);
+			descriptor = fd;
+			window = 0;
+			windowBytes = std::max<std::size_t>(1, (windowSize + page - 1) / page) * page;
+			windowOffset = 0;
+			used = windowBytes;
+			failed = descriptor < 0;
+		}
+
+		/**
+		 * Copies (size) bytes to the file, element may be split between two windows
+		 */
+		bool put(const char *bytes, std::size_t size)
+		{
+			while (size)
+			{
+				if (used == windowBytes && !nextWindow()) return false;
+				std::size_t part = std::min(size, windowBytes - used);
+				std::memcpy(window + used, bytes, part);
+				used += part, bytes += part, size -= part;
+			}
+			return true;
+		}
+
+		/**
+		 * Unmaps filled window, reserves disk space for the next one and maps it
+		 */
+		bool nextWindow()
+		{
+			if (!ready()) return false;
+			if (window)
+			{
+				munmap(window, windowBytes);
+				window = 0;
+				windowOffset += windowBytes;
+			}
+			int error;
+			while ((error = posix_fallocate(descriptor, windowOffset, windowBytes)) == EINTR);
+			if (error != 0)
+			{
+				failed = true;
+				return false;
+			}
+			void *mapped = mmap(0, windowBytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, windowOffset);
+			if (mapped == MAP_FAILED)
+			{
+				failed = true;
+				return false;
+			}
+			window = static_cast<char*>(mapped);
+			used = 0;
+			return true;
+		}
+
+		MappedFileWriter(const MappedFileWriter &writer);
+		MappedFileWriter& operator = (const MappedFileWriter &writer);
+};
+
+#endif // MAPPEDFILEWRITER_H
@@ -2,6 +2,11 @@
 #define OUTPUTSTREAMWRITER_H
 
 #include <vector>
+#include <string>
+#include <ostream>
+#include <type_traits>
+
+#include "../utils/integertext.h"
 
 /**
  * Class implementing AbstractWriter interface
@@ -96,8 +101,7 @@ template<typename DataType> class OutputStreamWriter
 		bool operator () (const DataType &element)
 		{
 			if (!ready()) return false;
-			if (!startLine && !(*stream << delimeter)) return false;
-			if (!(*stream << element)) return false;
+			if (!put(element, impl::IsFormattedInteger<DataType>())) return false;
 			startLine = false;
 			return true;
 		}
@@ -125,6 +129,40 @@ template<typename DataType> class OutputStreamWriter
 		std::ostream *stream;
 		std::string delimeter;
 		bool startLine;
+
+		/**
+		 * Writes delimeter (if needed) and element through operator <<
+		 */
+		bool put(const DataType &element, std::false_type)
+		{
+			if (!startLine && !(*stream << delimeter)) return false;
+			return bool(*stream << element);
+		}
+
+		/**
+		 * Integers in plain decimal format are formatted by formatDecimal and given to the stream buffer
+		 * together with delimeter, other formats (hex, showpos, width) are left to operator <<
+		 */
+		bool put(const DataType &element, std::true_type)
+		{
+			if ((stream->flags() & (std::ios_base::basefield | std::ios_base::showpos)) != std::ios_base::dec ||
+					stream->width() != 0)
+				return put(element, std::false_type());
+			char text[24];
+			char *end = text + sizeof(text), *begin = impl::formatDecimal(element, end);
+			std::streambuf *buffer = stream->rdbuf();
+			if (!startLine && buffer->sputn(delimeter.data(), delimeter.size()) != std::streamsize(delimeter.size()))
+			{
+				stream->setstate(std::ios_base::badbit);
+				return false;
+			}
+			if (buffer->sputn(begin, end - begin) != end - begin)
+			{
+				stream->setstate(std::ios_base::badbit);
+				return false;
+			}
+			return true;
+		}
 };
 
 #endif // OUTPUTSTREAMWRITER_H
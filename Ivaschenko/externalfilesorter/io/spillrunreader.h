@@ -0,0 +1,116 @@
+#ifndef SPILLRUNREADER_H
+#define SPILLRUNREADER_H
+
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+
+#include <unistd.h>
+
+#include "../utils/alignedblock.h"
+#include "../utils/spillfile.h"
+
+/**
+ * Class implementing AbstractReader interface for trivially copyable types
+ * Reads a run written by SpillRunWriter from its extents with pread(2) calls by blocks
+ * Created by SpillFileIOFactory, extents of the run are given back to the file when reader is destroyed
+ */
+template<typename DataType> class SpillRunReader
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "SpillRunReader requires trivially copyable type");
+
+	public:
+		static const std::size_t defaultBlockSize = 1 << 16;
+
+		SpillRunReader(const std::shared_ptr<impl::SpillFile> &file, const std::shared_ptr<impl::SpillRun> &run,
+					   std::size_t blockSize = defaultBlockSize)
+			: file(file), run(run), block(std::max(blockSize, sizeof(DataType))),
+			  position(0), loaded(0), fetched(0), failed(false) {}
+
+		~SpillRunReader()
+		{
+			file->release(*run);
+		}
+
+		/**
+		 * Returns true if spill file is opened and no error occured
+		 */
+		bool ready() const
+		{
+			return file->ready() && block.data && !failed;
+		}
+
+		/**
+		 * Reads one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (DataType &element)
+		{
+			if (position + sizeof(DataType) > loaded && !fill()) return false;
+			std::memcpy(&element, block.data + position, sizeof(DataType));
+			position += sizeof(DataType);
+			return true;
+		}
+
+		/**
+		 * Reads up to (count) elements to (elements) array
+		 * Returns number of elements read, it is less than (count) only at the end of run
+		 */
+		std::size_t operator () (DataType *elements, std::size_t count)
+		{
+			std::size_t done = 0;
+			while (done < count)
+			{
+				if (position + sizeof(DataType) > loaded && !fill()) break;
+				std::size_t available = std::min((loaded - position) / sizeof(DataType), count - done);
+				std::memcpy(elements + done, block.data + position, available * sizeof(DataType));
+				position += available * sizeof(DataType);
+				done += available;
+			}
+			return done;
+		}
+
+	private:
+		std::shared_ptr<impl::SpillFile> file;
+		std::shared_ptr<impl::SpillRun> run;
+		impl::AlignedBlock block;
+		std::size_t position, loaded;
+		std::uint64_t fetched;
+		bool failed;
+
+		/**
+		 * Moves unread tail to the beginning of the block and reads as much of the run as fits after it
+		 * Returns true if at least one whole element is available
+		 */
+		bool fill()
+		{
+			if (!ready()) return false;
+			std::size_t tail = loaded - position, extent = file->extentSize();
+			std::memmove(block.data, block.data + position, tail);
+			position = 0, loaded = tail;
+			while (loaded < block.bytes && fetched < run->bytes)
+			{
+				std::size_t inExtent = fetched % extent;
+				std::size_t part = std::min<std::uint64_t>(std::min(block.bytes - loaded, extent - inExtent),
+														   run->bytes - fetched);
+				ssize_t got = pread(file->getDescriptor(), block.data + loaded, part,
+									run->extents[fetched / extent] + inExtent);
+				if (got < 0 && errno == EINTR) continue;
+				if (got <= 0)
+				{
+					failed = true;
+					break;
+				}
+				loaded += got;
+				fetched += got;
+			}
+			return loaded >= sizeof(DataType);
+		}
+
+		SpillRunReader(const SpillRunReader &reader);
+		SpillRunReader& operator = (const SpillRunReader &reader);
+};
+
+#endif // SPILLRUNREADER_H
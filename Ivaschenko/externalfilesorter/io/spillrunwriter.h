@@ -0,0 +1,113 @@
+#ifndef SPILLRUNWRITER_H
+#define SPILLRUNWRITER_H
+
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+
+#include <unistd.h>
+
+#include "../utils/alignedblock.h"
+#include "../utils/spillfile.h"
+
+/**
+ * Class implementing AbstractWriter interface for trivially copyable types
+ * Appends elements to a run inside SpillFile: data is collected in a block and written with
+ * pwrite(2) to the extents of the run, new extents are taken from the file when needed
+ * Created by SpillFileIOFactory, buffered data is written when writer is destroyed
+ */
+template<typename DataType> class SpillRunWriter
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "SpillRunWriter requires trivially copyable type");
+
+	public:
+		static const std::size_t defaultBlockSize = 1 << 20;
+
+		SpillRunWriter(const std::shared_ptr<impl::SpillFile> &file, const std::shared_ptr<impl::SpillRun> &run,
+					   std::size_t blockSize = defaultBlockSize)
+			: file(file), run(run), block(std::max(blockSize, sizeof(DataType))), used(0), failed(false) {}
+
+		~SpillRunWriter()
+		{
+			flush();
+		}
+
+		/**
+		 * Returns true if spill file is opened and no error occured
+		 */
+		bool ready() const
+		{
+			return file->ready() && block.data && !failed;
+		}
+
+		/**
+		 * Writes one element
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType &element)
+		{
+			return operator () (&element, 1);
+		}
+
+		/**
+		 * Writes (count) elements from (elements) array
+		 * Returns true in case of success, false otherwise
+		 */
+		bool operator () (const DataType *elements, std::size_t count)
+		{
+			const char *data = reinterpret_cast<const char*>(elements);
+			std::size_t bytes = count * sizeof(DataType);
+			while (bytes)
+			{
+				if (used == block.bytes && !flush()) return false;
+				std::size_t available = std::min(block.bytes - used, bytes);
+				std::memcpy(block.data + used, data, available);
+				used += available;
+				data += available, bytes -= available;
+			}
+			return true;
+		}
+
+		/**
+		 * Writes all buffered data to the spill file
+		 * Returns true in case of success, false otherwise
+		 */
+		bool flush()
+		{
+			if (!ready()) return false;
+			std::size_t written = 0, extent = file->extentSize();
+			while (written < used)
+			{
+				std::size_t inExtent = run->bytes % extent;
+				if (inExtent == 0 && run->bytes / extent == run->extents.size())
+					run->extents.push_back(file->allocate());
+				std::size_t part = std::min(used - written, extent - inExtent);
+				ssize_t done = pwrite(file->getDescriptor(), block.data + written, part,
+									  run->extents[run->bytes / extent] + inExtent);
+				if (done < 0 && errno == EINTR) continue;
+				if (done <= 0)
+				{
+					failed = true;
+					return false;
+				}
+				written += done;
+				run->bytes += done;
+			}
+			used = 0;
+			return true;
+		}
+
+	private:
+		std::shared_ptr<impl::SpillFile> file;
+		std::shared_ptr<impl::SpillRun> run;
+		impl::AlignedBlock block;
+		std::size_t used;
+		bool failed;
+
+		SpillRunWriter(const SpillRunWriter &writer);
+		SpillRunWriter& operator = (const SpillRunWriter &writer);
+};
+
+#endif // SPILLRUNWRITER_H
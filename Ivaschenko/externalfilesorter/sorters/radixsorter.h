@@ -0,0 +1,155 @@
+#ifndef RADIXSORTER_H
+#define RADIXSORTER_H
+
+#include <vector>
+#include <thread>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+/**
+ * Sorter class, implementing LSD radix sort on values (not on indices as DigitalSorter does)
+ * Histograms of all blocks are counted in a single pass over the data, passes over blocks where
+ * all elements have the same digit are skipped, elements are moved between the sorted range
+ * and one buffer of the same size. Big ranges are counted and scattered by several threads,
+ * every thread works with its own slice so the sort stays stable.
+ * O(blocksCount * N + blocksCount * blockRange * threads) complexity, uses O(N) additional memory.
+ * Stable.
+ * Requires a BitBlockExtractor for DataType with the same interface as DigitalSorter
+ * (see DigitalSorter), extractor is copied to every thread
+ */
+template<typename DataType, typename BitBlockExtractor> class RadixSorter
+{
+	public:
+		/**
+		 * Slices smaller than (minSlice) elements are not given to separate threads
+		 */
+		static const std::size_t minSlice = 1 << 16;
+
+		/**
+		 * Up to (threads) workers will be used, hardware concurrency if threads = 0
+		 */
+		explicit RadixSorter(std::size_t threads = 0)
+			: threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+		template <typename RandomAccessIterator>
+		void operator () (RandomAccessIterator begin, RandomAccessIterator end)
+		{
+			std::size_t n = std::distance(begin, end);
+			if (n < 2) return;
+
+			BitBlockExtractor extractor(begin, end);
+			std::size_t blocks = extractor.getBlocksNumber();
+			std::size_t workers = std::min(threads, std::max<std::size_t>(1, n / minSlice));
+
+			std::vector< std::vector<std::size_t> > total(blocks);
+			for (std::size_t block = 0; block < blocks; ++block)
+				total[block].assign(extractor.getBlockRange(block), 0);
+			countAllBlocks(begin, n, extractor, workers, total);
+
+			std::vector<DataType> buffer;
+			bool inBuffer = false;
+			for (std::size_t block = 0; block < blocks; ++block)
+			{
+				if (*std::max_element(total[block].begin(), total[block].end()) == n) continue;
+				if (buffer.empty()) buffer.resize(n);
+				if (inBuffer)
+					distribute(buffer.begin(), begin, n, block, total[block], extractor, workers);
+				else
+					distribute(begin, buffer.begin(), n, block, total[block], extractor, workers);
+				inBuffer = !inBuffer;
+			}
+			if (inBuffer)
+				std::move(buffer.begin(), buffer.end(), begin);
+		}
+
+	private:
+		std::size_t threads;
+
+		/**
+		 * Runs task(0) ... task(workers - 1), all but the first one in separate threads
+		 */
+		template<typename Task>
+		static void parallel(std::size_t workers, Task task)
+		{
+			std::vector<std::thread> pool;
+			for (std::size_t worker = 1; worker < workers; ++worker)
+				pool.emplace_back(task, worker);
+			task(0);
+			for (std::thread &thread : pool)
+				thread.join();
+		}
+
+		/**
+		 * Returns first index of (worker)'s slice, slices cover [0, n) in order
+		 */
+		static std::size_t sliceStart(std::size_t n, std::size_t worker, std::size_t workers)
+		{
+			return n / workers * worker + std::min(worker, n % workers);
+		}
+
+		/**
+		 * Counts digits of every block for all elements in a single pass
+		 */
+		template<typename Iterator>
+		static void countAllBlocks(Iterator data, std::size_t n, const BitBlockExtractor &extractor,
+								   std::size_t workers, std::vector< std::vector<std::size_t> > &total)
+		{
+			std::vector< std::vector< std::vector<std::size_t> > > local(workers, total);
+			parallel(workers, [&](std::size_t worker)
+			{
+				BitBlockExtractor digits(extractor);
+				std::vector< std::vector<std::size_t> > &counts = local[worker];
+				std::size_t to = sliceStart(n, worker + 1, workers);
+				for (std::size_t i = sliceStart(n, worker, workers); i < to; ++i)
+					for (std::size_t block = 0; block < counts.size(); ++block)
+						++counts[block][digits(data[i], block)];
+			});
+			for (std::size_t worker = 0; worker < workers; ++worker)
+				for (std::size_t block = 0; block < total.size(); ++block)
+					for (std::size_t digit = 0; digit < total[block].size(); ++digit)
+						total[block][digit] += local[worker][block][digit];
+		}
+
+		/**
+		 * Moves elements from (source) to (destination) stably ordered by digit of (block)
+		 * (total) is histogram of this digit over all elements
+		 */
+		template<typename Source, typename Destination>
+		static void distribute(Source source, Destination destination, std::size_t n, std::size_t block,
+							   const std::vector<std::size_t> &total, const BitBlockExtractor &extractor,
+							   std::size_t workers)
+		{
+			std::vector< std::vector<std::size_t> > offsets(workers, std::vector<std::size_t>(total.size(), 0));
+			if (workers > 1)
+				parallel(workers, [&](std::size_t worker)
+				{
+					BitBlockExtractor digits(extractor);
+					std::size_t to = sliceStart(n, worker + 1, workers);
+					for (std::size_t i = sliceStart(n, worker, workers); i < to; ++i)
+						++offsets[worker][digits(source[i], block)];
+				});
+			else
+				offsets[0] = total;
+
+			std::size_t position = 0;
+			for (std::size_t digit = 0; digit < total.size(); ++digit)
+				for (std::size_t worker = 0; worker < workers; ++worker)
+				{
+					std::size_t count = offsets[worker][digit];
+					offsets[worker][digit] = position;
+					position += count;
+				}
+
+			parallel(workers, [&](std::size_t worker)
+			{
+				BitBlockExtractor digits(extractor);
+				std::vector<std::size_t> &next = offsets[worker];
+				std::size_t to = sliceStart(n, worker + 1, workers);
+				for (std::size_t i = sliceStart(n, worker, workers); i < to; ++i)
+					destination[next[digits(source[i], block)]++] = std::move(source[i]);
+			});
+		}
+};
+
+#endif // RADIXSORTER_H
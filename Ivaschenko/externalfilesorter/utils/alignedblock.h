@@ -0,0 +1,37 @@
+#ifndef ALIGNEDBLOCK_H
+#define ALIGNEDBLOCK_H
+
+#include <cstdlib>
+
+namespace impl
+{
+	/**
+	 * Page-aligned buffer used by block readers and writers
+	 */
+	class AlignedBlock
+	{
+		public:
+			static const std::size_t alignment = 4096;
+
+			explicit AlignedBlock(std::size_t bytes): data(0), bytes(bytes)
+			{
+				void *memory = 0;
+				if (!posix_memalign(&memory, alignment, bytes ? bytes : alignment))
+					data = static_cast<char*>(memory);
+			}
+
+			~AlignedBlock()
+			{
+				std::free(data);
+			}
+
+			char *data;
+			std::size_t bytes;
+
+		private:
+			AlignedBlock(const AlignedBlock &block);
+			AlignedBlock& operator = (const AlignedBlock &block);
+	};
+}
+
+#endif // ALIGNEDBLOCK_H
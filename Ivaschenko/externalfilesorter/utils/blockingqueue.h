@@ -0,0 +1,63 @@
+#ifndef BLOCKINGQUEUE_H
+#define BLOCKINGQUEUE_H
+
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * Simple thread-safe FIFO queue used to pass work between pipeline stages
+ * pop() blocks until an element is available or the queue is closed
+ */
+template<typename T> class BlockingQueue
+{
+	public:
+		BlockingQueue(): closed(false) {}
+
+		/**
+		 * Adds an element and wakes up one waiting consumer
+		 */
+		void push(const T &element)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				data.push(element);
+			}
+			ready.notify_one();
+		}
+
+		/**
+		 * Takes the first element, waiting for it if the queue is empty
+		 * Returns false if the queue is empty and closed
+		 */
+		bool pop(T &element)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this] { return closed || !data.empty(); });
+			if (data.empty()) return false;
+			element = data.front();
+			data.pop();
+			return true;
+		}
+
+		/**
+		 * Marks queue as finished: consumers will drain the rest and then stop
+		 */
+		void close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				closed = true;
+			}
+			ready.notify_all();
+		}
+
+	private:
+		std::queue<T> data;
+		bool closed;
+
+		std::mutex mutex;
+		std::condition_variable ready;
+};
+
+#endif // BLOCKINGQUEUE_H
@@ -0,0 +1,42 @@
+#ifndef DUPLICATEREDUCERS_H
+#define DUPLICATEREDUCERS_H
+
+namespace impl
+{
+	/**
+	 * Reducer meaning that equal elements are not collapsed at all
+	 */
+	struct NoReducer
+	{
+		template<typename DataType> void operator () (DataType &, const DataType &) const {}
+	};
+}
+
+/**
+ * Reducers used by ExternalSorter::uniqueSort to collapse equal elements
+ * Reducer is called as reducer(accumulated, next) for every element (next) equal to (accumulated)
+ * (by Comparator) and must fold (next) into (accumulated); (accumulated) is always the element
+ * which came first, so reducer must be associative but need not be commutative
+ */
+
+/**
+ * Keeps the first of equal elements (as sort -u does)
+ */
+struct KeepFirst
+{
+	template<typename DataType> void operator () (DataType &, const DataType &) const {}
+};
+
+/**
+ * Sums counters of equal elements kept in (Count) member of DataType
+ * Every input element must come with its own multiplicity (1 for a plain record)
+ */
+template<typename DataType, typename CountType, CountType DataType::*Count> struct CountDuplicates
+{
+	void operator () (DataType &accumulated, const DataType &next) const
+	{
+		accumulated.*Count += next.*Count;
+	}
+};
+
+#endif // DUPLICATEREDUCERS_H
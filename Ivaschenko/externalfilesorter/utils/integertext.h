@@ -0,0 +1,81 @@
+#ifndef INTEGERTEXT_H
+#define INTEGERTEXT_H
+
+#include <cstddef>
+#include <type_traits>
+
+namespace impl
+{
+	/**
+	 * Value of character as a digit in radix up to 36 ('0'-'9', 'a'-'z', 'A'-'Z'),
+	 * notDigit for all other characters
+	 */
+	class DigitTable
+	{
+		public:
+			static const unsigned char notDigit = 0xFF;
+
+			static unsigned char value(unsigned char c)
+			{
+				static const DigitTable table;
+				return table.digits[c];
+			}
+
+		private:
+			unsigned char digits[256];
+
+			DigitTable()
+			{
+				for (int c = 0; c < 256; ++c)
+					digits[c] = notDigit;
+				for (int c = '0'; c <= '9'; ++c)
+					digits[c] = c - '0';
+				for (int c = 'a'; c <= 'z'; ++c)
+					digits[c] = digits[c - 'a' + 'A'] = c - 'a' + 10;
+			}
+	};
+
+	/**
+	 * Integer types printed by std::ostream as numbers (character types and bool are not included)
+	 */
+	template<typename T> struct IsFormattedInteger : std::integral_constant<bool,
+			std::is_same<T, short>::value || std::is_same<T, unsigned short>::value ||
+			std::is_same<T, int>::value || std::is_same<T, unsigned int>::value ||
+			std::is_same<T, long>::value || std::is_same<T, unsigned long>::value ||
+			std::is_same<T, long long>::value || std::is_same<T, unsigned long long>::value> {};
+
+	/**
+	 * Writes decimal representation of (value) right to left ending at (end), two digits at a time
+	 * Returns pointer to the first character. 20 characters are enough for any 64-bit integer
+	 */
+	template<typename IntegerType>
+	char* formatDecimal(IntegerType value, char *end)
+	{
+		static const char pairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+
+		typedef typename std::make_unsigned<IntegerType>::type UnsignedType;
+		bool minus = value < 0;
+		UnsignedType rest = minus ? UnsignedType(0) - UnsignedType(value) : UnsignedType(value);
+		while (rest >= 100)
+		{
+			const char *pair = pairs + (rest % 100) * 2;
+			rest /= 100;
+			*--end = pair[1];
+			*--end = pair[0];
+		}
+		if (rest >= 10)
+		{
+			*--end = pairs[rest * 2 + 1];
+			*--end = pairs[rest * 2];
+		}
+		else
+			*--end = char('0' + rest);
+		if (minus) *--end = '-';
+		return end;
+	}
+}
+
+#endif // INTEGERTEXT_H
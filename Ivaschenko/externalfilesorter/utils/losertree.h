@@ -0,0 +1,136 @@
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+#include <vector>
+#include <utility>
+
+/**
+ * Tournament (loser) tree for k-way merging of sorted sequences
+ * Keeps current head of every sequence in its own slot, inner nodes of the tree store only
+ * indices of sequences, which lost the match in this node. After the winner's head is replaced
+ * only one path from leaf to root is replayed: one comparison per level
+ *
+ * Template arguments:
+ *		DataType - type of merged elements
+ *		Comparator - functor defining operator < for DataType
+ *		Stable - if true equal elements are taken from the sequence with the smaller index first
+ */
+template<typename DataType, typename Comparator, bool Stable = false> class LoserTree
+{
+	public:
+		/**
+		 * Creates tree for (ways) sequences, all of them are exhausted until activated
+		 * Elements are compared by copy of (cmp)
+		 */
+		explicit LoserTree(std::size_t ways, const Comparator &cmp = Comparator())
+			: ways(ways), heads(ways), alive(ways, false), tree(ways > 0 ? ways : 1), cmp(cmp) {}
+
+		/**
+		 * Returns slot for the current head of sequence (way)
+		 */
+		DataType& head(std::size_t way)
+		{
+			return heads[way];
+		}
+
+		/**
+		 * Marks sequence (way) as non-empty, its head must be already written to head(way)
+		 * Should be called before build()
+		 */
+		void activate(std::size_t way)
+		{
+			alive[way] = true;
+		}
+
+		/**
+		 * Plays all matches, must be called once after all heads are set
+		 */
+		void build()
+		{
+			if (ways == 0) return;
+			std::vector<std::size_t> winners(ways);
+			for (std::size_t node = ways - 1; node > 0; --node)
+			{
+				std::size_t left = playerAt(2 * node, winners), right = playerAt(2 * node + 1, winners);
+				if (beats(right, left)) std::swap(left, right);
+				winners[node] = left;
+				tree[node] = right;
+			}
+			tree[0] = ways > 1 ? winners[1] : 0;
+		}
+
+		/**
+		 * Returns true if all sequences are exhausted
+		 */
+		bool empty() const
+		{
+			return ways == 0 || !alive[tree[0]];
+		}
+
+		/**
+		 * Returns index of the sequence containing the smallest head
+		 */
+		std::size_t winner() const
+		{
+			return tree[0];
+		}
+
+		/**
+		 * Returns the smallest head
+		 */
+		DataType& top()
+		{
+			return heads[tree[0]];
+		}
+
+		/**
+		 * Should be called after head of the winner was replaced with the next element
+		 */
+		void update()
+		{
+			replay(tree[0]);
+		}
+
+		/**
+		 * Should be called when winner sequence has no more elements
+		 */
+		void exhaust()
+		{
+			alive[tree[0]] = false;
+			replay(tree[0]);
+		}
+
+	private:
+		std::size_t ways;
+		std::vector<DataType> heads;
+		std::vector<bool> alive;
+		std::vector<std::size_t> tree;
+
+		Comparator cmp;
+
+		std::size_t playerAt(std::size_t position, const std::vector<std::size_t> &winners) const
+		{
+			return position >= ways ? position - ways : winners[position];
+		}
+
+		/**
+		 * Returns true if sequence (a) should be taken before sequence (b)
+		 */
+		bool beats(std::size_t a, std::size_t b)
+		{
+			if (!alive[a] || !alive[b]) return alive[a];
+			if (Stable)
+				return cmp(heads[a], heads[b]) || (a < b && !cmp(heads[b], heads[a]));
+			return cmp(heads[a], heads[b]);
+		}
+
+		void replay(std::size_t player)
+		{
+			for (std::size_t node = (player + ways) >> 1; node > 0; node >>= 1)
+				if (beats(tree[node], player))
+					std::swap(tree[node], player);
+			tree[0] = player;
+		}
+};
+
+#endif // LOSERTREE_H
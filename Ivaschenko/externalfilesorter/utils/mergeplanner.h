@@ -0,0 +1,108 @@
+#ifndef MERGEPLANNER_H
+#define MERGEPLANNER_H
+
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include <sys/resource.h>
+
+namespace impl
+{
+	template<typename Reader> constexpr std::size_t readerBufferSize(decltype(Reader::defaultBlockSize) *)
+	{
+		return Reader::defaultBlockSize;
+	}
+
+	template<typename Reader> constexpr std::size_t readerBufferSize(...)
+	{
+		return BUFSIZ;
+	}
+}
+
+/**
+ * Chooses fan-in of k-way merge so that read buffers of all merged runs, buffer of the output run
+ * and heads of runs kept in the loser tree fit into (availableMemory) bytes and the number of
+ * simultaneously opened files does not exceed (maxOpenFiles)
+ * If there are more runs than fan-in allows, they are merged in several passes
+ */
+class MergePlanner
+{
+	public:
+		/**
+		 * Files which are left for the rest of the program by openFilesLimit()
+		 */
+		static const std::size_t reservedFiles = 16;
+
+		/**
+		 * (readBufferSize) - bytes used by one temporary reader or writer besides the element itself,
+		 * 0 if buffers should not be taken into account
+		 */
+		MergePlanner(std::size_t availableMemory, std::size_t elementSize,
+					 std::size_t readBufferSize, std::size_t maxOpenFiles)
+		{
+			std::size_t memoryWays = 0;
+			if (availableMemory > readBufferSize)
+				memoryWays = (availableMemory - readBufferSize) / (readBufferSize + elementSize);
+			std::size_t fileWays = maxOpenFiles > 0 ? maxOpenFiles - 1 : 0;
+			ways = std::max<std::size_t>(2, std::min(memoryWays, fileWays));
+		}
+
+		/**
+		 * Returns maximal number of runs merged at once
+		 */
+		std::size_t fanIn() const
+		{
+			return ways;
+		}
+
+		/**
+		 * Splits (runs) consecutive runs into groups of almost equal size for the next merge pass
+		 * Returns sizes of the groups in order, single group if all runs can be merged at once
+		 */
+		std::vector<std::size_t> nextPass(std::size_t runs) const
+		{
+			std::size_t groups = std::max<std::size_t>(1, (runs + ways - 1) / ways);
+			std::vector<std::size_t> sizes(groups, runs / groups);
+			for (std::size_t i = 0; i < runs % groups; ++i)
+				++sizes[i];
+			return sizes;
+		}
+
+		/**
+		 * Returns number of merge passes over the data needed for (runs) runs
+		 */
+		std::size_t passes(std::size_t runs) const
+		{
+			std::size_t result = 1;
+			for (; runs > ways; ++result)
+				runs = nextPass(runs).size();
+			return result;
+		}
+
+		/**
+		 * Returns bytes of buffer kept by one opened (Reader): Reader::defaultBlockSize if reader declares it
+		 * (BlockFileReader, SpillRunReader), size of stdio buffer used by file streams otherwise
+		 */
+		template<typename Reader> static constexpr std::size_t readerBufferSize()
+		{
+			return impl::readerBufferSize<Reader>(0);
+		}
+
+		/**
+		 * Returns soft limit of opened files for the process without (reservedFiles)
+		 */
+		static std::size_t openFilesLimit()
+		{
+			struct rlimit limit;
+			if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+				return 1024;
+			std::size_t files = limit.rlim_cur;
+			return files > reservedFiles + 3 ? files - reservedFiles : 3;
+		}
+
+	private:
+		std::size_t ways;
+};
+
+#endif // MERGEPLANNER_H
@@ -0,0 +1,202 @@
+#ifndef PARTITIONEDMERGER_H
+#define PARTITIONEDMERGER_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "losertree.h"
+
+/**
+ * Merges sorted runs kept in memory (usually mapped files) into one binary file using several threads
+ * Key space is cut by splitters chosen from a sample of all elements, every run is cut at the
+ * same splitters by binary search. Partition k of the output consists of partitions k of all runs,
+ * so its position in the output file is known before merging, and partitions are merged
+ * independently, each one with its own loser tree, and written by pwrite(2) at their offsets
+ * Output file has the same format as BinaryFileWriter produces (raw elements one after another)
+ *
+ * Template arguments:
+ *		DataType - trivially copyable type of merged elements
+ *		Comparator - functor defining operator < for DataType
+ *		Stable - if true equal elements are taken from the run added earlier first
+ */
+template<typename DataType, typename Comparator, bool Stable = false> class PartitionedMerger
+{
+	static_assert(std::is_trivially_copyable<DataType>::value, "PartitionedMerger requires trivially copyable type");
+
+	public:
+		/**
+		 * Chooses (partitions - 1) splitters as quantiles of (samples)
+		 * Equal splitters are merged, so there may be less partitions than requested
+		 */
+		PartitionedMerger(std::vector<DataType> samples, std::size_t partitions)
+		{
+			Comparator cmp;
+			std::sort(samples.begin(), samples.end(), cmp);
+			for (std::size_t k = 1; k < partitions && !samples.empty(); ++k)
+			{
+				const DataType &splitter = samples[k * samples.size() / partitions];
+				if (splitters.empty() || cmp(splitters.back(), splitter))
+					splitters.push_back(splitter);
+			}
+			offsets.assign(splitters.size() + 2, 0);
+		}
+
+		/**
+		 * Returns number of partitions
+		 */
+		std::size_t partitions() const
+		{
+			return splitters.size() + 1;
+		}
+
+		/**
+		 * Adds sorted run [begin, end), memory must stay valid until merge is finished
+		 * Run is cut at splitters by binary search
+		 */
+		void addRun(const DataType *begin, const DataType *end)
+		{
+			std::vector<const DataType*> bounds(1, begin);
+			for (const DataType &splitter : splitters)
+				bounds.push_back(std::lower_bound(bounds.back(), end, splitter, Comparator()));
+			bounds.push_back(end);
+
+			for (std::size_t k = 0; k < partitions(); ++k)
+				offsets[k + 1] += bounds[k + 1] - bounds[k];
+			runs.push_back(bounds);
+		}
+
+		/**
+		 * Returns total number of elements in all runs
+		 */
+		std::size_t size() const
+		{
+			std::size_t total = 0;
+			for (std::size_t k = 1; k < offsets.size(); ++k)
+				total += offsets[k];
+			return total;
+		}
+
+		/**
+		 * Merges all runs to file (fileName) by (threads) workers (hardware concurrency if threads = 0)
+		 * Every worker takes the next unmerged partition and writes it through its own buffer
+		 * of (bufferSize) elements. Returns true if no error occured
+		 */
+		bool merge(const std::string &fileName, std::size_t threads, std::size_t bufferSize) const
+		{
+			int descriptor = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (descriptor < 0) return false;
+			if (ftruncate(descriptor, size() * sizeof(DataType)) != 0)
+			{
+				close(descriptor);
+				return false;
+			}
+
+			std::vector<std::size_t> starts(partitions(), 0);
+			for (std::size_t k = 1; k < partitions(); ++k)
+				starts[k] = starts[k - 1] + offsets[k];
+
+			if (!threads)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			threads = std::min(threads, partitions());
+			bufferSize = std::max<std::size_t>(1, bufferSize);
+
+			std::atomic<std::size_t> next(0);
+			std::atomic<bool> failed(false);
+			auto work = [&]
+			{
+				std::vector<DataType> buffer(bufferSize);
+				std::size_t k;
+				while (!failed && (k = next++) < partitions())
+					if (!mergePartition(k, descriptor, starts[k], buffer))
+						failed = true;
+			};
+
+			std::vector<std::thread> workers;
+			for (std::size_t i = 1; i < threads; ++i)
+				workers.emplace_back(work);
+			work();
+			for (std::thread &worker : workers)
+				worker.join();
+
+			if (close(descriptor) != 0) failed = true;
+			return !failed;
+		}
+
+	private:
+		std::vector<DataType> splitters;
+		std::vector< std::vector<const DataType*> > runs; // bounds of partitions in every run
+		std::vector<std::size_t> offsets; // offsets[k + 1] - size of partition k
+
+		/**
+		 * Merges partition (k) of all runs with loser tree and writes it from element (start) of the file
+		 */
+		bool mergePartition(std::size_t k, int descriptor, std::size_t start, std::vector<DataType> &buffer) const
+		{
+			std::vector<const DataType*> cursors, ends;
+			for (const std::vector<const DataType*> &bounds : runs)
+			{
+				cursors.push_back(bounds[k]);
+				ends.push_back(bounds[k + 1]);
+			}
+
+			LoserTree<DataType, Comparator, Stable> tree(runs.size());
+			for (std::size_t i = 0; i < runs.size(); ++i)
+				if (cursors[i] != ends[i])
+				{
+					tree.head(i) = *cursors[i]++;
+					tree.activate(i);
+				}
+			tree.build();
+
+			std::size_t filled = 0;
+			while (!tree.empty())
+			{
+				std::size_t current = tree.winner();
+				buffer[filled++] = tree.top();
+				if (filled == buffer.size())
+				{
+					if (!writeAt(descriptor, buffer.data(), filled, start)) return false;
+					start += filled;
+					filled = 0;
+				}
+				if (cursors[current] != ends[current])
+				{
+					tree.top() = *cursors[current]++;
+					tree.update();
+				}
+				else
+					tree.exhaust();
+			}
+			return writeAt(descriptor, buffer.data(), filled, start);
+		}
+
+		/**
+		 * Writes (count) elements to file from element (position)
+		 */
+		static bool writeAt(int descriptor, const DataType *elements, std::size_t count, std::size_t position)
+		{
+			const char *data = reinterpret_cast<const char*>(elements);
+			std::size_t bytes = count * sizeof(DataType);
+			off_t offset = position * sizeof(DataType);
+			while (bytes)
+			{
+				ssize_t written = pwrite(descriptor, data, bytes, offset);
+				if (written < 0 && errno == EINTR) continue;
+				if (written <= 0) return false;
+				data += written;
+				bytes -= written;
+				offset += written;
+			}
+			return true;
+		}
+};
+
+#endif // PARTITIONEDMERGER_H
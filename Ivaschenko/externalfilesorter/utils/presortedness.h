@@ -0,0 +1,84 @@
+#ifndef PRESORTEDNESS_H
+#define PRESORTEDNESS_H
+
+#include <vector>
+#include <algorithm>
+
+namespace impl
+{
+	/**
+	 * Kinds of order found in a chunk before sorting
+	 */
+	struct ChunkOrder
+	{
+		enum Kind
+		{
+			Sorted,		// nothing to do
+			Reversed,	// strictly descending, reversed in place
+			FewRuns,	// not more than maxRuns ascending runs, merged naturally
+			Unordered	// must be sorted by Sorter
+		};
+	};
+
+	/**
+	 * Scans [begin, end) once and puts it in order if it is sorted, strictly descending
+	 * (so reversing keeps it stable) or made of not more than (maxRuns) ascending runs,
+	 * which are merged pairwise by std::inplace_merge (stable)
+	 * Scan stops as soon as chunk has more runs and is not descending, so random chunk costs
+	 * only about 2 * maxRuns comparisons, and not more than maxRuns run boundaries are stored. Returns kind of order found, chunk is left
+	 * untouched if it is Unordered
+	 */
+	template<typename RandomAccessIterator, typename Comparator>
+	ChunkOrder::Kind orderPresorted(RandomAccessIterator begin, RandomAccessIterator end,
+									Comparator cmp, std::size_t maxRuns)
+	{
+		if (end - begin < 2) return ChunkOrder::Sorted;
+
+		// while chunk is descending every element starts a run, they are only counted
+		std::vector<RandomAccessIterator> runs;
+		std::size_t descents = 0;
+		bool descending = true;
+		for (RandomAccessIterator current = begin + 1; current < end; ++current)
+		{
+			if (!cmp(*current, *(current - 1)))
+			{
+				if (!descending) continue;
+				descending = false;
+				if (descents + 1 > maxRuns) return ChunkOrder::Unordered;
+				for (RandomAccessIterator run = begin; run < current; ++run)
+					runs.push_back(run);
+			}
+			else if (descending)
+				++descents;
+			else
+			{
+				runs.push_back(current);
+				if (runs.size() > maxRuns) return ChunkOrder::Unordered;
+			}
+		}
+
+		if (descending)
+		{
+			std::reverse(begin, end);
+			return ChunkOrder::Reversed;
+		}
+		if (runs.size() == 1) return ChunkOrder::Sorted;
+
+		runs.push_back(end);
+		while (runs.size() > 2)
+		{
+			std::vector<RandomAccessIterator> merged;
+			for (std::size_t i = 0; i + 1 < runs.size(); i += 2)
+			{
+				merged.push_back(runs[i]);
+				if (i + 2 < runs.size())
+					std::inplace_merge(runs[i], runs[i + 1], runs[i + 2], cmp);
+			}
+			merged.push_back(end);
+			runs.swap(merged);
+		}
+		return ChunkOrder::FewRuns;
+	}
+}
+
+#endif // PRESORTEDNESS_H
@@ -0,0 +1,245 @@
+#ifndef SORTSTATISTICS_H
+#define SORTSTATISTICS_H
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <sstream>
+#include <algorithm>
+
+namespace impl
+{
+	/**
+	 * Phases of external sorting distinguished by statistics
+	 */
+	struct SortPhases
+	{
+		enum Phase
+		{
+			Reading,		// calls of input Reader
+			Sorting,		// sorting of chunks (heap operations of replacement selection)
+			SpillWriting,	// writing of runs to temporary files (initial ones and intermediate merge passes)
+			Merging,		// merging of runs, its time includes nested writing of merged elements
+			OutputWriting,	// calls of output Writer
+			PhasesCount
+		};
+	};
+
+	/**
+	 * Returns size of (count) records in bytes: sizeof for fixed-size types and length for strings
+	 */
+	template<typename DataType> std::uint64_t recordBytes(const DataType *, std::size_t count)
+	{
+		return std::uint64_t(count) * sizeof(DataType);
+	}
+
+	inline std::uint64_t recordBytes(const std::string *strings, std::size_t count)
+	{
+		std::uint64_t bytes = 0;
+		for (std::size_t i = 0; i < count; ++i)
+			bytes += strings[i].size();
+		return bytes;
+	}
+
+	/**
+	 * Comparator which counts its calls to (*counter)
+	 */
+	template<typename Comparator> class CountingComparator
+	{
+		public:
+			explicit CountingComparator(std::uint64_t *counter = 0): counter(counter) {}
+
+			template<typename DataType>
+			bool operator () (const DataType &a, const DataType &b)
+			{
+				++*counter;
+				return cmp(a, b);
+			}
+
+		private:
+			Comparator cmp;
+			std::uint64_t *counter;
+	};
+}
+
+/**
+ * Statistics policy of ExternalSorter which records nothing
+ * All methods are empty, so sorter without statistics does no additional work
+ */
+class NoSortStatistics : public impl::SortPhases
+{
+	public:
+		/**
+		 * Comparator used for merging
+		 */
+		template<typename Comparator> struct Compare
+		{
+			typedef Comparator Type;
+		};
+
+		class Timer
+		{
+			public:
+				Timer(NoSortStatistics &, Phase) {}
+		};
+
+		template<typename Comparator> Comparator comparator()
+		{
+			return Comparator();
+		}
+
+		template<typename DataType> void read(Phase, const DataType *, std::size_t) {}
+		template<typename DataType> void written(Phase, const DataType *, std::size_t) {}
+		void written(Phase, std::uint64_t, std::uint64_t) {}
+		void run(std::uint64_t) {}
+		void mergePass() {}
+		void buffer(std::size_t) {}
+};
+
+/**
+ * Statistics policy of ExternalSorter which collects:
+ *		- records and bytes read and written in every phase (bytes of in-memory representation
+ *		  for std::string are counted by length of strings)
+ *		- number and sizes (in records) of initial runs and number of intermediate merge passes
+ *		- time spent in every phase, in pipelined sorts phases overlap and their times are
+ *		  summed separately, time of merging includes writing of its output
+ *		- number of comparator calls made while merging runs (Sorter's own comparisons are not counted)
+ *		- peak size of the biggest buffer allocated by sorter
+ * Statistics are accumulated over all sorts done by the same sorter, reset() clears them
+ */
+class SortStatistics : public impl::SortPhases
+{
+	public:
+		struct PhaseStatistics
+		{
+			std::uint64_t recordsRead, bytesRead, recordsWritten, bytesWritten;
+			double seconds;
+		};
+
+		PhaseStatistics phases[PhasesCount];
+		std::vector<std::uint64_t> runs;
+		std::uint64_t mergePasses, comparisons;
+		std::size_t peakBufferBytes;
+
+		SortStatistics()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			for (PhaseStatistics &phase : phases)
+				phase = PhaseStatistics();
+			runs.clear();
+			mergePasses = comparisons = 0;
+			peakBufferBytes = 0;
+		}
+
+		/**
+		 * Returns name of the phase used in JSON dump
+		 */
+		static const char* phaseName(Phase phase)
+		{
+			static const char *names[PhasesCount] = {"reading", "sorting", "spillWriting", "merging", "outputWriting"};
+			return names[phase];
+		}
+
+		/**
+		 * Returns all statistics as JSON object
+		 */
+		std::string toJson() const
+		{
+			std::ostringstream out;
+			out << "{\"phases\": {";
+			for (int phase = 0; phase < PhasesCount; ++phase)
+			{
+				const PhaseStatistics &current = phases[phase];
+				out << (phase ? ", " : "") << "\"" << phaseName(Phase(phase)) << "\": {"
+					<< "\"recordsRead\": " << current.recordsRead << ", \"bytesRead\": " << current.bytesRead
+					<< ", \"recordsWritten\": " << current.recordsWritten
+					<< ", \"bytesWritten\": " << current.bytesWritten
+					<< ", \"seconds\": " << current.seconds << "}";
+			}
+			out << "}, \"runs\": [";
+			for (std::size_t i = 0; i < runs.size(); ++i)
+				out << (i ? ", " : "") << runs[i];
+			out << "], \"mergePasses\": " << mergePasses << ", \"comparisons\": " << comparisons
+				<< ", \"peakBufferBytes\": " << peakBufferBytes << "}";
+			return out.str();
+		}
+
+		// Interface used by ExternalSorter
+
+		template<typename Comparator> struct Compare
+		{
+			typedef impl::CountingComparator<Comparator> Type;
+		};
+
+		/**
+		 * Adds time from construction to destruction to the phase
+		 */
+		class Timer
+		{
+			public:
+				Timer(SortStatistics &statistics, Phase phase)
+					: seconds(&statistics.phases[phase].seconds), start(std::chrono::steady_clock::now()) {}
+
+				~Timer()
+				{
+					*seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				}
+
+			private:
+				double *seconds;
+				std::chrono::steady_clock::time_point start;
+		};
+
+		template<typename Comparator> impl::CountingComparator<Comparator> comparator()
+		{
+			return impl::CountingComparator<Comparator>(&comparisons);
+		}
+
+		/**
+		 * Records that (count) elements were read in the phase
+		 */
+		template<typename DataType> void read(Phase phase, const DataType *elements, std::size_t count)
+		{
+			phases[phase].recordsRead += count;
+			phases[phase].bytesRead += impl::recordBytes(elements, count);
+		}
+
+		/**
+		 * Records that (count) elements were written in the phase
+		 */
+		template<typename DataType> void written(Phase phase, const DataType *elements, std::size_t count)
+		{
+			written(phase, count, impl::recordBytes(elements, count));
+		}
+
+		/**
+		 * Records that (records) elements of (bytes) total size were written in the phase
+		 */
+		void written(Phase phase, std::uint64_t records, std::uint64_t bytes)
+		{
+			phases[phase].recordsWritten += records;
+			phases[phase].bytesWritten += bytes;
+		}
+
+		void run(std::uint64_t records)
+		{
+			runs.push_back(records);
+		}
+
+		void mergePass()
+		{
+			++mergePasses;
+		}
+
+		void buffer(std::size_t bytes)
+		{
+			peakBufferBytes = std::max(peakBufferBytes, bytes);
+		}
+};
+
+#endif // SORTSTATISTICS_H
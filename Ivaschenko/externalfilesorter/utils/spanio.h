@@ -0,0 +1,72 @@
+#ifndef SPANIO_H
+#define SPANIO_H
+
+#include <cstddef>
+
+namespace impl
+{
+	/**
+	 * Reads up to (count) elements with reader's span overload operator () (DataType*, std::size_t)
+	 */
+	template<typename Reader, typename DataType>
+	auto readSpan(Reader &reader, DataType *elements, std::size_t count, int)
+		-> decltype(static_cast<std::size_t>(reader(elements, count)))
+	{
+		return reader(elements, count);
+	}
+
+	/**
+	 * Fallback for readers which read elements one by one
+	 */
+	template<typename Reader, typename DataType>
+	std::size_t readSpan(Reader &reader, DataType *elements, std::size_t count, long)
+	{
+		std::size_t done = 0;
+		while (done < count && reader(elements[done]))
+			++done;
+		return done;
+	}
+
+	/**
+	 * Reads up to (count) elements to (elements) array
+	 * Returns number of elements read, it is less than (count) only if reader is exhausted
+	 */
+	template<typename Reader, typename DataType>
+	std::size_t readSpan(Reader &reader, DataType *elements, std::size_t count)
+	{
+		return readSpan(reader, elements, count, 0);
+	}
+
+	/**
+	 * Writes (count) elements with writer's span overload operator () (const DataType*, std::size_t)
+	 */
+	template<typename Writer, typename DataType>
+	auto writeSpan(Writer &writer, DataType *elements, std::size_t count, int)
+		-> decltype(static_cast<bool>(writer(elements, count)))
+	{
+		return writer(elements, count);
+	}
+
+	/**
+	 * Fallback for writers which write elements one by one
+	 */
+	template<typename Writer, typename DataType>
+	bool writeSpan(Writer &writer, DataType *elements, std::size_t count, long)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			if (!writer(elements[i])) return false;
+		return true;
+	}
+
+	/**
+	 * Writes (count) elements from (elements) array
+	 * Returns true in case of success, false otherwise
+	 */
+	template<typename Writer, typename DataType>
+	bool writeSpan(Writer &writer, DataType *elements, std::size_t count)
+	{
+		return writeSpan(writer, elements, count, 0);
+	}
+}
+
+#endif // SPANIO_H
@@ -0,0 +1,137 @@
+#ifndef SPILLFILE_H
+#define SPILLFILE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace impl
+{
+	/**
+	 * Run stored in SpillFile: offsets of its extents in order and number of bytes written
+	 */
+	struct SpillRun
+	{
+		std::vector<std::uint64_t> extents;
+		std::uint64_t bytes;
+
+		SpillRun(): bytes(0) {}
+	};
+
+	/**
+	 * One anonymous temporary file shared by all runs of a sort
+	 * File is opened with O_TMPFILE (or created by mkstemp and unlinked at once if it is not
+	 * supported), so it has no name and disappears when closed. Space is given out by extents
+	 * of (extentSize) bytes, file grows by (preallocatedExtents) extents at once and new space is
+	 * preallocated with fallocate(2) where it is available. Released extents are reused
+	 * Thread safe
+	 */
+	class SpillFile
+	{
+		public:
+			/**
+			 * Creates spill file in (directory)
+			 */
+			SpillFile(const std::string &directory, std::size_t extentSize, std::size_t preallocatedExtents)
+				: extentBytes(std::max<std::size_t>(1, extentSize)),
+				  growth(std::max<std::size_t>(1, preallocatedExtents)), end(0), reserved(0)
+			{
+				descriptor = -1;
+#ifdef O_TMPFILE
+				descriptor = open(directory.c_str(), O_TMPFILE | O_RDWR, 0600);
+#endif
+				if (descriptor < 0)
+				{
+					std::string pattern = directory + "/externalsort.XXXXXX";
+					std::vector<char> name(pattern.begin(), pattern.end());
+					name.push_back(0);
+					descriptor = mkstemp(name.data());
+					if (descriptor >= 0) unlink(name.data());
+				}
+			}
+
+			~SpillFile()
+			{
+				if (descriptor >= 0) close(descriptor);
+			}
+
+			/**
+			 * Returns true if file is opened
+			 */
+			bool ready() const
+			{
+				return descriptor >= 0;
+			}
+
+			int getDescriptor() const
+			{
+				return descriptor;
+			}
+
+			std::size_t extentSize() const
+			{
+				return extentBytes;
+			}
+
+			/**
+			 * Returns number of bytes taken by extents (used and free) from the beginning of file
+			 */
+			std::uint64_t size()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				return end;
+			}
+
+			/**
+			 * Returns offset of a free extent
+			 */
+			std::uint64_t allocate()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!freeExtents.empty())
+				{
+					std::uint64_t offset = freeExtents.back();
+					freeExtents.pop_back();
+					return offset;
+				}
+				if (end == reserved)
+				{
+					reserved += std::uint64_t(growth) * extentBytes;
+#ifdef __linux__
+					while (fallocate(descriptor, 0, end, reserved - end) != 0 && errno == EINTR);
+#endif
+				}
+				std::uint64_t offset = end;
+				end += extentBytes;
+				return offset;
+			}
+
+			/**
+			 * Returns extents of (run) to the file for reuse
+			 */
+			void release(const SpillRun &run)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				freeExtents.insert(freeExtents.end(), run.extents.rbegin(), run.extents.rend());
+			}
+
+		private:
+			std::mutex mutex;
+			int descriptor;
+			std::size_t extentBytes, growth;
+			std::uint64_t end, reserved;
+			std::vector<std::uint64_t> freeExtents;
+
+			SpillFile(const SpillFile &file);
+			SpillFile& operator = (const SpillFile &file);
+	};
+}
+
+#endif // SPILLFILE_H
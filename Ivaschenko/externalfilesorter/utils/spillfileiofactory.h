@@ -0,0 +1,89 @@
+#ifndef SPILLFILEIOFACTORY_H
+#define SPILLFILEIOFACTORY_H
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <cstdlib>
+#include <cassert>
+
+#include "spillfile.h"
+#include "../io/spillrunreader.h"
+#include "../io/spillrunwriter.h"
+
+/**
+ * Factory class with the same interface as TempFileIOFactory which keeps all runs in one anonymous
+ * spill file (see SpillFile) instead of creating a file for every run. Runs are lists of extents
+ * inside it, extents of a run are reused as soon as its reader is destroyed, so multi-pass merging
+ * does not grow the file much more than the data. Readers are opened in the same order as writers
+ * Use SpillRunReader<DataType> and SpillRunWriter<DataType> as TemporaryReader and TemporaryWriter
+ * Copies of factory share the same file
+ */
+template<typename DataType> class SpillFileIOFactory
+{
+	public:
+		static const std::size_t defaultExtentSize = 1 << 22;
+		static const std::size_t preallocatedExtents = 16;
+
+		/**
+		 * Creates spill file in (directory), TMPDIR or /tmp by default
+		 * Runs take space by extents of (extentSize) bytes, readers and writers use blocks of
+		 * (readBlockSize) and (writeBlockSize) bytes
+		 */
+		explicit SpillFileIOFactory(const std::string &directory = defaultDirectory(),
+									std::size_t extentSize = defaultExtentSize,
+									std::size_t readBlockSize = SpillRunReader<DataType>::defaultBlockSize,
+									std::size_t writeBlockSize = SpillRunWriter<DataType>::defaultBlockSize)
+			: file(new impl::SpillFile(directory, extentSize, preallocatedExtents)),
+			  readBlockSize(readBlockSize), writeBlockSize(writeBlockSize) {}
+
+		/**
+		 * Returns true if spill file is opened
+		 */
+		bool ready() const
+		{
+			return file->ready();
+		}
+
+		/**
+		 * Returns number of bytes of spill file given to runs so far
+		 */
+		std::uint64_t spillFileSize() const
+		{
+			return file->size();
+		}
+
+		/**
+		 * Open reader corresponding to the next writer
+		 */
+		std::unique_ptr< SpillRunReader<DataType> > openReader()
+		{
+			assert(!runs.empty());
+			std::shared_ptr<impl::SpillRun> run = runs.front();
+			runs.pop_front();
+			return std::unique_ptr< SpillRunReader<DataType> >(new SpillRunReader<DataType>(file, run, readBlockSize));
+		}
+
+		/**
+		 * Create writer of a new run
+		 */
+		std::unique_ptr< SpillRunWriter<DataType> > openWriter()
+		{
+			runs.push_back(std::make_shared<impl::SpillRun>());
+			return std::unique_ptr< SpillRunWriter<DataType> >
+					(new SpillRunWriter<DataType>(file, runs.back(), writeBlockSize));
+		}
+
+		static std::string defaultDirectory()
+		{
+			const char *directory = std::getenv("TMPDIR");
+			return directory && *directory ? directory : "/tmp";
+		}
+
+	private:
+		std::shared_ptr<impl::SpillFile> file;
+		std::deque< std::shared_ptr<impl::SpillRun> > runs;
+		std::size_t readBlockSize, writeBlockSize;
+};
+
+#endif // SPILLFILEIOFACTORY_H
@@ -0,0 +1,151 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace impl
+{
+	/**
+	 * Chunk of strings stored in one block of (capacity) bytes: characters are packed one after
+	 * another from the beginning of the block, index entries (8-byte key prefix, offset, length)
+	 * grow from its end. Strings are sorted by moving index entries only, most comparisons are
+	 * decided by prefixes without touching characters
+	 * Order is bytewise lexicographical (same as std::less<std::string>)
+	 */
+	class StringArena
+	{
+		public:
+			struct Entry
+			{
+				std::uint64_t prefix;
+				std::size_t offset, length;
+			};
+
+			/**
+			 * Creates empty arena, block of (capacity) bytes is allocated on the first push
+			 */
+			explicit StringArena(std::size_t capacity): slots(capacity / sizeof(Entry)), used(0), count(0) {}
+
+			/**
+			 * Returns true if a string of (length) characters can be added
+			 */
+			bool fits(std::size_t length) const
+			{
+				return used + length + (count + 1) * sizeof(Entry) <= slots * sizeof(Entry);
+			}
+
+			/**
+			 * Adds a string, it must fit into arena
+			 */
+			void push(const char *data, std::size_t length)
+			{
+				if (block.empty()) block.resize(slots);
+				Entry &entry = entryAt(count++);
+				entry.prefix = makePrefix(data, length);
+				entry.offset = used;
+				entry.length = length;
+				std::memcpy(characters() + used, data, length);
+				used += length;
+			}
+
+			/**
+			 * Sorts strings by their index entries
+			 */
+			void sort()
+			{
+				if (count == 0) return;
+				Entry *first = &entryAt(count - 1);
+				const char *base = characters();
+				std::sort(first, first + count, [base](const Entry &a, const Entry &b)
+				{
+					if (a.prefix != b.prefix) return a.prefix < b.prefix;
+					std::size_t common = std::min(a.length, b.length), skip = std::min<std::size_t>(common, 8);
+					int result = std::memcmp(base + a.offset + skip, base + b.offset + skip, common - skip);
+					return result != 0 ? result < 0 : a.length < b.length;
+				});
+			}
+
+			/**
+			 * Removes all strings, allocated block is kept for reuse
+			 */
+			void clear()
+			{
+				used = count = 0;
+			}
+
+			bool empty() const
+			{
+				return count == 0;
+			}
+
+			std::size_t size() const
+			{
+				return count;
+			}
+
+			/**
+			 * Returns number of bytes occupied by characters and index
+			 */
+			std::size_t usedBytes() const
+			{
+				return used + count * sizeof(Entry);
+			}
+
+			/**
+			 * Returns i-th string (in sorted order after sort())
+			 */
+			const char* data(std::size_t i) const
+			{
+				return characters() + entry(i).offset;
+			}
+
+			std::size_t length(std::size_t i) const
+			{
+				return entry(i).length;
+			}
+
+		private:
+			std::vector<Entry> block;
+			std::size_t slots, used, count;
+
+			char* characters()
+			{
+				return reinterpret_cast<char*>(block.data());
+			}
+
+			const char* characters() const
+			{
+				return reinterpret_cast<const char*>(block.data());
+			}
+
+			/**
+			 * Entries are stored backwards: k-th added one is at slots - 1 - k
+			 */
+			Entry& entryAt(std::size_t k)
+			{
+				return block[slots - 1 - k];
+			}
+
+			const Entry& entry(std::size_t i) const
+			{
+				return block[slots - count + i];
+			}
+
+			/**
+			 * First 8 characters as big-endian number, shorter strings are padded with zeros
+			 */
+			static std::uint64_t makePrefix(const char *data, std::size_t length)
+			{
+				std::uint64_t prefix = 0;
+				for (std::size_t i = 0; i < 8; ++i)
+					prefix = (prefix << 8) | (i < length ? static_cast<unsigned char>(data[i]) : 0);
+				return prefix;
+			}
+	};
+}
+
+#endif // STRINGARENA_H
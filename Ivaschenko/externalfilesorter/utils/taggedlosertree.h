@@ -0,0 +1,124 @@
+#ifndef TAGGEDLOSERTREE_H
+#define TAGGEDLOSERTREE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "losertree.h"
+
+namespace impl
+{
+	/**
+	 * Compact tag of a record: normalized key prefix and pointer to the record itself
+	 */
+	template<typename DataType> struct RecordTag
+	{
+		std::uint64_t prefix;
+		const DataType *record;
+	};
+
+	/**
+	 * Orders tags by prefixes, full records are compared by (Comparator) only when prefixes are equal
+	 */
+	template<typename DataType, typename Comparator> class RecordTagComparator
+	{
+		public:
+			explicit RecordTagComparator(const Comparator &cmp = Comparator()): cmp(cmp) {}
+
+			bool operator () (const RecordTag<DataType> &a, const RecordTag<DataType> &b)
+			{
+				if (a.prefix != b.prefix) return a.prefix < b.prefix;
+				return cmp(*a.record, *b.record);
+			}
+
+		private:
+			Comparator cmp;
+	};
+}
+
+/**
+ * Loser tree for merging of big records with the same interface as LoserTree
+ * Heads of sequences stay in their own slots, tournament is played on (prefix, record pointer)
+ * tags, so the hot path reads only 8-byte prefixes and full records are compared on prefix ties only
+ *
+ * Template arguments:
+ *		DataType - type of merged elements
+ *		Comparator - functor defining operator < for DataType
+ *		KeyExtractor - functor returning std::uint64_t normalized key prefix of DataType, it must
+ *		agree with Comparator: a < b implies key(a) <= key(b)
+ *		Stable - if true equal elements are taken from the sequence with the smaller index first
+ */
+template<typename DataType, typename Comparator, typename KeyExtractor, bool Stable = false> class TaggedLoserTree
+{
+	typedef impl::RecordTag<DataType> Tag;
+
+	public:
+		explicit TaggedLoserTree(std::size_t ways, const Comparator &cmp = Comparator())
+			: records(ways), tags(ways, impl::RecordTagComparator<DataType, Comparator>(cmp)) {}
+
+		/**
+		 * Returns slot for the current head of sequence (way)
+		 */
+		DataType& head(std::size_t way)
+		{
+			return records[way];
+		}
+
+		/**
+		 * Marks sequence (way) as non-empty, its head must be already written to head(way)
+		 */
+		void activate(std::size_t way)
+		{
+			tags.head(way) = tag(way);
+			tags.activate(way);
+		}
+
+		void build()
+		{
+			tags.build();
+		}
+
+		bool empty() const
+		{
+			return tags.empty();
+		}
+
+		std::size_t winner() const
+		{
+			return tags.winner();
+		}
+
+		DataType& top()
+		{
+			return records[tags.winner()];
+		}
+
+		/**
+		 * Should be called after head of the winner was replaced with the next element
+		 */
+		void update()
+		{
+			tags.top() = tag(tags.winner());
+			tags.update();
+		}
+
+		void exhaust()
+		{
+			tags.exhaust();
+		}
+
+	private:
+		std::vector<DataType> records;
+		LoserTree<Tag, impl::RecordTagComparator<DataType, Comparator>, Stable> tags;
+		KeyExtractor key;
+
+		Tag tag(std::size_t way)
+		{
+			Tag result;
+			result.prefix = key(records[way]);
+			result.record = &records[way];
+			return result;
+		}
+};
+
+#endif // TAGGEDLOSERTREE_H
@@ -2,8 +2,12 @@
 #define FILEIOFACTORY_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <cstdio>
+#include <cassert>
+#include <unistd.h>
 
 /**
  * Factory class that controlls creating Writers to write data on the disk and Readers to read it again
@@ -15,21 +19,26 @@ template< typename Reader, typename Writer> class TempFileIOFactory
 		TempFileIOFactory(): readersCnt(0) {}
 
 		/*
-		 * Deleting all temporary files
+		 * Deleting temporary files which were not read
 		 */
 		~TempFileIOFactory()
 		{
-			for (auto file : fileNames)
-				unlink(file.c_str());
+			for (std::size_t i = readersCnt; i < fileNames.size(); ++i)
+				unlink(fileNames[i].c_str());
 		}
 
 		/*
 		 * Open reader corresponding to the next writer
+		 * File is unlinked as soon as reader opens it, so its space is freed when reader is destroyed
+		 * and every merge pass gives back the runs it has consumed
 		 */
 		std::unique_ptr<Reader> openReader()
 		{
 			assert(readersCnt < fileNames.size());
-			return std::unique_ptr<Reader>(new Reader(fileNames[readersCnt++]));
+			const std::string &fileName = fileNames[readersCnt++];
+			std::unique_ptr<Reader> reader(new Reader(fileName));
+			unlink(fileName.c_str());
+			return reader;
 		}
 
 		/*
@@ -0,0 +1,89 @@
+#ifndef TOPKTHRESHOLD_H
+#define TOPKTHRESHOLD_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/**
+ * Running bound for selection of (k) smallest elements from sorted runs
+ * Every run gives checkpoints: up to (checkpointsPerRun) evenly spaced elements among its first (k)
+ * ones, checkpoint at position p certifies that the run has p elements not greater than it.
+ * Threshold is the smallest checkpoint such that checkpoints not greater than it certify
+ * at least (k) elements, so no element greater than threshold is among (k) smallest
+ * (elements equal to it may be). Checkpoints greater than threshold are dropped
+ */
+template<typename DataType, typename Comparator> class TopKThreshold
+{
+	public:
+		explicit TopKThreshold(std::size_t k, std::size_t checkpointsPerRun = 64)
+			: k(k), step(std::max<std::size_t>(1, k / std::max<std::size_t>(1, checkpointsPerRun))), found(false) {}
+
+		/**
+		 * Returns true if threshold is already known
+		 */
+		bool known() const
+		{
+			return found;
+		}
+
+		/**
+		 * Returns current threshold, known() must be true
+		 */
+		const DataType& value() const
+		{
+			return threshold;
+		}
+
+		/**
+		 * Returns true if (element) can not be among (k) smallest elements
+		 */
+		bool rejects(const DataType &element)
+		{
+			return found && cmp(threshold, element);
+		}
+
+		/**
+		 * Adds checkpoints of sorted run of (size) elements
+		 */
+		void addRun(const DataType *run, std::size_t size)
+		{
+			std::size_t limit = std::min(size, k), previous = 0;
+			for (std::size_t position = step; previous < limit; position += step)
+			{
+				position = std::min(position, limit);
+				checkpoints.push_back(Checkpoint(run[position - 1], position - previous));
+				previous = position;
+			}
+			update();
+		}
+
+	private:
+		typedef std::pair<DataType, std::size_t> Checkpoint; // element and number of elements it adds
+
+		std::size_t k, step;
+		std::vector<Checkpoint> checkpoints;
+		DataType threshold;
+		bool found;
+		Comparator cmp;
+
+		void update()
+		{
+			std::sort(checkpoints.begin(), checkpoints.end(),
+					  [this](const Checkpoint &a, const Checkpoint &b) { return cmp(a.first, b.first); });
+			std::size_t certified = 0;
+			for (std::size_t i = 0; i < checkpoints.size(); ++i)
+			{
+				certified += checkpoints[i].second;
+				if (certified >= k)
+				{
+					threshold = checkpoints[i].first;
+					found = true;
+					checkpoints.erase(checkpoints.begin() + i + 1, checkpoints.end());
+					return;
+				}
+			}
+		}
+};
+
+#endif // TOPKTHRESHOLD_H
@@ -9,6 +9,7 @@
 #include <cstring>
 
 #include "token.h"
+#include "sortkey.h"
 #include "test.h"
 
 std::vector<std::string> parseString(const std::string &s)
@@ -27,24 +28,7 @@ std::vector<std::string> parseString(const std::string &s)
 
 std::vector<std::string> sortStrings(const std::vector<std::string> &v)
 {
-	std::vector< std::vector<Token> > data;
-	std::vector<std::string> answer;
-	
-	for (auto line : v)
-	{
-		std::vector<std::string> tokens = parseString(line);
-		data.push_back(std::vector<Token>(tokens.begin(), tokens.end()));
-	}
-	
-	sort(data.begin(), data.end());
-	
-	for (auto line : data)
-	{
-		answer.push_back("");
-		for (auto part : line)
-			answer.back() += part.toString();
-	}
-	return answer;
+	return naturalSort(v);
 }
 
 std::vector<std::string> sortStrings(std::istream &in)
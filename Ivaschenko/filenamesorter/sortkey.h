@@ -0,0 +1,167 @@
+#ifndef SORT_KEY_H
+#define SORT_KEY_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace impl
+{
+	inline bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	/**
+	 * Appends (n) so that bytewise order of encodings is order of numbers:
+	 * one byte if n < 255, 255 and 8 bytes big-endian otherwise
+	 */
+	inline void appendCount(std::string &key, std::uint64_t n)
+	{
+		if (n < 0xFF)
+		{
+			key += char(n);
+			return;
+		}
+		key += char(0xFF);
+		for (int shift = 56; shift >= 0; shift -= 8)
+			key += char(n >> shift);
+	}
+}
+
+/**
+ * Appends sort key of (name) to (key)
+ * Keys compared bytewise (as memcmp, shorter key is less on common prefix) are in the same order as
+ * token sequences of names (see Token):
+ *		text run - byte 1, bytes of run with 0 escaped as 0 255, terminating 0
+ *		digit run - byte 2, number of significant digits, significant digits, number of leading zeros
+ * Key determines name, so names with equal keys are equal
+ */
+inline void appendSortKey(const std::string &name, std::string &key)
+{
+	for (std::string::size_type i = 0; i < name.length();)
+	{
+		if (impl::isDigit(name[i]))
+		{
+			std::string::size_type begin = i, significant;
+			while (i < name.length() && name[i] == '0') i++;
+			significant = i;
+			while (i < name.length() && impl::isDigit(name[i])) i++;
+			key += char(2);
+			impl::appendCount(key, i - significant);
+			key.append(name, significant, i - significant);
+			impl::appendCount(key, significant - begin);
+		}
+		else
+		{
+			key += char(1);
+			for (; i < name.length() && !impl::isDigit(name[i]); i++)
+			{
+				key += name[i];
+				if (!name[i]) key += char(0xFF);
+			}
+			key += char(0);
+		}
+	}
+}
+
+/**
+ * Precomputed key of one name: first 8 bytes of key as big-endian number decide most comparisons
+ * without touching key itself
+ */
+struct SortKeyEntry
+{
+	std::uint64_t prefix;
+	const char *key;
+	std::uint32_t length;
+	std::uint32_t index;
+
+	bool operator < (const SortKeyEntry &e) const
+	{
+		if (prefix != e.prefix) return prefix < e.prefix;
+		std::uint32_t common = std::min(length, e.length);
+		int result = std::memcmp(key, e.key, common);
+		if (result) return result < 0;
+		return length < e.length;
+	}
+};
+
+/**
+ * Sorts (names) in natural order, the same as sorting of their token sequences (see Token)
+ * Every name is tokenized once into a key, keys of one thread are kept in one buffer,
+ * so comparisons neither allocate nor parse. Keys are built and sorted by (threads) threads
+ * Supports less than 2^32 names, each with key shorter than 2^32 bytes
+ */
+inline std::vector<std::string> naturalSort(const std::vector<std::string> &names,
+											unsigned threads = std::thread::hardware_concurrency())
+{
+	std::size_t slices = std::max<std::size_t>(1, std::min<std::size_t>(threads, names.size()));
+	std::vector<std::size_t> bounds;
+	for (std::size_t i = 0; i <= slices; ++i)
+		bounds.push_back(names.size() * i / slices);
+
+	std::vector<SortKeyEntry> entries(names.size());
+	std::vector<std::string> keys(slices);
+	auto build = [&](std::size_t slice)
+	{
+		std::string &buffer = keys[slice];
+		std::vector<std::size_t> offsets;
+		for (std::size_t i = bounds[slice]; i < bounds[slice + 1]; ++i)
+		{
+			offsets.push_back(buffer.length());
+			appendSortKey(names[i], buffer);
+		}
+		offsets.push_back(buffer.length());
+
+		for (std::size_t i = bounds[slice]; i < bounds[slice + 1]; ++i)
+		{
+			SortKeyEntry &entry = entries[i];
+			std::size_t offset = offsets[i - bounds[slice]];
+			entry.key = buffer.data() + offset;
+			entry.length = offsets[i - bounds[slice] + 1] - offset;
+			entry.index = i;
+			entry.prefix = 0;
+			for (std::uint32_t j = 0; j < 8; ++j)
+				entry.prefix = entry.prefix << 8 | (j < entry.length ? (unsigned char) entry.key[j] : 0);
+		}
+		std::sort(entries.begin() + bounds[slice], entries.begin() + bounds[slice + 1]);
+	};
+
+	std::vector<std::thread> workers;
+	for (std::size_t i = 1; i < slices; ++i)
+		workers.emplace_back(build, i);
+	build(0);
+	for (auto &worker : workers)
+		worker.join();
+
+	while (bounds.size() > 2)
+	{
+		std::vector<std::size_t> merged;
+		workers.clear();
+		for (std::size_t i = 0; i + 1 < bounds.size(); i += 2)
+		{
+			merged.push_back(bounds[i]);
+			if (i + 2 < bounds.size())
+				workers.emplace_back([&entries, &bounds, i]
+					{
+						std::inplace_merge(entries.begin() + bounds[i], entries.begin() + bounds[i + 1],
+										   entries.begin() + bounds[i + 2]);
+					});
+		}
+		merged.push_back(bounds.back());
+		for (auto &worker : workers)
+			worker.join();
+		bounds.swap(merged);
+	}
+
+	std::vector<std::string> result;
+	result.reserve(names.size());
+	for (const SortKeyEntry &entry : entries)
+		result.push_back(names[entry.index]);
+	return result;
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <random>
 
 #include "token.h"
+#include "sortkey.h"
 
 std::vector<std::string> parseString(const std::string &s);
 std::vector<Token> constructTokens(const std::vector<std::string> &v);
@@ -110,11 +111,77 @@ void testTokenComparator()
 	std::cerr << "Token comparsion tested" << std::endl;
 }
 
+std::vector<Token> constructTokenSequence(const std::string &s)
+{
+	std::vector<std::string> tokens = parseString(s);
+	return std::vector<Token>(tokens.begin(), tokens.end());
+}
+
+bool keyLess(const std::string &a, const std::string &b)
+{
+	std::string aKey, bKey;
+	appendSortKey(a, aKey);
+	appendSortKey(b, bKey);
+	return aKey < bKey;
+}
+
+std::string generateName()
+{
+	const int maxBlocks = 4, maxBlockLength = 3;
+	std::uniform_int_distribution<int> blockNumberRnd(0, maxBlocks), blockLengthRnd(1, maxBlockLength), coin(0, 1);
+	std::string result;
+	for (int j = 0, state = coin(rndDevice), blocks = blockNumberRnd(rndDevice); j < blocks; j++, state ^= 1)
+	{
+		std::string block = generateBlock(blockLengthRnd(rndDevice), state);
+		if (state && coin(rndDevice)) block = "0" + block;
+		if (!state && coin(rndDevice)) block[0] = coin(rndDevice) ? '\0' : '~';
+		result += block;
+	}
+	return result;
+}
+
+void testSortKeys()
+{
+	std::vector< std::pair<std::string, std::string> > manualTests =
+	{
+		{"a", "a1"}, {"a1", "ab"}, {"a2", "a10"}, {"a10", "a010"}, {"x", "0"}, {"0", "00"},
+		{"file9.txt", "file10.txt"}, {"ab", std::string("ab\0", 3)}, {"", "a"}
+	};
+	for (auto test : manualTests)
+		testAssert("Failed manual test '" + test.first + "' < '" + test.second + "' in testSortKeys()",
+				   keyLess(test.first, test.second) && !keyLess(test.second, test.first));
+
+	const int randomTestNumber = 10000;
+	for (int i = 0; i < randomTestNumber; i++)
+	{
+		std::string a = generateName(), b = i % 5 ? generateName() : a;
+		testAssert("Failed test '" + a + "' and '" + b + "' in testSortKeys()",
+				   keyLess(a, b) == (constructTokenSequence(a) < constructTokenSequence(b)));
+	}
+
+	std::vector<std::string> names;
+	for (int i = 0; i < randomTestNumber; i++) names.push_back(generateName());
+	std::vector< std::vector<Token> > sequences;
+	for (auto name : names) sequences.push_back(constructTokenSequence(name));
+	std::sort(sequences.begin(), sequences.end());
+	std::vector<std::string> expected;
+	for (auto sequence : sequences)
+	{
+		expected.push_back("");
+		for (auto part : sequence)
+			expected.back() += part.toString();
+	}
+	for (unsigned threads : {1, 3, 8})
+		testAssert("Failed naturalSort() on random names", naturalSort(names, threads) == expected);
+	std::cerr << "Sort keys tested" << std::endl;
+}
+
 void unitTest()
 {	
 	testParsing();
 	testTokenConstructing();
 	testTokenComparator();
+	testSortKeys();
 }
 
 void integrationTest()
@@ -15,11 +15,10 @@ class Token
 			while (aZeros < a.length() && a[aZeros] == '0') aZeros++;
 			while (bZeros < b.length() && b[bZeros] == '0') bZeros++;
 			
-			std::string first = a.substr(aZeros, a.length() - aZeros);
-			std::string second = b.substr(bZeros, b.length() - bZeros);
-			
-			if (first.length() != second.length()) return first.length() < second.length();
-			if (first != second) return first < second;
+			std::string::size_type aLength = a.length() - aZeros, bLength = b.length() - bZeros;
+			if (aLength != bLength) return aLength < bLength;
+			int result = a.compare(aZeros, aLength, b, bZeros, bLength);
+			if (result) return result < 0;
 			return aZeros < bZeros;			
 		}
 
@@ -13,5 +13,6 @@ SOURCES +=
 HEADERS += \
     model/binomialheap.h \
     model/binomialheapnode.h \
+    model/nodepool.h \
     model/testaccess.h
 
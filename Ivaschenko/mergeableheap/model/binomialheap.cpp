@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <vector>
 #include <random>
+#include <set>
 
 #include "model/binomialheap.h"
 #include "model/binomialheapnode.h"
@@ -124,3 +125,166 @@ TEST(BinomialHeap, TestMergeInvariants)
 		}
 	}
 }
+
+TEST(NodePool, ReusesDestroyedObjects)
+{
+	NodePool<long long> pool;
+	std::vector<long long*> objects;
+	for (int i = 0; i < 100; ++i)
+		objects.push_back(pool.create(i));
+	for (int i = 0; i < 100; ++i)
+		ASSERT_EQ(*objects[i], i);
+
+	std::set<long long*> destroyed(objects.begin() + 50, objects.end());
+	for (int i = 50; i < 100; ++i)
+		pool.destroy(objects[i]);
+	for (int i = 50; i < 100; ++i)
+		ASSERT_EQ(destroyed.count(pool.create(-i)), 1);
+	for (int i = 0; i < 50; ++i)
+		ASSERT_EQ(*objects[i], i);
+}
+
+TEST(NodePool, Splice)
+{
+	NodePool<int> first, second;
+	int *a = first.create(1), *b = second.create(2), *c = second.create(3);
+	second.destroy(c);
+	first.splice(second);
+	ASSERT_EQ(*a, 1);
+	ASSERT_EQ(*b, 2);
+	ASSERT_EQ(first.create(4), c); // free cells of the second pool are reused
+	int *d = second.create(5);
+	ASSERT_EQ(*d, 5);
+}
+
+TEST(BinomialHeap, TestIdentifiersAfterMerge)
+{
+	std::vector<int> firstValues = RandomSequenceGenerator::genRandomSequence(300, 7, 0, 1000000);
+	std::vector<int> secondValues = RandomSequenceGenerator::genRandomSequence(500, 8, 0, 1000000);
+
+	BinomialHeap<int> first, second;
+	TestAccess< BinomialHeap<int> > heapAccess;
+	std::vector< std::pair<BinomialHeap<int>::NodeIdType, int> > ids;
+	for (int x : firstValues) ids.push_back(std::make_pair(first.push(x), x));
+	for (int x : secondValues) ids.push_back(std::make_pair(second.push(x), x));
+	for (int i = 0; i < 100; ++i) second.pop(); // some nodes of the second heap are free now
+	first.merge(second);
+	heapAccess.checkInvariants(first);
+
+	std::multiset<int> expected(secondValues.begin(), secondValues.end());
+	for (int i = 0; i < 100; ++i) expected.erase(expected.begin());
+	for (int i = 0; i < (int) firstValues.size(); ++i)
+	{
+		ASSERT_EQ(*ids[i].first, firstValues[i]);
+		expected.insert(firstValues[i]);
+	}
+	for (int i = 0; i < 200; ++i) // reuses free nodes of the second heap
+		expected.insert(*first.push(-i));
+	for (int i = 0; i < 100; ++i)
+	{
+		expected.erase(expected.find(*ids[i].first));
+		if (i % 2)
+			first.erase(ids[i].first);
+		else
+		{
+			first.decreaseKey(ids[i].first, -1000 - i);
+			ASSERT_EQ(first.pop(), -1000 - i);
+		}
+		heapAccess.checkInvariants(first);
+	}
+
+	ASSERT_EQ(first.size(), expected.size());
+	for (int x : expected)
+		ASSERT_EQ(first.pop(), x);
+	ASSERT_TRUE(first.empty());
+}
+
+TEST(BinomialHeap, TestPushPop)
+{
+	std::vector<int> values = RandomSequenceGenerator::genRandomSequence(2000, 9, 0, 20); // many equal keys
+	BinomialHeap<int> heap;
+	TestAccess< BinomialHeap<int> > heapAccess;
+	std::multiset<int> expected;
+	std::vector<BinomialHeap<int>::NodeIdType> ids;
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		int x = values[i];
+		if (i % 3 == 0 || heap.empty())
+		{
+			ids.push_back(heap.push(x));
+			expected.insert(x);
+		}
+		else
+		{
+			int answer = x;
+			if (*expected.begin() < x)
+			{
+				answer = *expected.begin();
+				expected.erase(expected.begin());
+				expected.insert(x);
+			}
+			ASSERT_EQ(heap.pushPop(x), answer);
+		}
+		heapAccess.checkInvariants(heap);
+		ASSERT_EQ(heap.top(), *expected.begin());
+		ASSERT_EQ(heap.size(), expected.size());
+	}
+	while (!heap.empty())
+	{
+		ASSERT_EQ(heap.pop(), *expected.begin());
+		expected.erase(expected.begin());
+	}
+	ASSERT_EQ(BinomialHeap<int>().pushPop(5), 5);
+}
+
+TEST(BinomialHeap, TestPushPopKeepsShape)
+{
+	BinomialHeap<int> heap;
+	TestAccess< BinomialHeap<int> > heapAccess;
+	std::vector<BinomialHeap<int>::NodeIdType> ids;
+	for (int i = 0; i < 100; ++i)
+		ids.push_back(heap.push(i));
+	std::vector<std::size_t> ranks = heapAccess.rootRanks(heap);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		ASSERT_EQ(heap.pushPop(1000 + i), i);
+		heapAccess.checkInvariants(heap);
+	}
+	ASSERT_EQ(ranks, heapAccess.rootRanks(heap)) << "pushPop should not relink the trees";
+	for (int i = 50; i < 100; ++i)
+		ASSERT_EQ(*ids[i], i);
+	ASSERT_EQ(heap.size(), 100u);
+	for (int i = 50; i < 100; ++i)
+		ASSERT_EQ(heap.pop(), i);
+}
+
+TEST(BinomialHeap, TestClear)
+{
+	static_assert(std::is_trivially_destructible< BinomialHeapNode<int, std::less<int> > >::value,
+				  "nodes of int must be released without visiting");
+
+	std::vector<int> values = RandomSequenceGenerator::genRandomSequence(1000, 10, 0, 100000);
+	BinomialHeap<std::string> strings;
+	BinomialHeap<int> ints;
+	TestAccess< BinomialHeap<int> > heapAccess;
+	auto longString = [] (int x) { return std::string(100, 'a') + std::to_string(1000000 + x); };
+	for (int round = 0; round < 3; ++round)
+	{
+		for (int x : values)
+		{
+			strings.push(longString(x)); // not trivially destructible, must be freed
+			ints.push(x);
+		}
+		for (int i = 0; i < 100; ++i)
+			ASSERT_EQ(strings.pop(), longString(ints.pop()));
+		strings.clear();
+		ints.clear();
+		ASSERT_TRUE(strings.empty());
+		ASSERT_TRUE(ints.empty());
+		ASSERT_EQ(ints.size(), 0);
+		heapAccess.checkInvariants(ints);
+	}
+	ints.push(5);
+	ASSERT_EQ(ints.top(), 5);
+}
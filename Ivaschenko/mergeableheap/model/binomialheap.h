@@ -2,8 +2,12 @@
 #define BINOMIALHEAP_H
 
 #include "binomialheapnode.h"
+#include "nodepool.h"
 
-#include <list>
+#include <vector>
+#include <cassert>
+#include <functional>
+#include <type_traits>
 
 template <typename DataType, typename Comparator> class BinomialHeap;
 template <typename DataType, typename Comparator> class BinomialHeapNodeIdentifier;
@@ -13,6 +17,7 @@ template <typename Class> class TestAccess;
 /**
  * Class representing const reference to a heap node
  * Identifier is always associated with data pushed into heap from creation to deletion
+ * It points to index cell owned by the heap, the cell follows the data when it moves between nodes
  */
 template<typename DataType, typename Comparator> class BinomialHeapNodeIdentifier
 {
@@ -20,12 +25,12 @@ template<typename DataType, typename Comparator> class BinomialHeapNodeIdentifie
 
 	private:
 		typedef BinomialHeapNode<DataType, Comparator> NodeType;
-		typedef typename std::list<NodeType*>::iterator IndexType;
+		typedef NodeType** IndexType;
 
 	public:
 		/**
-		 * @brief BinomialHeapNodeIdentifier creates new identifier from pointer to node
-		 * @param nNode pointer to node
+		 * @brief BinomialHeapNodeIdentifier creates new identifier from index cell
+		 * @param nIndex pointer to index cell of node
 		 */
 		explicit BinomialHeapNodeIdentifier(IndexType nIndex): index(nIndex) {}
 
@@ -45,12 +50,15 @@ template<typename DataType, typename Comparator> class BinomialHeapNodeIdentifie
 /**
  * Class representing binomial heap - a mergeable data structure that can do following operations in O(log n) time
  *	 - add element
- *   - find minimum
+ *   - find minimum in O(1) time
  *	 - extract minimum
  *	 - merge two structures in O(log n + log m) time
  *	 - erase element
  *	 - decrease value of element
  * Uses user-defined comparator
+ * Nodes and index cells are taken from pools owned by the heap and reused after pop and erase,
+ * so pushes and pops of a heap of stable size don't allocate memory
+ * Root with the smallest key is cached and kept up to date by every operation
  */
 template<typename DataType, typename Comparator = std::less<DataType> > class BinomialHeap
 {
@@ -58,7 +66,7 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 
 	private:
 		typedef BinomialHeapNode<DataType, Comparator> NodeType;
-		typedef typename std::list<NodeType*>::iterator IndexType;
+		typedef NodeType** IndexType;
 
 	public:
 		typedef BinomialHeapNodeIdentifier<DataType, Comparator> NodeIdType;
@@ -66,13 +74,13 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		/**
 		 * @brief BinomialHeap creates new empty heap with default Comparator
 		 */
-		BinomialHeap(): root(nullptr), indexList(), cmp() {}
+		BinomialHeap(): root(nullptr), minRoot(nullptr), count(0), cmp() {}
 
 		/**
 		 * @brief BinomialHeap creates new empty heap with specified Comparator
 		 * @param nCmp comparator
 		 */
-		explicit BinomialHeap(Comparator nCmp): root(nullptr), indexList(), cmp(nCmp) {}
+		explicit BinomialHeap(Comparator nCmp): root(nullptr), minRoot(nullptr), count(0), cmp(nCmp) {}
 
 		~BinomialHeap()
 		{
@@ -81,7 +89,7 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 
 		std::size_t size() const
 		{
-			return indexList.size();
+			return count;
 		}
 
 		/**
@@ -94,30 +102,39 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		}
 
 		/**
-		 * @brief clear erases all elements from heap
-		 * Complexity: O(n)
+		 * @brief clear erases all elements from heap and frees memory of pools
+		 * Nodes of trivially destructible data are not visited at all, pools are just released
+		 * Complexity: O(n), O(number of pool blocks) for trivially destructible DataType
 		 */
 		void clear()
 		{
-			if (root) delete root;
-			root = 0;
+			std::vector<NodeType*> stack;
+			if (root && !std::is_trivially_destructible<NodeType>::value) stack.push_back(root);
+			while (!stack.empty())
+			{
+				NodeType *node = stack.back();
+				stack.pop_back();
+				if (node->listLink) stack.push_back(node->listLink);
+				if (node->leftChild) stack.push_back(node->leftChild);
+				indexPool.destroy(node->index);
+				nodePool.destroy(node);
+			}
+			root = minRoot = 0;
+			count = 0;
 
-			indexList.clear();
+			nodePool.release();
+			indexPool.release();
 		}
 
 		/**
 		 * @brief top finds the smallest element in heap
-		 * Complexity O(log n)
-		 * @return identifier of the smallest element
+		 * Complexity O(1)
+		 * @return the smallest element
 		 */
 		DataType top() const
 		{
 			assert(!empty());
-			NodeType *answer = root;
-			for (NodeType *current = root; current; current = current->listLink)
-				if (!answer || cmp(current->key, answer->key))
-					answer = current;
-			return answer->getKey();
+			return minRoot->getKey();
 		}
 
 		/**
@@ -128,11 +145,12 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		 */
 		NodeIdType push(const DataType &value)
 		{
-			indexList.push_front(nullptr);
-			NodeType *newNode = new NodeType(value, indexList.begin());
-			indexList.front() = newNode;
-			mergeHeaps(newNode);
-			return NodeIdType(indexList.begin());
+			IndexType index = indexPool.create(nullptr);
+			NodeType *newNode = nodePool.create(value, index);
+			*index = newNode;
+			++count;
+			mergeHeaps(newNode, newNode);
+			return NodeIdType(index);
 		}
 
 		/**
@@ -144,15 +162,43 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		DataType pop()
 		{
 			assert(!empty());
-			NodeType *answer = root, *prev = 0;
-			for (NodeType *current = root; current->listLink; current = current->listLink)
-				if (!answer || cmp(current->listLink->key, answer->key))
-					answer = current->listLink, prev = current; // find minimum
+			NodeType *answer = minRoot;
 			DataType minValue(answer->key);
-			eraseNode(prev, answer);
+			eraseNode(previousRoot(answer), answer);
 			return minValue; // return value
 		}
 
+		/**
+		 * @brief pushPop adds element and then extracts the smallest one, as push and pop would do,
+		 * but without relinking: the new element replaces the smallest one in its root and sifts down
+		 * swapping with the smallest child, then the smallest root is found again.
+		 * If (value) is not greater than the smallest element, the heap is not changed at all.
+		 * Identifier of extracted element is invalidated, new element gets no identifier
+		 * Complexity: O(log^2 n) comparisons in the worst case, no memory is allocated
+		 * @param value element to add
+		 * @return value of the smallest element
+		 */
+		DataType pushPop(const DataType &value)
+		{
+			if (empty() || !cmp(minRoot->key, value)) return value; // value would be popped right away
+			NodeType *node = minRoot;
+			DataType minValue(node->key);
+			node->key = value; // index cell of extracted element now follows the new one
+			for (;;)
+			{
+				NodeType *least = node->leftChild;
+				if (!least) break;
+				for (NodeType *child = least->listLink; child; child = child->listLink)
+					if (cmp(child->key, least->key))
+						least = child;
+				if (!cmp(least->key, node->key)) break;
+				swapElementsData(node, least);
+				node = least;
+			}
+			updateMinRoot();
+			return minValue;
+		}
+
 		/**
 		 * @brief decreaseKey decreases value of specified element. Identifiers are not invalidated
 		 * Complexity: O(log n)
@@ -169,6 +215,7 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 				swapElementsData(node, node->parent);
 				node = node->parent;
 			}
+			if (!node->parent && cmp(node->key, minRoot->key)) minRoot = node; // new minimum reached root
 		}
 
 		/**
@@ -178,39 +225,39 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		 */
 		void erase(const NodeIdType &id)
 		{
-			NodeType *node = *id.index, *prev = 0;
+			NodeType *node = *id.index;
 			while (node->parent)
 			{
 				swapElementsData(node, node->parent);
 				node = node->parent;
 			}
-
-			for (NodeType *current = root; current->listLink; current = current->listLink)
-				if (current->listLink == node)
-				{
-					prev = current;
-					break;
-				}
-			eraseNode(prev, node);
+			eraseNode(previousRoot(node), node);
 		}
 
 		/**
 		 * @brief merge merges one binomial heap to another.
-		 * Identifiers of the second heap are still valid in another
+		 * Identifiers of the second heap are still valid in another, its pools are taken by this heap
 		 * Important: second heap becomes empty
 		 * Complexity: O(log n + log m)
 		 * @param heap a heap to merge with
 		 */
 		void merge(BinomialHeap<DataType, Comparator> &heap)
 		{
-			indexList.splice(indexList.begin(), heap.indexList); // Constant time merge lists
-			mergeHeaps(heap.root);
+			nodePool.splice(heap.nodePool); // Constant time, nodes stay where they are
+			indexPool.splice(heap.indexPool);
+			count += heap.count;
+			heap.count = 0;
+			NodeType *heapMin = heap.minRoot;
+			heap.minRoot = 0;
+			mergeHeaps(heap.root, heapMin);
 		}
 
 	private:
-		NodeType *root;
-		std::list<NodeType*> indexList;
+		NodeType *root, *minRoot;
+		std::size_t count;
 		Comparator cmp;
+		NodePool<NodeType> nodePool;
+		NodePool<NodeType*> indexPool;
 
 		/**
 		 * @brief swapElementsData performs swap of two nodes without splitting a key and pointer to node
@@ -224,6 +271,41 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 			first->swap(*second);
 		}
 
+		/**
+		 * @brief precedes chooses which of two roots of equal rank becomes parent of another
+		 * Cached minimum root always wins, so it stays in root list even on equal keys
+		 * @return true if (first) becomes parent of (second)
+		 */
+		bool precedes(NodeType *first, NodeType *second) const
+		{
+			return first == minRoot || (second != minRoot && cmp(first->key, second->key));
+		}
+
+		/**
+		 * @brief previousRoot finds root preceding (node) in root list
+		 * Complexity: O(log n), no comparisons of keys
+		 * @return previous root or null if (node) is the first one
+		 */
+		NodeType* previousRoot(NodeType *node) const
+		{
+			NodeType *prev = 0;
+			for (NodeType *current = root; current != node; current = current->listLink)
+				prev = current;
+			return prev;
+		}
+
+		/**
+		 * @brief updateMinRoot finds the smallest root again
+		 * Complexity: O(log n)
+		 */
+		void updateMinRoot()
+		{
+			minRoot = root;
+			for (NodeType *current = root; current; current = current->listLink)
+				if (cmp(current->key, minRoot->key))
+					minRoot = current;
+		}
+
 		/**
 		 * @brief reverseList reverses list of siblings of node (root list is stored in increasing oreder
 		 * while children list of each vertex is stored in decreasing order)
@@ -260,13 +342,18 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		 * @brief mergeHeaps merges given heap to own
 		 * Complexity: O(log n)
 		 * @param node pointer to heap.root of second heap
+		 * @param nodeMin the smallest root of second heap or null if it is unknown,
+		 * null cached minimum of own heap means that it will be recalculated by caller
 		 */
-		void mergeHeaps(NodeType* &node)
+		void mergeHeaps(NodeType* &node, NodeType *nodeMin)
 		{
 			if (!node) return;
+			if (minRoot && nodeMin && cmp(nodeMin->key, minRoot->key)) minRoot = nodeMin;
 			if (!root)
 			{
 				root = node;
+				minRoot = nodeMin;
+				node = 0;
 				return;
 			}
 			NodeType *first = root, *second = node, *temp = 0, *cur = 0;
@@ -289,7 +376,7 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 				if (copyFirst && copySecond)
 				{
 					append(cur, temp);
-					if (!cmp(copyFirst->key, copySecond->key))
+					if (!precedes(copyFirst, copySecond))
 						swap(copyFirst, copySecond);
 					copyFirst->merge(copySecond);
 					temp = copyFirst;
@@ -304,7 +391,7 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 					if (!copyFirst) swap(copyFirst, copySecond);
 					if (temp)
 					{
-						if (!cmp(copyFirst->key, temp->key)) swap(copyFirst, temp);
+						if (!precedes(copyFirst, temp)) swap(copyFirst, temp);
 						copyFirst->merge(temp);
 						temp = copyFirst;
 					}
@@ -317,26 +404,43 @@ template<typename DataType, typename Comparator = std::less<DataType> > class Bi
 		}
 
 		/**
-		 * @brief eraseNode erases node from heap and merges it's children to entire heap
+		 * @brief cutRoot cuts root off from heap and merges it's children to entire heap
+		 * Cached minimum root is reset if it was cut
 		 * Complexity: O(log n)
-		 * @param prev previous element
-		 * @param node element to delete
+		 * @param prev previous root
+		 * @param node root to cut
 		 */
-		void eraseNode(NodeType *prev, NodeType *node)
+		void cutRoot(NodeType *prev, NodeType *node)
 		{
 			for (NodeType *child = node->leftChild; child; child = child->listLink)
 				child->parent = 0; // children now have no parent
 
 			if (prev) prev->listLink = node->listLink; // cut off from list
 			else root = node->listLink;
+			if (node == minRoot) minRoot = 0;
 
 			node->leftChild = reverseList(node->leftChild);
-			mergeHeaps(node->leftChild); // merge children to root list
+			mergeHeaps(node->leftChild, nullptr); // merge children to root list, they are not less than node
 			node->listLink = 0;  // has no next element more
 			node->leftChild = 0; // has no children more
+			node->children = 0;
+		}
+
+		/**
+		 * @brief eraseNode erases node from heap and merges it's children to entire heap
+		 * Complexity: O(log n)
+		 * @param prev previous element
+		 * @param node element to delete
+		 */
+		void eraseNode(NodeType *prev, NodeType *node)
+		{
+			bool wasMin = node == minRoot;
+			cutRoot(prev, node);
+			if (wasMin) updateMinRoot();
 
-			indexList.erase(node->index); // delete reference to node from index
-			delete node; // kill him! free memory!
+			indexPool.destroy(node->index); // delete reference to node from index
+			nodePool.destroy(node); // kill him! return memory to pool!
+			--count;
 		}
 };
 
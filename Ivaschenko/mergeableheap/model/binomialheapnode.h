@@ -2,7 +2,7 @@
 #define HEAPNODE_H
 
 #include <utility>
-#include <list>
+#include <cstddef>
 
 template<typename DataType, typename Comparator> class BinomialHeap;
 template<typename DataType, typename Comparator> class BinomialHeapIndex;
@@ -12,19 +12,13 @@ template<typename DataType, typename Comparator> class BinomialHeapNode
 	friend class BinomialHeap<DataType, Comparator>;
 
 	private:
-		typedef typename std::list<BinomialHeapNode*>::iterator IndexType;
+		typedef BinomialHeapNode** IndexType;
 
 	public:
 		explicit BinomialHeapNode(const DataType &nKey, IndexType nIndex): key(nKey), parent(0),
 																			listLink(0), leftChild(0), index(nIndex),
 																			children(0) {}
 
-		~BinomialHeapNode()
-		{
-			if (leftChild) delete leftChild;
-			if (listLink) delete listLink;
-		}
-
 		/**
 		 * @brief getListLink brother of node
 		 * @return pointer to next node in list of siblings
@@ -0,0 +1,151 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * Pool of objects of one type owned by a data structure
+ * Memory is taken in blocks growing twice up to (maxBlockSize) objects, destroyed objects go to free list
+ * and are reused first, so steady push/pop does not call allocator at all. Objects never move,
+ * so pointers to them stay valid until they are destroyed or the pool is released
+ * Pools can be spliced in O(1): objects of another pool keep their addresses and become owned by this one
+ * Important: pool doesn't know which objects are alive, owner must destroy them before release()
+ */
+template<typename Type, std::size_t maxBlockSize = 4096> class NodePool
+{
+	private:
+		union Cell
+		{
+			Cell *next;
+			typename std::aligned_storage<sizeof(Type), alignof(Type)>::type data;
+		};
+
+		struct alignas(Cell) Block
+		{
+			Block *next;
+
+			Cell* cells()
+			{
+				return reinterpret_cast<Cell*>(this + 1);
+			}
+		};
+
+	public:
+		NodePool(): firstBlock(0), lastBlock(0), freeHead(0), freeTail(0), bumpBegin(0), bumpEnd(0), nextBlockSize(1) {}
+
+		NodePool(const NodePool &) = delete;
+		NodePool& operator = (const NodePool &) = delete;
+
+		~NodePool()
+		{
+			release();
+		}
+
+		/**
+		 * Constructs a new object from (args)
+		 * Complexity: O(1) amortized
+		 */
+		template<typename... Args> Type* create(Args&&... args)
+		{
+			Cell *cell = freeHead;
+			if (cell)
+			{
+				freeHead = cell->next;
+				if (!freeHead) freeTail = 0;
+			}
+			else
+			{
+				if (bumpBegin == bumpEnd) allocateBlock();
+				cell = bumpBegin++;
+			}
+			return new (&cell->data) Type(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Destroys object created by this pool (or by a pool spliced into it)
+		 * Complexity: O(1)
+		 */
+		void destroy(Type *object)
+		{
+			object->~Type();
+			Cell *cell = reinterpret_cast<Cell*>(object);
+			cell->next = freeHead;
+			if (!freeHead) freeTail = cell;
+			freeHead = cell;
+		}
+
+		/**
+		 * Takes all memory of (pool), its objects stay where they are
+		 * Unused tail of the smaller of two current blocks is not reused until release()
+		 * Important: (pool) becomes empty
+		 * Complexity: O(1)
+		 */
+		void splice(NodePool &pool)
+		{
+			if (!pool.firstBlock) return;
+			if (lastBlock) lastBlock->next = pool.firstBlock;
+			else firstBlock = pool.firstBlock;
+			lastBlock = pool.lastBlock;
+
+			if (pool.freeHead)
+			{
+				pool.freeTail->next = freeHead;
+				if (!freeHead) freeTail = pool.freeTail;
+				freeHead = pool.freeHead;
+			}
+			if (pool.bumpEnd - pool.bumpBegin > bumpEnd - bumpBegin)
+			{
+				bumpBegin = pool.bumpBegin;
+				bumpEnd = pool.bumpEnd;
+			}
+			nextBlockSize = std::max(nextBlockSize, pool.nextBlockSize);
+
+			pool.firstBlock = pool.lastBlock = 0;
+			pool.freeHead = pool.freeTail = 0;
+			pool.bumpBegin = pool.bumpEnd = 0;
+			pool.nextBlockSize = 1;
+		}
+
+		/**
+		 * Frees all memory, objects must be already destroyed
+		 * Complexity: O(number of blocks)
+		 */
+		void release()
+		{
+			while (firstBlock)
+			{
+				Block *next = firstBlock->next;
+				::operator delete(firstBlock);
+				firstBlock = next;
+			}
+			lastBlock = 0;
+			freeHead = freeTail = 0;
+			bumpBegin = bumpEnd = 0;
+			nextBlockSize = 1;
+		}
+
+	private:
+		Block *firstBlock, *lastBlock;
+		Cell *freeHead, *freeTail;
+		Cell *bumpBegin, *bumpEnd;
+		std::size_t nextBlockSize;
+
+		void allocateBlock()
+		{
+			Block *block = static_cast<Block*>(::operator new(sizeof(Block) + nextBlockSize * sizeof(Cell)));
+			block->next = 0;
+			if (lastBlock) lastBlock->next = block;
+			else firstBlock = block;
+			lastBlock = block;
+
+			bumpBegin = block->cells();
+			bumpEnd = bumpBegin + nextBlockSize;
+			nextBlockSize = std::min(nextBlockSize * 2, maxBlockSize);
+		}
+};
+
+#endif // NODEPOOL_H
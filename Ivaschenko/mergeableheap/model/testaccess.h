@@ -2,6 +2,7 @@
 #define TESTACCESS_H
 
 #include <set>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -35,6 +36,22 @@ class TestAccess< BinomialHeap<DataType, Comparator> >
 				size += add;
 			}
 			ASSERT_TRUE(size == heap.size());
+
+			bool minIsRoot = false;
+			for (NodeType *current = heap.root; current; current = current->getListLink())
+			{
+				minIsRoot |= current == heap.minRoot;
+				EXPECT_FALSE(heap.cmp(current->getKey(), heap.minRoot->getKey()));
+			}
+			ASSERT_TRUE(minIsRoot);
+		}
+
+		std::vector<std::size_t> rootRanks(const HeapType &heap)
+		{
+			std::vector<std::size_t> ranks;
+			for (NodeType *current = heap.root; current; current = current->getListLink())
+				ranks.push_back(current->getRank());
+			return ranks;
 		}
 
 	private:
@@ -49,11 +49,44 @@ class Heap
 protected:
 	vector <Vertex <T> *> list;
 	Comparator cmp;
+	Vertex <T> * minVertex; // root with minimal key, NULL if heap is empty
+
+	Vertex <T> * findMinVertex()
+	{
+		Vertex <T> * result = NULL;
+		for (int j = 0; j < list.size(); j++)
+			if (result == NULL || cmp(list[j]->key, result->key))
+				result = list[j];
+		return result;
+	}
+
+	// removes minimal root, moves its children to splitted
+	Vertex <T> * cutMin(Heap <T, Comparator> * splitted)
+	{
+		Vertex <T> * minRoot = minVertex;
+		Vertex <T> * current = minRoot->child;
+		while(current != NULL)
+		{
+			splitted->list.pb(current);
+			current->ancestor = NULL;
+			current = current->next;
+		}
+		reverse(splitted->list.begin(), splitted->list.end());
+		splitted->minVertex = splitted->findMinVertex();
+		list.erase(find(list.begin(), list.end(), minRoot));
+		minVertex = findMinVertex();
+		minRoot->child = NULL;
+		minRoot->next = NULL;
+		minRoot->degree = 0;
+		return minRoot;
+	}
+
 	public:
 	explicit Heap(Comparator _cmp)
 	{
 		list.clear();
 		cmp = _cmp;
+		minVertex = NULL;
 	}
 	//explicit Heap(vector <Vertex <T> * > _list) : list(_list) {}
 
@@ -78,10 +111,21 @@ protected:
 			}
 		}
 		
+		Vertex <T> * best = minVertex;
+		if (best == NULL || (secondHeap->minVertex != NULL && cmp(secondHeap->minVertex->key, best->key)))
+			best = secondHeap->minVertex;
+
 		Heap <T, Comparator> * resultHeap;
 		if (flagInplace)
+		{
 			list.clear();
-		else resultHeap = new Heap <T, Comparator> (cmp);
+			minVertex = best;
+		}
+		else
+		{
+			resultHeap = new Heap <T, Comparator> (cmp);
+			resultHeap->minVertex = best;
+		}
 		for (int curResult = 0; curResult < (int)new_list.size() - 1; curResult++)
 		{
 			if (new_list[curResult]->degree == new_list[curResult + 1]->degree)
@@ -89,7 +133,8 @@ protected:
 				Vertex <T> * A = new_list[curResult];
 				Vertex <T> * B = new_list[curResult + 1];
 				
-				if (!cmp(A->key, B->key))
+				// minimal root stays a root even if keys are equal
+				if (B == best || (A != best && !cmp(A->key, B->key)))
 				{
 					swap(A, B);
 				}	
@@ -137,6 +182,7 @@ protected:
 		Vertex <T> * v = new Vertex <T>(newElem);
 		
 		H2->list.pb(v);
+		H2->minVertex = v;
 		inplaceMerge(H2);
 		
 	}
@@ -144,43 +190,43 @@ protected:
 	{
 		if (list.empty())
 			return T();
-		int minIndex = 0;
-		for (int j = 1; j < list.size(); j++)
-			if (cmp(list[j]->key, list[minIndex]->key))
-			{
-				minIndex = j;
-			}
-		return list[minIndex]->key;
+		return minVertex->key;
 	}
 	T extractMin()
 	{
 		if (list.empty())
 			return T();
-		int minIndex = 0;
-		//T minElem = list[0]->key;
-		for (int j = 1; j < list.size(); j++)
-			//if (list[j]->key < minElem)
-			if (cmp(list[j]->key, list[minIndex]->key))
-			{
-				//minElem = list[j]->key;
-				minIndex = j;
-			}
-		Heap <T, Comparator> * splitted = new Heap <T, Comparator>(cmp);
-		Vertex <T> * current = list[minIndex]->child;
-		while(current != NULL)
-		{
-			splitted->list.pb(current);
-			current->ancestor = NULL;
-			current = current->next;
-		}
-		reverse(splitted->list.begin(), splitted->list.end());
-		T minElem = list[minIndex]->key;
-		list.erase(list.begin() + minIndex);
-		inplaceMerge(splitted);
+		Heap <T, Comparator> splitted(cmp);
+		Vertex <T> * minRoot = cutMin(&splitted);
+		T minElem = minRoot->key;
+		inplaceMerge(&splitted);
 		//Heap <T, Comparator> * tmpHeap = merge(splitted);
 		//list = tmpHeap->list;
 		return minElem;
 	}
+	// insert(newElem) and then extractMin() without relinking: newElem replaces the minimal key
+	// and sifts down through the smallest children, then the minimal root is found again
+	T pushPop(T newElem)
+	{
+		if (list.empty() || !cmp(minVertex->key, newElem))
+			return newElem;
+		Vertex <T> * v = minVertex;
+		T minElem = v->key;
+		v->key = newElem;
+		while (v->child != NULL)
+		{
+			Vertex <T> * least = v->child;
+			for (Vertex <T> * current = least->next; current != NULL; current = current->next)
+				if (cmp(current->key, least->key))
+					least = current;
+			if (!cmp(least->key, v->key))
+				break;
+			swap(v->key, least->key);
+			v = least;
+		}
+		minVertex = findMinVertex();
+		return minElem;
+	}
 	/*inline void deleteElem(Vertex <T> * v, T minusInf)
 	{
 		decreaseKey(v, minusInf);
@@ -194,7 +240,7 @@ protected:
 			totalSize += (1 << list[j]->degree);
 		return totalSize;
 	}
-	template <class T, class Comparator>
+	template <class U, class UComparator>
 	friend class HeapChecker;
 
 	/*void decreaseKey(pointer <T> &  v, T newValue)
@@ -223,6 +269,33 @@ public:
 	{
 		return (H->list.size() == 1 && H->list[0]->degree == powerOfTwo);
 	}
+	bool checkMinVertex(Heap <T, Comparator> * H)
+	{
+		if (H->list.empty())
+			return H->minVertex == NULL;
+		if (find(H->list.begin(), H->list.end(), H->minVertex) == H->list.end())
+			return false;
+		for (int j = 0; j < H->list.size(); j++)
+			if (H->cmp(H->list[j]->key, H->minVertex->key))
+				return false;
+		return true;
+	}
+	bool checkHeapOrder(Heap <T, Comparator> * H)
+	{
+		vector <Vertex <T> *> stack(H->list.begin(), H->list.end());
+		while (!stack.empty())
+		{
+			Vertex <T> * v = stack.back();
+			stack.pop_back();
+			for (Vertex <T> * current = v->child; current != NULL; current = current->next)
+			{
+				if (H->cmp(current->key, v->key))
+					return false;
+				stack.pb(current);
+			}
+		}
+		return true;
+	}
 	bool checkDegreeInvariant(Heap <T, Comparator> * H, int normalDegree)
 	{
 		if (H->list.empty())
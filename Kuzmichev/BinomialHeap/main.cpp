@@ -77,6 +77,7 @@ TEST(int_less_test, int_less_test)
 		ASSERT_EQ(H->getSize(), myset.size());
 		
 		ASSERT_TRUE(checker.checkDegreeInvariant(H, 14));
+		ASSERT_TRUE(checker.checkMinVertex(H));
 		//printf("iteration %d\n", j);
 		int typ;
 		while(true)
@@ -196,6 +197,36 @@ TEST(merge_test, merge_test)
 	}
 }
 
+TEST(push_pop_test, push_pop_test)
+{
+	std::less <int> cmp;
+	Heap <int, std::less <int>> * H = new Heap <int, std::less<int> > (cmp);
+	HeapChecker <int, std::less<int>> checker;
+	multiset <int> myset;
+	ASSERT_EQ(H->pushPop(5), 5);
+	forn(j, 10000)
+	{
+		int r = rand() % 100;
+		if (j % 4 == 0)
+		{
+			H->insert(r);
+			myset.insert(r);
+		}
+		else
+		{
+			myset.insert(r);
+			int right_ans = *myset.begin();
+			myset.erase(myset.begin());
+			ASSERT_EQ(H->pushPop(r), right_ans);
+		}
+		ASSERT_EQ(H->getSize(), myset.size());
+		ASSERT_TRUE(checker.checkDegreeInvariant(H, 14));
+		ASSERT_TRUE(checker.checkMinVertex(H));
+		ASSERT_TRUE(checker.checkHeapOrder(H));
+		ASSERT_EQ(H->getMin(), *myset.begin());
+	}
+}
+
 int main(int argc, char ** argv)
 {
 	testing::InitGoogleTest(&argc, argv); 
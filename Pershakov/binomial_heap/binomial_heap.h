@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <iostream>
 #include <algorithm>
 
@@ -83,15 +84,18 @@ template<class T, class Comparator> class BinomialHeap {
     public:
         BinomialHeap(){
             sz = 0;
+            min_node = NULL;
         }
 
         explicit BinomialHeap(const Comparator &new_cmp){
             cmp = new_cmp;
             sz = 0;
+            min_node = NULL;
         }
 
         explicit BinomialHeap(const T &value){
-            roots.push_back(new HeapNode(value));
+            min_node = new HeapNode(value);
+            roots.push_back(min_node);
             sz = 1;
         }
 
@@ -100,6 +104,7 @@ template<class T, class Comparator> class BinomialHeap {
             for (Iterator it = roots.begin(); it != roots.end(); it++)
                 (*it)->pred = NULL;
             sz = 0;
+            updateMin();
         }
 
         ~BinomialHeap(){
@@ -111,6 +116,7 @@ template<class T, class Comparator> class BinomialHeap {
                 destructorDfs(*it);
             roots.clear();
             sz = 0;
+            min_node = NULL;
         }
 
         bool empty(){
@@ -122,13 +128,20 @@ template<class T, class Comparator> class BinomialHeap {
         }
 
         T getMin(){
-            Iterator min_it = findMin();
-            return (*min_it)->key;
+            assert(sz != 0);
+            return min_node->key;
         }
 
 
         void merge(BinomialHeap<T, Comparator> &oth){
             sz += oth.size();
+            // min_node == NULL in non-empty heap means that caller finds it
+            if (roots.empty())
+                min_node = oth.min_node;
+            else if (min_node && oth.min_node && 
+                    cmp(oth.min_node->key, min_node->key))
+                min_node = oth.min_node;
+            oth.min_node = NULL;
             List res_list = roots;
             res_list.merge(oth.roots, DegreeCmp());
 
@@ -141,7 +154,9 @@ template<class T, class Comparator> class BinomialHeap {
                 if ((*it)->degree == (*next)->degree && 
                         (after_next == res_list.end() || 
                          (*after_next)->degree != (*next)->degree)){
-                    if (cmp((*it)->key, (*next)->key)){
+                    // minimal root stays a root even if keys are equal
+                    if (*it == min_node || 
+                            (*next != min_node && cmp((*it)->key, (*next)->key))){
                         (*it)->child.push_back(*next);
                         (*next)->pred = *it;
                         (*it)->degree++;
@@ -183,11 +198,40 @@ template<class T, class Comparator> class BinomialHeap {
             NodeIdPtr id = (*min_it)->id;
             delete *min_it;
             roots.erase(min_it);
+            min_node = NULL;
             merge(new_heap);
+            updateMin();
             sz = old_sz;
             return std::make_pair(min_val, id);
         }
 
+        /*
+         * Inserts value and extracts minimum, as insert and extractMin 
+         * would do, but without relinking: value takes the place (and the 
+         * id) of minimum and sifts down through the smallest children, then 
+         * the minimal root is found again. If value is not greater than 
+         * minimum, it is returned and the heap is not changed.
+         */
+        T pushPop(const T &value){
+            if (sz == 0 || !cmp(min_node->key, value))
+                return value;
+            HeapNode *node = min_node;
+            T min_val = node->key;
+            node->key = value;
+            while (!node->child.empty()){
+                HeapNode *least = node->child.front();
+                for (Iterator it = node->child.begin(); it != node->child.end(); it++)
+                    if (cmp((*it)->key, least->key))
+                        least = *it;
+                if (!cmp(least->key, node->key))
+                    break;
+                swap(node, least);
+                node = least;
+            }
+            updateMin();
+            return min_val;
+        }
+
         void decreaseKey(NodeIdPtr id, const T &new_val){
             assert(id);
             assert(id->node_ptr);
@@ -201,6 +245,8 @@ template<class T, class Comparator> class BinomialHeap {
                 } else 
                     break;
             }
+            if (!cur_node->pred && cmp(new_val, min_node->key))
+                min_node = cur_node;
         }
 
         void erase(NodeIdPtr id){
@@ -218,8 +264,13 @@ template<class T, class Comparator> class BinomialHeap {
                     roots.erase(it);
                     break;
                 }
+            bool was_min = cur_node == min_node;
+            if (was_min)
+                min_node = NULL;
             delete cur_node;
             merge(new_heap);
+            if (was_min)
+                updateMin();
             sz = old_sz;
         }
 
@@ -227,14 +278,18 @@ template<class T, class Comparator> class BinomialHeap {
         Comparator cmp;
         List roots;
         int sz;
+        HeapNode *min_node;
 
         Iterator findMin(){
             assert(sz != 0);
-            Iterator cur_min = roots.begin();
+            return std::find(roots.begin(), roots.end(), min_node);
+        }
+
+        void updateMin(){
+            min_node = roots.empty() ? NULL : roots.front();
             for (Iterator it = roots.begin(); it != roots.end(); it++)
-                if (cmp((*it)->key, (*cur_min)->key))
-                    cur_min = it;
-            return cur_min;
+                if (cmp((*it)->key, min_node->key))
+                    min_node = *it;
         }
 
         void swap(HeapNode *a, HeapNode *b){ 
@@ -246,11 +301,17 @@ template<class T, class Comparator> class BinomialHeap {
             b->id->node_ptr = b;
         }
 
+        /*
+         * Deletes subtree of node using explicit stack instead of recursion
+         */
         void destructorDfs(HeapNode *node){
-            for (Iterator it = node->child.begin(); 
-                    it != node->child.end(); it++)
-                destructorDfs(*it);
-            delete node;
+            std::vector<HeapNode*> stack(1, node);
+            while (!stack.empty()){
+                HeapNode *cur = stack.back();
+                stack.pop_back();
+                stack.insert(stack.end(), cur->child.begin(), cur->child.end());
+                delete cur;
+            }
         }
 };
 
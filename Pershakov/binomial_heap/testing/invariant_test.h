@@ -81,6 +81,28 @@ namespace InvariantTesting {
         }
     }
 
+    void pushPop(MyTestHeap &heap){
+        int cnt = rand() % 1000;
+        for (int i = 0; i < cnt; i++){
+            if (heap.empty())
+                return;
+            int val = rand();
+            int mn = heap.getMin();
+            NodeIdPtr id = heap.minId();
+            if (val <= mn){
+                ASSERT_EQ(heap.pushPop(val), val);
+                continue;
+            }
+            ASSERT_EQ(heap.pushPop(val), mn);
+            // id of minimum goes to the new value
+            eraseFromVector<int, std::less<int> >(values, mn);
+            values.push_back(val);
+            eraseFromVector<NodeIdPtr, std::less<NodeIdPtr> >(ids[mn], id);
+            ids[val].push_back(id);
+            ASSERT_TRUE(heap.checkInvariant());
+        }
+    }
+
     /*
      * Check if BinomialHeap is really binomial heap
      */
@@ -114,6 +136,7 @@ namespace InvariantTesting {
             merge(heap);
             insert(heap);
             decreaseKey(heap);
+            pushPop(heap);
             extractMin(heap);
         }
     }
@@ -28,10 +28,28 @@ template<class T, class Comparator> class TestHeap :
                 if (!checkBinomialTree(*it, (*it)->degree))
                     return false;
             }
-            return true;
+            return checkMin();
+        }
+
+        NodeId<T>* minId(){
+            return this->min_node->id;
         }
 
     private:
+        bool checkMin(){
+            if (this->roots.empty())
+                return this->min_node == NULL;
+            bool found = false;
+            for (Iterator it = this->roots.begin(); 
+                    it != this->roots.end(); it++){
+                if (*it == this->min_node)
+                    found = true;
+                if (this->cmp((*it)->key, this->min_node->key))
+                    return false;
+            }
+            return found;
+        }
+
         bool checkDegrees(const List &to_check){
             if (to_check.empty())
                 return true;
@@ -79,4 +79,23 @@ TEST(UnitTest, EraseEmptySize){
     ASSERT_TRUE(heap.empty());
 }
 
+TEST(UnitTest, PushPopEmptySize){
+    BinomialHeap<int, std::less<int> > heap;
+    ASSERT_EQ(heap.pushPop(5), 5);
+    ASSERT_TRUE(heap.empty());
+    int n = 100000;
+    addInterval(heap, 0, n - 1);
+    ASSERT_EQ(heap.pushPop(-1), -1);
+    for (int i = 0; i < n; i++){
+        ASSERT_EQ(heap.pushPop(n + i), i);
+        ASSERT_EQ(heap.getMin(), i + 1);
+        ASSERT_EQ(heap.size(), n);
+    }
+    for (int i = 0; i < n; i++){
+        ASSERT_EQ(heap.getMin(), n + i);
+        heap.extractMin();
+    }
+    ASSERT_TRUE(heap.empty());
+}
+
 #endif
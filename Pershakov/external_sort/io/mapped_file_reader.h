@@ -0,0 +1,91 @@
+#ifndef MAPPED_FILE_READER
+
+#define MAPPED_FILE_READER
+
+#include <string>
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Reader of fixed-size records mapped to memory with mmap
+ * Records are copied straight from the mapping, 
+ * operator () (T*, int) copies whole block at once
+ */
+
+template <class T> class MappedFileReader {
+    static_assert(std::is_trivially_copyable<T>::value, 
+            "MappedFileReader needs trivially copyable type");
+
+    public:
+        explicit MappedFileReader(): data(NULL), bytes(0), pos(0){}
+
+        explicit MappedFileReader(const std::string &filename): data(NULL){
+            setStream(filename);
+        }
+
+        explicit MappedFileReader(const char *filename): data(NULL){
+            setStream(filename);
+        }
+
+        ~MappedFileReader(){
+            close();
+        }
+
+        void close(){
+            if (data)
+                munmap(data, bytes);
+            data = NULL;
+            bytes = pos = 0;
+        }
+
+        void setStream(const std::string &filename){
+            setStream(filename.c_str());
+        }
+
+        void setStream(const char *filename){
+            close();
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0)
+                return;
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0){
+                void *mapped = mmap(NULL, info.st_size, PROT_READ, 
+                        MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED){
+                    data = (char*)mapped;
+                    bytes = info.st_size;
+                    madvise(mapped, bytes, MADV_SEQUENTIAL);
+                }
+            }
+            ::close(fd);
+        }
+
+        bool operator () (T &next){
+            if (pos + sizeof(T) > bytes)
+                return false;
+            memcpy(&next, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        int operator () (T *to, int count){
+            count = std::min((size_t)count, (bytes - pos) / sizeof(T));
+            memcpy(to, data + pos, count * sizeof(T));
+            pos += count * sizeof(T);
+            return count;
+        }
+
+    private:
+        char *data;
+        size_t bytes, pos;
+
+        MappedFileReader(const MappedFileReader &);
+        MappedFileReader &operator = (const MappedFileReader &);
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef MAPPED_FILE_WRITER
+
+#define MAPPED_FILE_WRITER
+
+#include <string>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*
+ * Writer of fixed-size records to memory mapped file
+ * File grows by windows of window_size bytes, each window is reserved
+ * with posix_fallocate, mapped with mmap and records are copied straight
+ * into it, so full disk fails a write instead of raising SIGBUS.
+ * Unused tail of the last window is truncated on close
+ */
+
+template <class T> class MappedFileWriter {
+    static_assert(std::is_trivially_copyable<T>::value, 
+            "MappedFileWriter needs trivially copyable type");
+
+    public:
+        static const size_t default_window_size = 1 << 26;
+
+        explicit MappedFileWriter(){
+            init(default_window_size);
+        }
+
+        explicit MappedFileWriter(const std::string &filename, 
+                size_t window_size = default_window_size){
+            init(window_size);
+            setStream(filename);
+        }
+
+        explicit MappedFileWriter(const char *filename, 
+                size_t window_size = default_window_size){
+            init(window_size);
+            setStream(filename);
+        }
+
+        ~MappedFileWriter(){
+            close();
+        }
+
+        /*
+         * Returns false if writing or closing failed
+         */
+        bool close(){
+            if (fd < 0)
+                return !failed;
+            size_t written = offset;
+            if (window){
+                munmap(window, window_bytes);
+                written += used;
+            }
+            if (ftruncate(fd, written) != 0)
+                failed = true;
+            if (::close(fd) != 0)
+                failed = true;
+            fd = -1;
+            window = NULL;
+            used = window_bytes;
+            return !failed;
+        }
+
+        void setStream(const std::string &filename){
+            setStream(filename.c_str());
+        }
+
+        void setStream(const char *filename){
+            close();
+            fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+            offset = 0;
+            used = window_bytes;
+            failed = fd < 0;
+        }
+
+        bool operator () (const T &next, const std::string &separator = ""){
+            if (used + sizeof(T) <= window_bytes){
+                memcpy(window + used, &next, sizeof(T));
+                used += sizeof(T);
+                return true;
+            }
+            return put((const char*)&next, sizeof(T));
+        }
+
+        bool operator () (const T *from, int count){
+            return put((const char*)from, count * sizeof(T));
+        }
+
+    private:
+        int fd;
+        char *window;
+        size_t window_bytes, offset, used;
+        bool failed;
+
+        void init(size_t window_size){
+            size_t page = sysconf(_SC_PAGESIZE);
+            fd = -1;
+            window = NULL;
+            window_bytes = std::max((size_t)1, 
+                    (window_size + page - 1) / page) * page;
+            offset = 0;
+            used = window_bytes;
+            failed = false;
+        }
+
+        bool put(const char *from, size_t size){
+            while (size > 0){
+                if (used == window_bytes && !nextWindow())
+                    return false;
+                size_t part = std::min(size, window_bytes - used);
+                memcpy(window + used, from, part);
+                used += part;
+                from += part;
+                size -= part;
+            }
+            return true;
+        }
+
+        bool nextWindow(){
+            if (fd < 0 || failed)
+                return false;
+            if (window){
+                munmap(window, window_bytes);
+                window = NULL;
+                offset += window_bytes;
+            }
+            int error;
+            while ((error = posix_fallocate(fd, offset, window_bytes)) == EINTR);
+            void *mapped = MAP_FAILED;
+            if (error == 0)
+                mapped = mmap(NULL, window_bytes, PROT_READ | PROT_WRITE, 
+                        MAP_SHARED, fd, offset);
+            if (mapped == MAP_FAILED){
+                failed = true;
+                return false;
+            }
+            window = (char*)mapped;
+            used = 0;
+            return true;
+        }
+
+        MappedFileWriter(const MappedFileWriter &);
+        MappedFileWriter &operator = (const MappedFileWriter &);
+};
+
+#endif
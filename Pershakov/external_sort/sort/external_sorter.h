@@ -5,27 +5,11 @@
 #include <string>
 #include <string.h>
 #include <vector>
-#include <queue>
 #include <cstdio>
 #include <utility>
 #include <iostream>
 #include <memory>
-
-/*
- * Comparator for pair<T, int> 
- */
-template<class T, class Comparator> struct cmp {
-    bool operator() 
-        (const std::pair<T, int> &a, const std::pair<T, int> &b) const{
-        Comparator comparator;
-        if (comparator(a.first, b.first))
-            return false;
-        else if (comparator(b.first, a.first))
-            return true;
-        else
-            return (a < b);
-    }
-};
+#include "loser_tree.h"
 
 const std::string default_filename = "result.txt";
 
@@ -91,48 +75,65 @@ class ExternalSorter {
         std::vector<std::string> temp_files;
 
         std::vector<T> readBlock(Reader &reader){
-            T next;
             std::vector<T> block(block_size);
-            int cur_sz = 0;
-            while (cur_sz < block_size && reader(next)){
-                block[cur_sz] = next;
-                cur_sz++;
-            }
-            block.resize(cur_sz);
+            block.resize(readMany(reader, block.data(), block_size, 0));
             return block;
         }
 
         void writeBlock(const std::vector<T> &to_write, 
                 const std::string &filename){
             Writer writer(filename);
-            for (int i = 0; i < (int)to_write.size(); i++)
-                writer(to_write[i]);
+            writeMany(writer, to_write.data(), to_write.size(), 0);
+        }
+
+        /*
+         * Readers and writers with operator () (T*, int) get whole block 
+         * at once, others are called for every element
+         */
+        template<class R>
+        auto readMany(R &reader, T *to, int count, int) 
+                -> decltype((int)reader(to, count)){
+            return reader(to, count);
+        }
+
+        template<class R>
+        int readMany(R &reader, T *to, int count, long){
+            int cur_sz = 0;
+            while (cur_sz < count && reader(to[cur_sz]))
+                cur_sz++;
+            return cur_sz;
+        }
+
+        template<class W>
+        auto writeMany(W &writer, const T *from, int count, int) 
+                -> decltype((void)writer(from, count)){
+            writer(from, count);
+        }
+
+        template<class W>
+        void writeMany(W &writer, const T *from, int count, long){
+            for (int i = 0; i < count; i++)
+                writer(from[i]);
         }
 
         void merge(){
-            typedef std::vector<std::pair<T, int> > HeapContainer;
-            typedef std::pair<T, int> HeapElement;
-            std::priority_queue<HeapElement, HeapContainer, 
-                cmp<T, Comparator> > heap;
             int cnt_blocks = temp_files.size();
             std::vector<Reader> readers(cnt_blocks);
+            LoserTree<T, Comparator> tree(cnt_blocks);
             for (int i = 0; i < cnt_blocks; i++){
                 readers[i].setStream(temp_files[i]);
-                T buf;
-                if (readers[i](buf)){
-                    heap.push(std::make_pair(buf, i));                
-                }
+                if (readers[i](tree.head(i)))
+                    tree.activate(i);
             }
+            tree.build();
             Writer writer(result_filename);
-            int q = 0;
-            while (!heap.empty()){
-                q++;
-                std::pair<T, int> top = heap.top();
-                heap.pop();
-                writer(top.first);
-                T buf;
-                if (readers[top.second](buf))
-                    heap.push(std::make_pair(buf, top.second));
+            while (!tree.empty()){
+                int cur = tree.winner();
+                writer(tree.top());
+                if (readers[cur](tree.top()))
+                    tree.update();
+                else
+                    tree.exhaust();
             }
         }
 
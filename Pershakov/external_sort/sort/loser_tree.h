@@ -0,0 +1,90 @@
+#ifndef LOSER_TREE
+
+#define LOSER_TREE
+
+#include <vector>
+#include <utility>
+
+/*
+ * Tournament tree for k-way merge.
+ * Inner nodes store only numbers of sources that lost there, 
+ * so replacing the winner costs one comparison per level.
+ * If stable, equal elements are taken from the source with smaller number.
+ */
+template<class T, class Comparator, bool stable = true> class LoserTree {
+    public:
+        explicit LoserTree(int new_ways) : ways(new_ways), heads(new_ways),
+            alive(new_ways, false), tree(new_ways > 0 ? new_ways : 1) {}
+
+        T& head(int way){
+            return heads[way];
+        }
+
+        void activate(int way){
+            alive[way] = true;
+        }
+
+        void build(){
+            if (ways == 0)
+                return;
+            std::vector<int> winners(ways);
+            for (int node = ways - 1; node > 0; node--){
+                int a = getPlayer(2 * node, winners);
+                int b = getPlayer(2 * node + 1, winners);
+                if (beats(b, a))
+                    std::swap(a, b);
+                winners[node] = a;
+                tree[node] = b;
+            }
+            tree[0] = (ways > 1 ? winners[1] : 0);
+        }
+
+        bool empty() const{
+            return ways == 0 || !alive[tree[0]];
+        }
+
+        int winner() const{
+            return tree[0];
+        }
+
+        T& top(){
+            return heads[tree[0]];
+        }
+
+        void update(){
+            replay(tree[0]);
+        }
+
+        void exhaust(){
+            alive[tree[0]] = false;
+            replay(tree[0]);
+        }
+
+    private:
+        int ways;
+        std::vector<T> heads;
+        std::vector<bool> alive;
+        std::vector<int> tree;
+
+        int getPlayer(int pos, const std::vector<int> &winners) const{
+            return pos >= ways ? pos - ways : winners[pos];
+        }
+
+        bool beats(int a, int b){
+            if (!alive[a] || !alive[b])
+                return alive[a];
+            Comparator comparator;
+            if (comparator(heads[a], heads[b]))
+                return true;
+            return stable && a < b && !comparator(heads[b], heads[a]);
+        }
+
+        void replay(int cur){
+            for (int node = (cur + ways) / 2; node > 0; node /= 2)
+                if (beats(tree[node], cur))
+                    std::swap(tree[node], cur);
+            tree[0] = cur;
+        }
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <sys/stat.h>
+#include "../../io/mapped_file_reader.h"
+#include "../../io/mapped_file_writer.h"
+
+/*
+ * MappedFileReader and MappedFileWriter testing
+ */
+
+TEST(TestMappedFile, singleElements){
+    std::string filename = "mapped_file.out";
+    int a = -1, b = 232, c = -2323;
+    {
+        MappedFileWriter<int> writer(filename);
+        EXPECT_TRUE(writer(a));
+        EXPECT_TRUE(writer(b));
+        EXPECT_TRUE(writer(c));
+        EXPECT_TRUE(writer.close());
+        EXPECT_FALSE(writer(a));
+    }
+
+    struct stat info;
+    ASSERT_EQ(0, stat(filename.c_str(), &info));
+    EXPECT_EQ(3 * sizeof(int), (size_t)info.st_size);
+
+    MappedFileReader<int> reader(filename);
+    int new_a, new_b, new_c;
+    EXPECT_TRUE(reader(new_a));
+    EXPECT_TRUE(reader(new_b));
+    EXPECT_TRUE(reader(new_c));
+    EXPECT_FALSE(reader(new_c));
+    EXPECT_EQ(a, new_a);
+    EXPECT_EQ(b, new_b);
+    EXPECT_EQ(c, new_c);
+}
+
+TEST(TestMappedFile, blocksAcrossWindows){
+    std::string filename = "mapped_file.out";
+    const int sz = 10000;
+    std::vector<long long> data(sz);
+    for (int i = 0; i < sz; i++)
+        data[i] = (long long)i * i - 5000;
+    {
+        MappedFileWriter<long long> writer(filename, 1);
+        EXPECT_TRUE(writer(data.data(), 1000));
+        for (int i = 1000; i < 1001; i++)
+            EXPECT_TRUE(writer(data[i]));
+        EXPECT_TRUE(writer(data.data() + 1001, sz - 1001));
+    }
+
+    MappedFileReader<long long> reader(filename);
+    std::vector<long long> result(sz + 5);
+    EXPECT_EQ(10, reader(result.data(), 10));
+    EXPECT_EQ(sz - 10, reader(result.data() + 10, sz + 5 - 10));
+    result.resize(sz);
+    EXPECT_EQ(data, result);
+}
+
+TEST(TestMappedFile, emptyAndMissing){
+    std::string filename = "mapped_file.out";
+    {
+        MappedFileWriter<int> writer(filename);
+    }
+    MappedFileReader<int> reader(filename);
+    int cur;
+    EXPECT_FALSE(reader(cur));
+
+    MappedFileReader<int> missing("no/such/file");
+    EXPECT_FALSE(missing(cur));
+    MappedFileWriter<int> bad_writer("no/such/file");
+    EXPECT_FALSE(bad_writer(cur));
+    EXPECT_FALSE(bad_writer.close());
+}
@@ -7,6 +7,8 @@
 #include "../../sort/sorter.h"
 #include "../../sort/digital_sorter.h"
 #include "../../sort/external_sorter.h"
+#include "../../io/mapped_file_reader.h"
+#include "../../io/mapped_file_writer.h"
 
 /*
  * Integration test for ExternalSorter using Sorter
@@ -150,3 +152,53 @@ TEST(IntegrationTest, usingTextFilesBigDigital){
     }
     ASSERT_FALSE(in >> cur);
 }
+
+/*
+ * Integration test for ExternalSorter using memory mapped files
+ * of 16-byte records
+ */
+
+struct MappedRecord {
+    unsigned long long key, id;
+
+    bool operator < (const MappedRecord &other) const {
+        return key < other.key;
+    }
+};
+
+TEST(IntegrationTest, usingMappedFiles){
+    std::string filename = "mapped_records.in";
+    std::string result = "mapped_records.out";
+    const int sz = 200000;
+    unsigned long long seed = 7;
+    {
+        MappedFileWriter<MappedRecord> out(filename);
+        for (int i = 0; i < sz; i++){
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            MappedRecord cur = {seed >> 16, (unsigned long long)i};
+            ASSERT_TRUE(out(cur));
+        }
+    }
+
+    ExternalSorter<MappedRecord, MappedFileReader<MappedRecord>, 
+        MappedFileWriter<MappedRecord>, 
+        Sorter<MappedRecord, std::less<MappedRecord> >, 
+        std::less<MappedRecord> > sorter(filename);
+    sorter.setResultFile(result);
+    sorter.sort(30000);
+
+    MappedFileReader<MappedRecord> in(result);
+    std::vector<bool> used(sz, false);
+    MappedRecord last = {0, 0}, cur;
+    for (int i = 0; i < sz; i++){
+        ASSERT_TRUE(in(cur));
+        ASSERT_FALSE(cur < last);
+        ASSERT_LT(cur.id, (unsigned long long)sz);
+        ASSERT_FALSE(used[cur.id]);
+        used[cur.id] = true;
+        last = cur;
+    }
+    ASSERT_FALSE(in(cur));
+    remove(filename.c_str());
+    remove(result.c_str());
+}
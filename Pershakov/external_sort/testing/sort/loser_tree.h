@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include "../../sort/loser_tree.h"
+
+/*
+ * LoserTree testing
+ */
+
+TEST(TestLoserTree, StableMerge){
+    srand(2014);
+    for (int ways = 1; ways < 40; ways++){
+        std::vector<std::vector<int> > blocks(ways);
+        std::vector<std::pair<int, int> > expected;
+        for (int i = 0; i < ways; i++){
+            blocks[i].resize(rand() % 50);
+            for (int j = 0; j < (int)blocks[i].size(); j++)
+                blocks[i][j] = rand() % 10;
+            std::sort(blocks[i].begin(), blocks[i].end());
+            for (int j = 0; j < (int)blocks[i].size(); j++)
+                expected.push_back(std::make_pair(blocks[i][j], i));
+        }
+        std::sort(expected.begin(), expected.end());
+
+        LoserTree<int, std::less<int> > tree(ways);
+        std::vector<int> pos(ways, 0);
+        for (int i = 0; i < ways; i++)
+            if (!blocks[i].empty()){
+                tree.head(i) = blocks[i][pos[i]++];
+                tree.activate(i);
+            }
+        tree.build();
+        for (int i = 0; i < (int)expected.size(); i++){
+            ASSERT_FALSE(tree.empty());
+            int cur = tree.winner();
+            ASSERT_EQ(expected[i], std::make_pair(tree.top(), cur));
+            if (pos[cur] < (int)blocks[cur].size()){
+                tree.top() = blocks[cur][pos[cur]++];
+                tree.update();
+            }
+            else
+                tree.exhaust();
+        }
+        ASSERT_TRUE(tree.empty());
+    }
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include "io/input.h"
 #include "io/output.h"
+#include "io/mapped.h"
 #include "sort/digital_sort.h"
 #include "sort/external_sort.h"
+#include "sort/loser_tree.h"
 
 int main(int argc, char **argv){
     ::testing::InitGoogleTest(&argc, argv);
@@ -22,6 +22,18 @@ template <typename DataType>
 class ExternalSorter
 {
 public:
+    /**
+    * Arguments:
+    *       readBufferSize - bytes of stream buffer in every opened temporary file,
+    *                        they are counted against avaliable memory while merging
+    *       maxOpenFiles - maximum of temporary files opened at once
+    * If there are more parts than fit into these limits, they are merged in several passes
+    */
+    explicit ExternalSorter(std::size_t readBufferSize = BUFSIZ, int maxOpenFiles = 64)
+        : readBufferSize(readBufferSize), maxOpenFiles(maxOpenFiles)
+    {
+    }
+
     /**
     * This function creates readers and writers by itself
     * It gets filenames and uses fstream to read this data in text format
@@ -79,17 +91,17 @@ public:
             writeData(rsize, bw, arr);
             bw.close();
             parts++;
-            assert(parts < 10000);
-
         }
         reader.close();
-        merge(parts, writer, cmp);
+        merge(memorysize, parts, writer, cmp);
         writer.close();
-        clean_up_files(parts);
     }
 
 
 private:
+    std::size_t readBufferSize;
+    int maxOpenFiles;
+
     /**
     * This struct is for comparation pair
     * This comparator compare by only first param
@@ -111,8 +123,54 @@ private:
         }
     };
 
+    /**
+    * This function returns how many parts may be merged at once
+    * Buffers of all opened parts and of the output file and heap must fit into memorysize,
+    * one file is left for the output. At least 2 parts are merged at once
+    */
+    int getFanIn(std::size_t memorysize)
+    {
+        std::size_t byMemory = 0;
+        if (memorysize > readBufferSize)
+            byMemory = (memorysize - readBufferSize) / (readBufferSize + sizeof (std :: pair<DataType, void*>));
+        int fanIn = std :: min<std :: size_t>(byMemory, maxOpenFiles - 1);
+        return std :: max(fanIn, 2);
+    }
+
+    /**
+    * This function merges all parts into writer
+    * While there are more parts than getFanIn allows, consecutive parts are merged into new temporary
+    * files, merged parts are removed at once
+    */
+    template <typename Writer, typename Comparator>
+    void merge(std::size_t memorysize, int parts, Writer &writer, Comparator cmp)
+    {
+        int fanIn = getFanIn(memorysize);
+        int first = 0;
+        while (parts > fanIn)
+        {
+            int groups = (parts + fanIn - 1) / fanIn;
+            int next = first + parts;
+            for (int i = 0; i < groups; ++i)
+            {
+                int size = parts / groups + (i < parts % groups ? 1 : 0);
+                BinaryWriter<DataType> bw = BinaryWriter<DataType>(std :: unique_ptr<std :: ofstream>(new std :: ofstream (getFileName(next + i).c_str(), std :: ios::out | std :: ios::binary)));
+                mergeParts(first, size, bw, cmp);
+                bw.close();
+                clean_up_files(first, size);
+                first += size;
+            }
+            parts = groups;
+        }
+        mergeParts(first, parts, writer, cmp);
+        clean_up_files(first, parts);
+    }
+
+    /**
+    * This function merges parts with numbers from first to first + parts - 1 into writer
+    */
     template <typename Writer, typename Comparator>
-    void merge(int parts, Writer &writer, Comparator cmp)
+    void mergeParts(int first, int parts, Writer &writer, Comparator cmp)
     {
         typedef std :: pair<DataType, BinaryReader<DataType>*> mpair;
         PairComparator<Comparator> pcmp(cmp);
@@ -120,7 +178,7 @@ private:
         int heapsize = parts;
         for (int i = 0; i < parts; ++i)
         {
-            heap[i].second = new BinaryReader<DataType>(std :: unique_ptr<std :: ifstream>(new std :: ifstream(getFileName(i).c_str(), std :: ios::in | std :: ios::binary)));
+            heap[i].second = new BinaryReader<DataType>(std :: unique_ptr<std :: ifstream>(new std :: ifstream(getFileName(first + i).c_str(), std :: ios::in | std :: ios::binary)));
             heap[i].second->read(heap[i].first);
         }
         std :: make_heap(heap.begin(), heap.begin() + heapsize, pcmp);
@@ -194,11 +252,12 @@ private:
     /**
     * This function removes temorary files
     * Arguments:
+    *       first - is a number of the first file
     *       files - is a number of temporary files
     */
-    void clean_up_files(int files)
+    void clean_up_files(int first, int files)
     {
-        for (int i = 0; i < files; ++i)
+        for (int i = first; i < first + files; ++i)
             remove(getFileName(i).c_str());
     }
 
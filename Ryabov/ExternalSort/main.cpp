@@ -147,6 +147,38 @@ TEST (IntegrateTest, Int_N_10000_MEM_100)
     remove("12345.out");
 }
 
+TEST (IntegrateTest, Int_N_20000_MEM_40_MultiPass)
+{
+    const int n = 20000;
+    vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = rand() - RAND_MAX / 2;
+    ofstream cout1("12345");
+    for (int i=  0; i < n; ++i)
+        cout1 << v[i] << " ";
+    cout1.close();
+    ExternalSorter<int> exs(0, 4);
+    Reader<int> reader(unique_ptr<ifstream>(new ifstream("12345")));
+    Writer<int> writer(unique_ptr<ofstream>(new ofstream("12345.out")));
+    exs.sort(40,
+        reader,
+        writer,
+        StandartSorter<less<int> >(),
+        less<int>());
+    sort(v.begin(), v.end());
+    ifstream cin1("12345.out");
+    for (int i = 0; i < n; ++i)
+    {
+        int x;
+        cin1 >> x;
+        EXPECT_EQ(x, v[i]);
+    }
+    ifstream temp(".temp_sort_file0.bin");
+    EXPECT_FALSE(temp.is_open());
+    remove("12345");
+    remove("12345.out");
+}
+
 TEST (IntegrateTest, Int_N_100000_MEM_1000)
 {
     const int n = 100000;
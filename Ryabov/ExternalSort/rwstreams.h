@@ -32,7 +32,7 @@ public:
     */
     bool read(T &value) const
     {
-        return ((*ifsp) >> value);
+        return static_cast<bool>((*ifsp) >> value);
     }
 
 
@@ -107,7 +107,7 @@ public:
     */
     bool read(T &value)
     {
-        return (ifsp->read(reinterpret_cast<char*>(&value), sizeof (T)));
+        return static_cast<bool>(ifsp->read(reinterpret_cast<char*>(&value), sizeof (T)));
     }
 
     /**
@@ -6,6 +6,14 @@ class Reader {
 public:
     virtual Reader<T> & operator >>(T & x) = 0;
     virtual bool eos() = 0;
+    //reads up to n elements, returns number of elements read
+    virtual int read(T * x, int n) {
+        for (int i = 0; i < n; i++) {
+            if (eos()) return i;
+            (*this) >> x[i];
+        }
+        return n;
+    }
     virtual ~Reader(){}
 };
 
@@ -13,6 +21,10 @@ template<class T>
 class Writer {
 public:
     virtual Writer<T> & operator <<(const T & x) = 0;
+    virtual void write(const T * x, int n) {
+        for (int i = 0; i < n; i++)
+            (*this) << x[i];
+    }
     virtual ~Writer(){}
 };
 
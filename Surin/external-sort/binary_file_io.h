@@ -3,6 +3,8 @@
 #include "abstract_io.h"
 #include <cstdio>
 #include <memory.h>
+#include <algorithm>
+#include <string>
 
 template<class T>
 class BFReader : public Reader<T> {
@@ -47,6 +49,19 @@ public:
         read(x);
         return *this;
     }
+    //copies whole pieces of the buffer instead of element by element
+    virtual int read(T * x, int n) {
+        int done = 0;
+        while (done < n) {
+            if (bl == bf && !feof(fd)) readbuffer();
+            if (bl == bf) break;
+            int k = std::min(bl - bf, n - done);
+            memcpy(x + done, buffer + bf, k * sizeof(T));
+            bf += k; done += k;
+            if (bl == bf && !feof(fd)) readbuffer();
+        }
+        return done;
+    }
     ~BFReader() {
         free(buffer);
         close();
@@ -73,11 +88,8 @@ private:
         bl = 0;
     }
     void write(const T & x) {
-        if (bl == BUF_SIZE/(sizeof(T))) {
-            flush();
-        } else {
-            memcpy(buffer + (bl++), &x, sizeof(T));
-        }
+        if (bl == BUF_SIZE/(sizeof(T))) flush();
+        memcpy(buffer + (bl++), &x, sizeof(T));
     }
 public:
     static const int DEFAULT_CACHE = 300000000;
@@ -101,6 +113,15 @@ public:
         write(x);
         return *this;
     }
+    virtual void write(const T * x, int n) {
+        int cap = BUF_SIZE/(sizeof(T));
+        while (n > 0) {
+            if (bl == cap) flush();
+            int k = std::min(cap - bl, n);
+            memcpy(buffer + bl, x, k * sizeof(T));
+            bl += k; x += k; n -= k;
+        }
+    }
     ~BFWriter() {
         close();
         free(buffer);
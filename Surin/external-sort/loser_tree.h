@@ -0,0 +1,69 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+#include <vector>
+#include <utility>
+
+//tournament tree for k-way merge: inner nodes keep only indices of losers,
+//replacing the winner's head costs one comparison per level
+template<class T, class cmp, bool stable=false>
+class LoserTree {
+private:
+    int ways;
+    std::vector<T> heads;
+    std::vector<bool> alive;
+    std::vector<int> tree;
+    cmp & CC;
+
+    int player(int pos, const std::vector<int> & winners) {
+        return pos >= ways ? pos - ways : winners[pos];
+    }
+    bool beats(int a, int b) {
+        if (!alive[a] || !alive[b]) return alive[a];
+        if (CC(heads[a], heads[b])) return true;
+        return stable && a < b && !CC(heads[b], heads[a]);
+    }
+    void replay(int cur) {
+        for (int node = (cur + ways) / 2; node > 0; node /= 2)
+            if (beats(tree[node], cur)) std::swap(tree[node], cur);
+        tree[0] = cur;
+    }
+public:
+    LoserTree(int n, cmp & _c): ways(n), heads(n), alive(n, false), tree(n > 0 ? n : 1), CC(_c) {}
+    T & head(int way) {
+        return heads[way];
+    }
+    void activate(int way) {
+        alive[way] = true;
+    }
+    void build() {
+        if (ways == 0) return;
+        std::vector<int> winners(ways);
+        for (int node = ways - 1; node > 0; node--) {
+            int a = player(2 * node, winners), b = player(2 * node + 1, winners);
+            if (beats(b, a)) std::swap(a, b);
+            winners[node] = a;
+            tree[node] = b;
+        }
+        tree[0] = ways > 1 ? winners[1] : 0;
+    }
+    bool empty() {
+        return ways == 0 || !alive[tree[0]];
+    }
+    int winner() {
+        return tree[0];
+    }
+    T & top() {
+        return heads[tree[0]];
+    }
+    //top() was replaced by the next element of the winner
+    void update() {
+        replay(tree[0]);
+    }
+    //winner has no more elements
+    void exhaust() {
+        alive[tree[0]] = false;
+        replay(tree[0]);
+    }
+};
+
+#endif
@@ -4,27 +4,21 @@
 #include "comparator.h"
 #include "istream_io.h"
 #include "binary_file_io.h"
+#include "loser_tree.h"
 #include <algorithm>
 #include <vector>
-#include <queue>
 #include <cstdio>
 #include <sstream>
 
 namespace sort_utils {
     template<class T>
     int readBlock(Reader<T> * ccin, T * buffer, int BUF_SIZE) {
-        for (int i = 0; i < (BUF_SIZE / sizeof(T)); i++) {
-            if (ccin->eos()) return i;
-            (*ccin) >> buffer[i];
-        }
-        return BUF_SIZE/sizeof(T);
+        return ccin->read(buffer, BUF_SIZE / sizeof(T));
     }
 
     template<class T>
     void writeBlock(Writer<T> * ccout, T * buffer, int sz) {
-        for (int i = 0; i < sz; i++) {
-            (*ccout) << buffer[i];
-        }
+        ccout->write(buffer, sz);
     }
 
     template<class T, class cmp=CLess<T> >
@@ -69,26 +63,20 @@ void bigSort(Reader<T> * ccin, Writer<T> * ccout, cmp * CC = new cmp(), int MAX_
     std::vector<BFReader<T> * > files;
     for (int i = 0; i < cfiles; i++)
          files.push_back(new BFReader<T>(sort_utils::tempFileName(i)));
-    //fix types
-    typedef std::pair<T, BFReader<T> * > TPair;
-    std::priority_queue< TPair, 
-                         std::vector<TPair>, 
-                         CPair<T, BFReader<T>*, CInvOp<T, cmp>, CEqual<BFReader<T>* > > > 
-                               q(CPair<T, BFReader<T>*, CInvOp<T, cmp>, CEqual<BFReader<T>* > >(*(new CInvOp<T, cmp>(*CC))));
+    LoserTree<T, cmp> q(files.size(), *CC);
     for (int i = 0; i < files.size(); i++) {
-        T * x = (T*)malloc(sizeof(T));
-        (*files[i]) >> *x;
-        q.push(std::make_pair(*x, files[i]));
-        delete x;
+        if (files[i]->eos()) continue;
+        (*files[i]) >> q.head(i);
+        q.activate(i);
     }
+    q.build();
     while (!q.empty()) {
-        TPair ss = q.top();
-        q.pop();
-        *ccout << ss.first;
-        if (!ss.second->eos()) {
-            (*ss.second) >> ss.first;
-            q.push(ss);
-        }
+        BFReader<T> * file = files[q.winner()];
+        *ccout << q.top();
+        if (!file->eos()) {
+            (*file) >> q.top();
+            q.update();
+        } else q.exhaust();
     }
     for (int i = 0; i < files.size(); i++) {
         remove(sort_utils::tempFileName(i).c_str());
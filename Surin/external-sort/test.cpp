@@ -2,6 +2,7 @@
 #include "sort.h"
 #include "binary_file_io.h"
 #include "istream_io.h"
+#include "loser_tree.h"
 #include <cstdio>
 #include <utility>
 #include <list>
@@ -70,6 +71,40 @@ TEST(Comparator, InvOp) {
     EXPECT_FALSE(CInvOp<int>()(1, 1));
 }
 
+TEST(LoserTree, stable_merge) {
+    srand(2014);
+    CLess<int> cc;
+    for (int n = 1; n < 40; n++) {
+        std::vector<std::vector<int> > runs(n);
+        std::vector<std::pair<int, int> > v;
+        for (int i = 0; i < n; i++) {
+            runs[i].resize(rand() % 50);
+            for (int j = 0; j < runs[i].size(); j++) runs[i][j] = rand() % 10;
+            std::sort(runs[i].begin(), runs[i].end());
+            for (int j = 0; j < runs[i].size(); j++) v.push_back(std::make_pair(runs[i][j], i));
+        }
+        std::sort(v.begin(), v.end());
+        LoserTree<int, CLess<int>, true> q(n, cc);
+        std::vector<int> pos(n, 0);
+        for (int i = 0; i < n; i++) {
+            if (runs[i].empty()) continue;
+            q.head(i) = runs[i][pos[i]++];
+            q.activate(i);
+        }
+        q.build();
+        for (int k = 0; k < v.size(); k++) {
+            ASSERT_FALSE(q.empty());
+            int i = q.winner();
+            EXPECT_EQ(v[k], std::make_pair(q.top(), i));
+            if (pos[i] < runs[i].size()) {
+                q.top() = runs[i][pos[i]++];
+                q.update();
+            } else q.exhaust();
+        }
+        EXPECT_TRUE(q.empty());
+    }
+}
+
 TEST(Binary_File_io, Open_Close) {
     BFReader<int> inp;
     for (int i = 0; i < 60; i++) {
@@ -114,6 +149,47 @@ TEST(Binary_File_io, pair_int_int) {
     remove("tempfile");
 }
 
+TEST(Binary_File_io, bulk) {
+    std::vector<int> v(100000);
+    for (int i = 0; i < v.size(); i++) v[i] = rand();
+    BFWriter<int> outp("tempfile", 1000 * sizeof(int));
+    outp.write(&v[0], 777);
+    outp << v[777];
+    outp.write(&v[778], v.size() - 778);
+    outp.close();
+    BFReader<int> inp("tempfile", 333 * sizeof(int));
+    std::vector<int> r(v.size() + 10);
+    EXPECT_EQ(inp.read(&r[0], 10), 10);
+    inp >> r[10];
+    EXPECT_EQ(inp.read(&r[11], r.size() - 11), v.size() - 11);
+    EXPECT_TRUE(inp.eos());
+    r.resize(v.size());
+    EXPECT_EQ(v, r);
+    remove("tempfile");
+}
+
+TEST(Binary_File_io, bulk_whole_buffer) {
+    std::vector<int> v(12);
+    for (int i = 0; i < v.size(); i++) v[i] = i + 1;
+    BFWriter<int> outp("tempfile");
+    outp.write(&v[0], v.size());
+    outp.close();
+    BFReader<int> inp("tempfile", 4 * sizeof(int));
+    std::vector<int> r(v.size());
+    EXPECT_EQ(inp.read(&r[0], 4), 4);
+    EXPECT_FALSE(inp.eos());
+    inp >> r[4];
+    EXPECT_EQ(inp.read(&r[5], 7), 7);
+    EXPECT_TRUE(inp.eos());
+    EXPECT_EQ(v, r);
+    int x = 0, n = 0;
+    while (!inp.eos() && n < 3) {
+        inp >> x; n++;
+    }
+    EXPECT_EQ(n, 0);
+    remove("tempfile");
+}
+
 TEST(Sorting, one_block) {
    DEBUG_RW<int> ii, io;
    srand(time(0));
@@ -0,0 +1,295 @@
+// Driver of the cross-implementation external sort benchmark.
+// Generates deterministic datasets, runs every runner on every dataset in a clean working directory
+// under the same memory budget, verifies the output and reports one row per run as CSV or JSON.
+// See README.md for the list of runners and their limitations.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+#include "dataset.h"
+
+namespace
+{
+
+const char *allSorters = "ivaschenko,alekseev,pershakov,ryabov,surin,podkin,kuzmichev,khismatullin";
+
+struct Options
+{
+    std::size_t records = 1000000;
+    std::size_t memory = 4 << 20;
+    std::uint64_t seed = 20140901;
+    unsigned timeout = 600;
+    bool json = false;
+    std::string dir = "/tmp/external-sort-bench";
+    std::string bin = "bin";
+    std::vector<std::string> sorters, datasets;
+};
+
+struct Row
+{
+    std::string sorter, dataset, format, status, message;
+    unsigned long long records, bytes, memory, peakRss, tempBytes, comparisons;
+    double seconds;
+    bool correct;
+};
+
+std::vector<std::string> split(const std::string &list)
+{
+    std::vector<std::string> result;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        if (!item.empty())
+            result.push_back(item);
+    return result;
+}
+
+bool contains(const std::vector<std::string> &list, const std::string &item)
+{
+    return std::find(list.begin(), list.end(), item) != list.end();
+}
+
+void usage(const char *name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --records N        records in every dataset (1000000)\n"
+                 "  --memory BYTES     memory budget given to every sorter (4194304)\n"
+                 "  --seed N           seed of dataset generators (20140901)\n"
+                 "  --timeout SECONDS  limit for one run (600)\n"
+                 "  --format csv|json  report format (csv)\n"
+                 "  --sorters LIST     comma separated runners (%s)\n"
+                 "  --datasets LIST    comma separated datasets (all)\n"
+                 "  --dir PATH         directory for datasets and runs (/tmp/external-sort-bench)\n"
+                 "  --bin PATH         directory with runners (bin)\n",
+                 name, allSorters);
+    std::exit(1);
+}
+
+Options parseOptions(int argc, char **argv)
+{
+    Options options;
+    options.sorters = split(allSorters);
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string key = argv[i];
+        if (i + 1 == argc)
+            usage(argv[0]);
+        std::string value = argv[++i];
+        if (key == "--records")
+            options.records = std::strtoull(value.c_str(), 0, 10);
+        else if (key == "--memory")
+            options.memory = std::strtoull(value.c_str(), 0, 10);
+        else if (key == "--seed")
+            options.seed = std::strtoull(value.c_str(), 0, 10);
+        else if (key == "--timeout")
+            options.timeout = std::strtoul(value.c_str(), 0, 10);
+        else if (key == "--format" && (value == "csv" || value == "json"))
+            options.json = value == "json";
+        else if (key == "--sorters")
+            options.sorters = split(value);
+        else if (key == "--datasets")
+            options.datasets = split(value);
+        else if (key == "--dir")
+            options.dir = value;
+        else if (key == "--bin")
+            options.bin = value;
+        else
+            usage(argv[0]);
+    }
+    return options;
+}
+
+std::string absolutePath(const std::string &path)
+{
+    char *resolved = realpath(path.c_str(), 0);
+    if (!resolved)
+    {
+        std::perror(path.c_str());
+        std::exit(1);
+    }
+    std::string result = resolved;
+    std::free(resolved);
+    return result;
+}
+
+// removes everything runner left in its working directory
+void cleanDirectory(const std::string &path)
+{
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return;
+    while (dirent *entry = readdir(dir))
+        if (std::strcmp(entry->d_name, ".") && std::strcmp(entry->d_name, ".."))
+            unlink((path + "/" + entry->d_name).c_str());
+    closedir(dir);
+}
+
+// runs runner in (workDir), fills measured fields of (row)
+void runSorter(const Options &options, const std::string &runner, const std::string &input,
+               const std::string &output, bool strings, bench::Format format, const std::string &workDir, Row &row)
+{
+    int channel[2];
+    if (pipe(channel))
+    {
+        std::perror("pipe");
+        std::exit(1);
+    }
+    std::string memory = std::to_string(options.memory);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        dup2(channel[1], STDOUT_FILENO);
+        dup2(channel[1], STDERR_FILENO);
+        close(channel[0]);
+        close(channel[1]);
+        if (chdir(workDir.c_str()))
+            _exit(127);
+        alarm(options.timeout);
+        execl(runner.c_str(), runner.c_str(), input.c_str(), output.c_str(), strings ? "string" : "int",
+              bench::formatName(format), memory.c_str(), (char *)0);
+        _exit(127);
+    }
+    close(channel[1]);
+    std::string report;
+    char buffer[256];
+    ssize_t size;
+    while ((size = read(channel[0], buffer, sizeof(buffer))) > 0)
+        report.append(buffer, size);
+    close(channel[0]);
+
+    int status;
+    rusage usage;
+    wait4(pid, &status, 0, &usage);
+    row.peakRss = usage.ru_maxrss;
+    row.message = report;
+
+    std::size_t line = report.rfind("seconds=");
+    if (WIFSIGNALED(status))
+        row.status = WTERMSIG(status) == SIGALRM ? "timeout" : "crashed";
+    else if (WEXITSTATUS(status) == 2)
+        row.status = "unsupported";
+    else if (WEXITSTATUS(status) != 0 || line == std::string::npos)
+        row.status = "failed";
+    else
+    {
+        row.status = "ok";
+        std::sscanf(report.c_str() + line, "seconds=%lf comparisons=%llu temp_bytes=%llu", &row.seconds,
+                    &row.comparisons, &row.tempBytes);
+    }
+}
+
+void printCsvHeader()
+{
+    std::printf("sorter,dataset,format,records,bytes,memory,status,seconds,records_per_second,mb_per_second,"
+                "peak_rss_kb,temp_bytes_written,comparisons,correct\n");
+}
+
+void printRow(const Row &row, bool json, bool first)
+{
+    // rates of failed runs are meaningless
+    double seconds = row.seconds > 0 ? row.seconds : 1e-9;
+    double recordsPerSecond = row.status == "ok" ? row.records / seconds : 0;
+    double mbPerSecond = row.status == "ok" ? row.bytes / 1e6 / seconds : 0;
+    char line[1024];
+    if (json)
+        std::snprintf(line, sizeof(line),
+                      "%s  {\"sorter\": \"%s\", \"dataset\": \"%s\", \"format\": \"%s\", \"records\": %llu, "
+                      "\"bytes\": %llu, \"memory\": %llu, \"status\": \"%s\", \"seconds\": %.6f, "
+                      "\"records_per_second\": %.0f, \"mb_per_second\": %.3f, \"peak_rss_kb\": %llu, "
+                      "\"temp_bytes_written\": %llu, \"comparisons\": %llu, \"correct\": %s}",
+                      first ? "" : ",\n", row.sorter.c_str(), row.dataset.c_str(), row.format.c_str(),
+                      row.records, row.bytes, row.memory, row.status.c_str(), row.seconds, recordsPerSecond,
+                      mbPerSecond, row.peakRss, row.tempBytes, row.comparisons, row.correct ? "true" : "false");
+    else
+        std::snprintf(line, sizeof(line), "%s,%s,%s,%llu,%llu,%llu,%s,%.6f,%.0f,%.3f,%llu,%llu,%llu,%d\n",
+                      row.sorter.c_str(), row.dataset.c_str(), row.format.c_str(),
+                      row.records, row.bytes, row.memory, row.status.c_str(), row.seconds, recordsPerSecond,
+                      mbPerSecond, row.peakRss, row.tempBytes, row.comparisons, int(row.correct));
+    std::fputs(line, stdout);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options = parseOptions(argc, argv);
+    mkdir(options.dir.c_str(), 0755);
+    std::string dir = absolutePath(options.dir), bin = absolutePath(options.bin);
+    std::string workDir = dir + "/run";
+    mkdir(workDir.c_str(), 0755);
+
+    if (options.json)
+        std::printf("[\n");
+    else
+        printCsvHeader();
+    bool first = true;
+
+    for (int d = 0; d < bench::DistributionsCount; ++d)
+    {
+        bench::Distribution distribution = bench::Distribution(d);
+        bool strings = bench::isStringDistribution(distribution);
+        if (!options.datasets.empty() && !contains(options.datasets, bench::distributionName(distribution)))
+            continue;
+        for (int f = 0; f < (strings ? 1 : 2); ++f)
+        {
+            bench::Format format = bench::Format(f);
+            std::string name = std::string(bench::distributionName(distribution)) + "-" + bench::formatName(format);
+            std::string input = dir + "/" + name + ".in", output = dir + "/" + name + ".out";
+            std::uint64_t bytes = bench::writeDataset(input, distribution, format, options.records, options.seed + d);
+            bench::Fingerprint expected = strings ? bench::fingerprint<std::string>(input, format)
+                                                  : bench::fingerprint<std::int32_t>(input, format);
+
+            for (std::size_t s = 0; s < options.sorters.size(); ++s)
+            {
+                Row row = Row();
+                row.sorter = options.sorters[s];
+                row.dataset = bench::distributionName(distribution);
+                row.format = bench::formatName(format);
+                row.records = options.records;
+                row.bytes = bytes;
+                row.memory = options.memory;
+
+                cleanDirectory(workDir);
+                unlink(output.c_str());
+                runSorter(options, bin + "/" + row.sorter, input, output, strings, format, workDir, row);
+                cleanDirectory(workDir);
+                if (row.status == "unsupported")
+                {
+                    std::fprintf(stderr, "%s: %s skipped, %s", row.sorter.c_str(), name.c_str(), row.message.c_str());
+                    continue;
+                }
+                if (row.status != "ok")
+                    std::fprintf(stderr, "%s: %s %s\n%s", row.sorter.c_str(), name.c_str(), row.status.c_str(),
+                                 row.message.c_str());
+
+                bench::Fingerprint actual = strings ? bench::fingerprint<std::string>(output, format)
+                                                    : bench::fingerprint<std::int32_t>(output, format);
+                row.correct = row.status == "ok" && actual.sorted && actual.records == expected.records
+                        && actual.sum == expected.sum;
+                unlink(output.c_str());
+                printRow(row, options.json, first);
+                first = false;
+            }
+            unlink(input.c_str());
+        }
+    }
+    if (options.json)
+        std::printf("\n]\n");
+    return 0;
+}
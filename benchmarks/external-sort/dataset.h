@@ -0,0 +1,193 @@
+#ifndef BENCHMARK_DATASET_H
+#define BENCHMARK_DATASET_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+#include <limits>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+
+// Deterministic datasets for the external sort benchmark.
+// Every dataset is fully defined by its distribution, number of records and seed,
+// so the same files are generated on every machine and every run.
+
+namespace bench
+{
+
+enum Distribution
+{
+    Uniform,    // uniform 32-bit integers
+    Sorted,     // ascending integers with gaps
+    Reverse,    // descending integers with gaps
+    FewUnique,  // 16 distinct values
+    Zipf,       // Zipf (s = 1.1) over 100000 ranks, ranks scattered over the key space
+    Strings,    // lowercase strings, 70% of 4-16 chars, 25% of 17-64, 5% of 65-256
+    DistributionsCount
+};
+
+enum Format
+{
+    Text,       // one record per line
+    Binary      // raw little-endian int32, integers only
+};
+
+inline const char *distributionName(Distribution distribution)
+{
+    static const char *names[DistributionsCount] = {"uniform", "sorted", "reverse", "few-unique", "zipf", "strings"};
+    return names[distribution];
+}
+
+inline const char *formatName(Format format)
+{
+    return format == Text ? "text" : "binary";
+}
+
+inline bool isStringDistribution(Distribution distribution)
+{
+    return distribution == Strings;
+}
+
+// generates records of an integer distribution
+inline std::vector<std::int32_t> generateIntegers(Distribution distribution, std::size_t records, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<std::int32_t> data(records);
+    switch (distribution)
+    {
+    case Uniform:
+        for (std::int32_t &x : data)
+            x = std::int32_t(std::uint32_t(generator()));
+        break;
+    case Sorted:
+    case Reverse:
+    {
+        std::int64_t current = std::numeric_limits<std::int32_t>::min();
+        std::int64_t step = std::max<std::int64_t>(1, (std::int64_t(1) << 32) / std::int64_t(records + 1));
+        for (std::int32_t &x : data)
+        {
+            current += 1 + std::int64_t(generator() % std::uint64_t(step));
+            x = std::int32_t(std::min<std::int64_t>(current, std::numeric_limits<std::int32_t>::max()));
+        }
+        if (distribution == Reverse)
+            std::reverse(data.begin(), data.end());
+        break;
+    }
+    case FewUnique:
+        for (std::int32_t &x : data)
+            x = std::int32_t(generator() % 16) * 1000003;
+        break;
+    case Zipf:
+    {
+        const std::size_t ranks = 100000;
+        std::vector<double> cumulative(ranks);
+        double sum = 0;
+        for (std::size_t rank = 0; rank < ranks; ++rank)
+            cumulative[rank] = sum += 1.0 / std::pow(double(rank + 1), 1.1);
+        std::uniform_real_distribution<double> uniform(0, sum);
+        for (std::int32_t &x : data)
+        {
+            std::size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(generator))
+                    - cumulative.begin();
+            // an odd multiplier permutes 32-bit values, so frequent keys are spread over the key space
+            x = std::int32_t(std::uint32_t(rank) * 2654435761u);
+        }
+        break;
+    }
+    default:
+        data.clear();
+    }
+    return data;
+}
+
+inline std::vector<std::string> generateStrings(std::size_t records, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<std::string> data(records);
+    for (std::string &s : data)
+    {
+        std::size_t kind = generator() % 100, length;
+        if (kind < 70)
+            length = 4 + generator() % 13;
+        else if (kind < 95)
+            length = 17 + generator() % 48;
+        else
+            length = 65 + generator() % 192;
+        s.resize(length);
+        for (char &c : s)
+            c = char('a' + generator() % 26);
+    }
+    return data;
+}
+
+// writes the dataset to a file, returns the number of bytes written
+inline std::uint64_t writeDataset(const std::string &fileName, Distribution distribution, Format format,
+                                  std::size_t records, std::uint64_t seed)
+{
+    std::ofstream out(fileName.c_str(), std::ios::binary);
+    if (isStringDistribution(distribution))
+    {
+        for (const std::string &s : generateStrings(records, seed))
+            out << s << '\n';
+    }
+    else
+    {
+        std::vector<std::int32_t> data = generateIntegers(distribution, records, seed);
+        if (format == Binary)
+            out.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(std::int32_t));
+        else
+            for (std::int32_t x : data)
+                out << x << '\n';
+    }
+    out.flush();
+    return out ? std::uint64_t(out.tellp()) : 0;
+}
+
+// order-independent fingerprint of a multiset of records
+inline std::uint64_t recordHash(std::int32_t x)
+{
+    std::uint64_t h = std::uint64_t(std::uint32_t(x)) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 29);
+}
+
+inline std::uint64_t recordHash(const std::string &s)
+{
+    std::uint64_t h = 1469598103934665603ull;
+    for (char c : s)
+        h = (h ^ std::uint8_t(c)) * 1099511628211ull;
+    return h ^ (h >> 29);
+}
+
+struct Fingerprint
+{
+    std::uint64_t records, sum;
+    bool sorted;
+
+    Fingerprint(): records(0), sum(0), sorted(true) {}
+};
+
+// reads a dataset or a sorted output and computes its fingerprint
+template<typename T>
+Fingerprint fingerprint(const std::string &fileName, Format format)
+{
+    Fingerprint result;
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    T previous = T(), current;
+    while (format == Binary
+           ? bool(in.read(reinterpret_cast<char *>(&current), sizeof(current)))
+           : bool(in >> current))
+    {
+        if (result.records && current < previous)
+            result.sorted = false;
+        result.sum += recordHash(current);
+        ++result.records;
+        previous = current;
+    }
+    return result;
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_DATASET_H
@@ -0,0 +1,187 @@
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <ctime>
+#include <cstdio>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+// Common part of benchmark runners.
+// Every runner is a separate executable wrapping one implementation (they can't be linked together,
+// most of them define global ExternalSorter, Reader and Writer), invoked by the driver as
+//     runner <input> <output> <int|string> <text|binary> <memoryBytes>
+// It sorts input into output and prints a single line
+//     seconds=<wall time> comparisons=<comparator calls> temp_bytes=<bytes written besides output>
+// Exit code 2 means that implementation doesn't support requested record type or format,
+// the reason is printed to stderr.
+// Kept C++98-compatible, some implementations don't compile as C++11.
+
+namespace bench
+{
+
+struct RunnerOptions
+{
+    std::string input, output;
+    bool strings, binary;
+    std::size_t memory;
+};
+
+inline RunnerOptions parseRunnerOptions(int argc, char **argv)
+{
+    if (argc != 6)
+    {
+        std::fprintf(stderr, "usage: %s <input> <output> <int|string> <text|binary> <memoryBytes>\n", argv[0]);
+        std::exit(1);
+    }
+    RunnerOptions options;
+    options.input = argv[1];
+    options.output = argv[2];
+    options.strings = std::string(argv[3]) == "string";
+    options.binary = std::string(argv[4]) == "binary";
+    options.memory = std::strtoul(argv[5], 0, 10);
+    return options;
+}
+
+// exits with "unsupported" code
+inline void unsupported(const char *reason)
+{
+    std::fprintf(stderr, "%s\n", reason);
+    std::exit(2);
+}
+
+// operator < counting its calls, shared by all copies
+template<typename T> struct CountingLess
+{
+    static unsigned long long calls;
+
+    bool operator() (const T &a, const T &b) const
+    {
+        ++calls;
+        return a < b;
+    }
+};
+
+template<typename T> unsigned long long CountingLess<T>::calls = 0;
+
+// std::sort with CountingLess for implementations calling sorter without comparator
+template<typename T> struct CountingSorter
+{
+    template<typename Iterator> void operator() (Iterator begin, Iterator end) const
+    {
+        std::sort(begin, end, CountingLess<T>());
+    }
+};
+
+// one record per line
+template<typename T> class TextReader
+{
+public:
+    explicit TextReader(const std::string &fileName): in(fileName.c_str()) {}
+
+    bool operator() (T &data)
+    {
+        return static_cast<bool>(in >> data);
+    }
+
+private:
+    std::ifstream in;
+};
+
+template<typename T> class TextWriter
+{
+public:
+    explicit TextWriter(const std::string &fileName): out(fileName.c_str()) {}
+
+    bool operator() (const T &data)
+    {
+        return static_cast<bool>(out << data << '\n');
+    }
+
+private:
+    std::ofstream out;
+};
+
+// raw records
+template<typename T> class BinaryReader
+{
+public:
+    explicit BinaryReader(const std::string &fileName): in(fileName.c_str(), std::ios::binary) {}
+
+    bool operator() (T &data)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&data), sizeof(T)));
+    }
+
+private:
+    std::ifstream in;
+};
+
+template<typename T> class BinaryWriter
+{
+public:
+    explicit BinaryWriter(const std::string &fileName): out(fileName.c_str(), std::ios::binary) {}
+
+    bool operator() (const T &data)
+    {
+        return static_cast<bool>(out.write(reinterpret_cast<const char *>(&data), sizeof(T)));
+    }
+
+private:
+    std::ofstream out;
+};
+
+// bytes written by this process so far (wchar of /proc/self/io), 0 if not available
+inline unsigned long long writtenBytes()
+{
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    unsigned long long value;
+    while (io >> key >> value)
+        if (key == "wchar:")
+            return value;
+    return 0;
+}
+
+inline unsigned long long fileSize(const std::string &fileName)
+{
+    struct stat info;
+    return stat(fileName.c_str(), &info) ? 0 : info.st_size;
+}
+
+inline double now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// measures one sort, must be started before the implementation opens any file
+class Measurement
+{
+public:
+    explicit Measurement(const RunnerOptions &options):
+        output(options.output), written(writtenBytes()), started(now())
+    {}
+
+    // output must be closed and flushed here
+    void report(unsigned long long comparisons) const
+    {
+        double seconds = now() - started;
+        unsigned long long total = writtenBytes() - written, result = fileSize(output);
+        std::printf("seconds=%.6f comparisons=%llu temp_bytes=%llu\n",
+                    seconds, comparisons, total > result ? total - result : 0ull);
+    }
+
+private:
+    std::string output;
+    unsigned long long written;
+    double started;
+};
+
+} // namespace bench
+
+#endif // BENCHMARK_RUNNER_H
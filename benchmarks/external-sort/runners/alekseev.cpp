@@ -0,0 +1,29 @@
+#include "externalsort.h"
+
+#include "../runner.h"
+
+using namespace bench;
+
+template<typename T, typename Reader, typename Writer> int run(const RunnerOptions &options)
+{
+    Measurement measurement(options);
+    {
+        Reader reader(options.input);
+        Writer writer(options.output);
+        ExternalSorter<T, CountingLess<T> > sorter;
+        if (!sorter.sort(reader, writer, std::max<std::size_t>(1, options.memory / sizeof(T))))
+            return 1;
+    }
+    measurement.report(CountingLess<T>::calls);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    RunnerOptions options = parseRunnerOptions(argc, argv);
+    if (options.strings)
+        return run<std::string, TextReader<std::string>, TextWriter<std::string> >(options);
+    if (options.binary)
+        return run<int, BinaryReader<int>, BinaryWriter<int> >(options);
+    return run<int, TextReader<int>, TextWriter<int> >(options);
+}
@@ -0,0 +1,19 @@
+#include "filesort.h"
+
+#include "../runner.h"
+
+// Khismatullin's temporary files are raw records and input is read as text,
+// so only integers in text are supported
+int main(int argc, char **argv)
+{
+    bench::RunnerOptions options = bench::parseRunnerOptions(argc, argv);
+    if (options.strings)
+        bench::unsupported("temporary files hold raw records");
+    if (options.binary)
+        bench::unsupported("only text input is read");
+    typedef bench::CountingLess<int> Less;
+    bench::Measurement measurement(options);
+    filesort<int, Less>(options.input.c_str(), options.output.c_str(), options.memory);
+    measurement.report(Less::calls);
+    return 0;
+}
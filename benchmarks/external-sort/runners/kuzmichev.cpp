@@ -0,0 +1,37 @@
+#include <cstdio>
+#include <algorithm>
+
+#include "ExternalSort.h"
+#include "Reader.h"
+#include "Writer.h"
+
+#include "../runner.h"
+
+// Kuzmichev's sorter reads fixed parts of 10000 records whatever the memory budget is
+// and keeps temporary files in text, the same Reader and Writer are used for input and output
+template<typename T> int run(const bench::RunnerOptions &options)
+{
+    typedef bench::CountingLess<T> Less;
+    bench::Measurement measurement(options);
+    {
+        std::vector<char> output(options.output.begin(), options.output.end());
+        output.push_back(0);
+        ::Reader reader(options.input.c_str());
+        ::Writer writer(&output[0]);
+        Less less;
+        ExternalSorter<T, ::Reader, ::Writer, Less> sorter(reader, writer, less);
+        sorter.externalSort();
+    }
+    measurement.report(Less::calls);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench::RunnerOptions options = bench::parseRunnerOptions(argc, argv);
+    if (options.binary)
+        bench::unsupported("only text input is read");
+    if (options.strings)
+        return run<std::string>(options);
+    return run<int>(options);
+}
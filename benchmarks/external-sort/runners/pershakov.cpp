@@ -0,0 +1,33 @@
+#include "io/text_file_reader.h"
+#include "io/text_file_writer.h"
+#include "io/binary_file_reader.h"
+#include "io/binary_file_writer.h"
+#include "sort/sorter.h"
+#include "sort/external_sorter.h"
+
+#include "../runner.h"
+
+using namespace bench;
+
+// the same Reader and Writer are used for input, output and temporary files
+template<typename T, typename Reader, typename Writer> int run(const RunnerOptions &options)
+{
+    Measurement measurement(options);
+    {
+        ExternalSorter<T, Reader, Writer, Sorter<T, CountingLess<T> >, CountingLess<T> > sorter(options.input);
+        sorter.setResultFile(options.output);
+        sorter.sort(std::max<std::size_t>(1, options.memory / sizeof(T)));
+    }
+    measurement.report(CountingLess<T>::calls);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    RunnerOptions options = parseRunnerOptions(argc, argv);
+    if (options.strings)
+        return run<std::string, TextFileReader<std::string>, TextFileWriter<std::string> >(options);
+    if (options.binary)
+        return run<int, BinaryFileReader<int>, BinaryFileWriter<int> >(options);
+    return run<int, TextFileReader<int>, TextFileWriter<int> >(options);
+}
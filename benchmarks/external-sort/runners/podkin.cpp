@@ -0,0 +1,29 @@
+#include "ExternalSorter.h"
+#include "StandartSorter.h"
+
+#include "../runner.h"
+
+// Podkin's sorter reads blocks through an int, so only integers are supported
+template<typename Reader, typename Writer> int run(const bench::RunnerOptions &options)
+{
+    typedef bench::CountingLess<int> Less;
+    bench::Measurement measurement(options);
+    {
+        Reader in(options.input);
+        Writer out(options.output);
+        ExternalSorter<int> sorter;
+        sorter(std::max<int>(1, int(options.memory / sizeof(int))), in, out, StandartSorter<int>(), Less());
+    }
+    measurement.report(Less::calls);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench::RunnerOptions options = bench::parseRunnerOptions(argc, argv);
+    if (options.strings)
+        bench::unsupported("blocks are read through an int");
+    if (options.binary)
+        return run<BinaryReader<int>, BinaryWriter<int> >(options);
+    return run<FileReader<int>, FileWriter<int> >(options);
+}
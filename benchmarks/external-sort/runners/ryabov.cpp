@@ -0,0 +1,29 @@
+#include "externalsort.h"
+#include "sorter.h"
+
+#include "../runner.h"
+
+// Ryabov's temporary files are raw records, so only integers are supported
+template<typename Reader, typename Writer> int run(const bench::RunnerOptions &options, std::ios::openmode mode = std::ios::openmode())
+{
+    typedef bench::CountingLess<int> Less;
+    bench::Measurement measurement(options);
+    {
+        Reader reader(std::unique_ptr<std::ifstream>(new std::ifstream(options.input.c_str(), std::ios::in | mode)));
+        Writer writer(std::unique_ptr<std::ofstream>(new std::ofstream(options.output.c_str(), std::ios::out | mode)));
+        ExternalSorter<int> sorter;
+        sorter.sort(options.memory, reader, writer, StandartSorter<Less>(), Less());
+    }
+    measurement.report(Less::calls);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench::RunnerOptions options = bench::parseRunnerOptions(argc, argv);
+    if (options.strings)
+        bench::unsupported("temporary files hold raw records");
+    if (options.binary)
+        return run<BinaryReader<int>, BinaryWriter<int> >(options, std::ios::binary);
+    return run<Reader<int>, Writer<int> >(options);
+}
@@ -0,0 +1,78 @@
+#include <memory>
+
+#include "sort.h"
+
+#include "../runner.h"
+
+// Surin's comparators must derive from Comp
+class CountingLess: public CLess<int>
+{
+public:
+    virtual bool operator()(const int &a, const int &b)
+    {
+        return less(a, b);
+    }
+
+private:
+    bench::CountingLess<int> less;
+};
+
+// ISReader reports end of stream only after a failed read, so input is read by this one
+class TextReader: public Reader<int>
+{
+public:
+    explicit TextReader(const std::string &fileName): in(fileName.c_str()) {}
+
+    virtual Reader<int> & operator >>(int &x)
+    {
+        in >> x;
+        return *this;
+    }
+
+    virtual bool eos()
+    {
+        return (in >> std::ws).eof();
+    }
+
+private:
+    std::ifstream in;
+};
+
+// Surin's temporary files are raw records, so only integers are supported
+template<typename In> int run(const bench::RunnerOptions &options, In &in)
+{
+    std::ofstream stream;
+    std::unique_ptr< Writer<int> > out;
+    if (options.binary)
+        out.reset(new BFWriter<int>(options.output));
+    else
+    {
+        stream.open(options.output.c_str());
+        out.reset(new OSWriter<int>(&stream, "\n"));
+    }
+    CountingLess less;
+    bigSort<int, CountingLess>(&in, out.get(), &less, int(options.memory));
+    out.reset();
+    stream.close();
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench::RunnerOptions options = bench::parseRunnerOptions(argc, argv);
+    if (options.strings)
+        bench::unsupported("temporary files hold raw records");
+    bench::Measurement measurement(options);
+    if (options.binary)
+    {
+        BFReader<int> in(options.input);
+        run(options, in);
+    }
+    else
+    {
+        TextReader in(options.input);
+        run(options, in);
+    }
+    measurement.report(bench::CountingLess<int>::calls);
+    return 0;
+}